@@ -0,0 +1,193 @@
+//-----------------------------------------------------------------------------
+//
+//	ValueStoreBench.cpp
+//
+//	Compares ValueStore::GetValue with a lookup in the map<uint32,Value*>
+//	that ValueStore used to be built on.
+//
+//	Every node gets the same 60 values, with keys shaped like those of a
+//	typical device.  The nodes are filled in turn, one value at a time, so
+//	the map nodes of each store are spread through the heap as they are
+//	when nodes are interviewed together.  The same random sequence of node
+//	and key is then looked up in both containers.
+//
+//	Usage: ValueStoreBench [lookups]
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <map>
+#include <vector>
+#include "Defs.h"
+#include "Options.h"
+#include "Manager.h"
+#include "value_classes/ValueStore.h"
+#include "value_classes/ValueByte.h"
+
+using namespace OpenZWave;
+
+#ifndef CONFIG_PATH
+#define CONFIG_PATH "../../../config/"
+#endif
+
+static uint32 const c_homeId = 0x01234567;		// Not a real driver, so the values are not indexed or notified
+static uint8 const c_commandClasses[] = { 0x20, 0x25, 0x26, 0x27, 0x30, 0x31, 0x32, 0x59, 0x5a, 0x5e, 0x70, 0x71, 0x72, 0x73, 0x7a, 0x84, 0x85, 0x86, 0x8e, 0x98 };
+static uint32 const c_indicesPerClass = 3;
+static uint32 const c_valuesPerNode = sizeof(c_commandClasses) * c_indicesPerClass;
+static uint32 const c_nodeCounts[] = { 1, 100, 230 };
+
+//-----------------------------------------------------------------------------
+// <Now>
+// Seconds from the monotonic clock
+//-----------------------------------------------------------------------------
+static double Now
+(
+)
+{
+	struct timespec now;
+	clock_gettime( CLOCK_MONOTONIC, &now );
+	return now.tv_sec + ( now.tv_nsec / 1e9 );
+}
+
+//-----------------------------------------------------------------------------
+// <Key>
+// The value store key, laid out as ValueID::GetValueStoreKey does it
+//-----------------------------------------------------------------------------
+static uint32 Key
+(
+	uint8 _commandClassId,
+	uint8 _instance,
+	uint8 _index
+)
+{
+	return ( ((uint32)_instance) << 24 ) | ( ((uint32)_commandClassId) << 14 ) | ( ((uint32)_index) << 4 );
+}
+
+//-----------------------------------------------------------------------------
+// <Run>
+// Time random lookups over _numNodes nodes
+//-----------------------------------------------------------------------------
+static void Run
+(
+	uint32 _numNodes,
+	uint32 _lookups
+)
+{
+	vector<ValueStore*> stores;
+	vector< map<uint32,Value*>* > maps;
+	vector<Value*> values;
+	for( uint32 node=0; node<_numNodes; ++node )
+	{
+		stores.push_back( new ValueStore() );
+		maps.push_back( new map<uint32,Value*>() );
+	}
+
+	vector<uint32> keys;
+	for( uint32 i=0; i<c_valuesPerNode; ++i )
+	{
+		uint8 commandClassId = c_commandClasses[i/c_indicesPerClass];
+		uint8 index = (uint8)( i % c_indicesPerClass );
+		for( uint32 node=0; node<_numNodes; ++node )
+		{
+			Value* value = new ValueByte( c_homeId, (uint8)( node + 1 ), ValueID::ValueGenre_User, commandClassId, 1, index, "Bench", "", false, false, 0, 0 );
+			stores[node]->AddValue( value );
+			(*maps[node])[Key( commandClassId, 1, index )] = value;
+			values.push_back( value );
+		}
+		keys.push_back( Key( commandClassId, 1, index ) );
+	}
+
+	// The same pseudo-random sequence of lookups for both containers
+	vector< pair<uint32,uint32> > sequence;
+	uint32 seed = 12345;
+	for( uint32 i=0; i<_lookups; ++i )
+	{
+		seed = seed * 1103515245 + 12345;
+		uint32 node = ( seed >> 8 ) % _numNodes;
+		seed = seed * 1103515245 + 12345;
+		sequence.push_back( pair<uint32,uint32>( node, keys[( seed >> 8 ) % keys.size()] ) );
+	}
+
+	uint32 misses = 0;
+	double start = Now();
+	for( uint32 i=0; i<_lookups; ++i )
+	{
+		map<uint32,Value*> const& nodeValues = *maps[sequence[i].first];
+		if( nodeValues.find( sequence[i].second ) == nodeValues.end() )
+		{
+			++misses;
+		}
+	}
+	double mapTime = ( Now() - start ) / _lookups * 1e9;
+
+	start = Now();
+	for( uint32 i=0; i<_lookups; ++i )
+	{
+		if( !stores[sequence[i].first]->GetValue( sequence[i].second ) )
+		{
+			++misses;
+		}
+	}
+	double storeTime = ( Now() - start ) / _lookups * 1e9;
+
+	printf( "%5d nodes   map: %5.0f ns   ValueStore: %5.0f ns per lookup\n", _numNodes, mapTime, storeTime );
+	if( misses )
+	{
+		printf( "%d lookups did not find their value\n", misses );
+		exit( 1 );
+	}
+
+	for( uint32 node=0; node<_numNodes; ++node )
+	{
+		delete stores[node];
+		delete maps[node];
+	}
+	for( vector<Value*>::iterator it = values.begin(); it != values.end(); ++it )
+	{
+		(*it)->Release();
+	}
+}
+
+int main( int argc, char* argv[] )
+{
+	uint32 lookups = 2000000;
+	if( argc > 1 )
+	{
+		lookups = (uint32)atoi( argv[1] );
+	}
+
+	// AddValue looks the home id up in the Manager, so one has to exist.  There is
+	// no driver for the home id, so turn the logging off to hide the failed lookups.
+	Options::Create( CONFIG_PATH, "", "--Logging false --ConsoleOutput false" );
+	Options::Get()->Lock();
+	Manager::Create();
+
+	printf( "%d lookups of %d values per node\n", lookups, c_valuesPerNode );
+	for( uint32 i=0; i<sizeof(c_nodeCounts)/sizeof(c_nodeCounts[0]); ++i )
+	{
+		Run( c_nodeCounts[i], lookups );
+	}
+
+	Manager::Destroy();
+	Options::Destroy();
+	return 0;
+}
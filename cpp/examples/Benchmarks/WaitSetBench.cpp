@@ -0,0 +1,188 @@
+//-----------------------------------------------------------------------------
+//
+//	WaitSetBench.cpp
+//
+//	Compares the cost of one pass round the driver thread wait using
+//	Wait::Multiple and a WaitSet.
+//
+//	Both are timed over 11 Events, the number of objects DriverThreadProc
+//	waits on.  Each implementation is measured twice: with an object already
+//	signalled (the cost of the loop while work is waiting), and woken by
+//	another thread (as the serial read thread does for each frame).  Any
+//	result other than the expected index is reported and ends the run.
+//
+//	Usage: WaitSetBench [iterations]
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <time.h>
+#include "Defs.h"
+#include "platform/Event.h"
+#include "platform/Wait.h"
+#include "platform/WaitSet.h"
+
+using namespace OpenZWave;
+
+static uint32 const c_numObjects = 11;
+static uint32 const c_readyObject = 8;		// Ordinary requests to be sent
+static uint32 const c_wokenObject = 2;		// Controller has received data
+static int32 const c_timeout = 5000;
+
+static Event*	g_events[c_numObjects];
+static Wait*	g_objects[c_numObjects];
+static Event*	g_ack = NULL;
+static WaitSet*	g_waitSet = NULL;
+static int		g_iterations = 200000;
+
+//-----------------------------------------------------------------------------
+// <Now>
+// Seconds from the monotonic clock
+//-----------------------------------------------------------------------------
+static double Now
+(
+)
+{
+	struct timespec now;
+	clock_gettime( CLOCK_MONOTONIC, &now );
+	return now.tv_sec + ( now.tv_nsec / 1e9 );
+}
+
+//-----------------------------------------------------------------------------
+// <WaitOnce>
+// One wait on all of the objects, using either implementation
+//-----------------------------------------------------------------------------
+static int32 WaitOnce
+(
+	bool _useSet
+)
+{
+	if( _useSet )
+	{
+		return g_waitSet->Multiple( c_numObjects, c_timeout );
+	}
+	return Wait::Multiple( g_objects, c_numObjects, c_timeout );
+}
+
+//-----------------------------------------------------------------------------
+// <Check>
+// Report an unexpected result with enough detail to tell a timeout from a
+// spurious return, and stop
+//-----------------------------------------------------------------------------
+static void Check
+(
+	int32 _result,
+	uint32 _expected,
+	char const* _name,
+	char const* _phase,
+	int _iteration,
+	double _start
+)
+{
+	if( _result != (int32)_expected )
+	{
+		printf( "%s %s: iteration %d returned %d, expected %d, after %.1f ms\n", _name, _phase, _iteration, _result, _expected, ( Now() - _start ) * 1e3 );
+		fflush( stdout );
+		exit( 1 );
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <Producer>
+// Signal the woken object, then wait for the main thread to acknowledge it
+//-----------------------------------------------------------------------------
+static void* Producer
+(
+	void* _context
+)
+{
+	for( int i=0; i<g_iterations; ++i )
+	{
+		g_events[c_wokenObject]->Set();
+		if( Wait::Single( g_ack ) != 0 )
+		{
+			printf( "Producer: acknowledgement wait %d returned without the event being set\n", i );
+			fflush( stdout );
+			exit( 1 );
+		}
+		g_ack->Reset();
+	}
+	return NULL;
+}
+
+int main( int argc, char* argv[] )
+{
+	if( argc > 1 )
+	{
+		g_iterations = atoi( argv[1] );
+	}
+
+	for( uint32 i=0; i<c_numObjects; ++i )
+	{
+		g_events[i] = new Event();
+		g_objects[i] = g_events[i];
+	}
+	g_ack = new Event();
+	g_waitSet = new WaitSet( g_objects, c_numObjects );
+
+	printf( "%d iterations over %d objects\n", g_iterations, c_numObjects );
+	for( int pass=0; pass<2; ++pass )
+	{
+		bool useSet = ( pass == 1 );
+		char const* name = useSet ? "WaitSet::Multiple" : "Wait::Multiple   ";
+
+		// Already signalled
+		g_events[c_readyObject]->Set();
+		double start = Now();
+		for( int i=0; i<g_iterations; ++i )
+		{
+			double waitStart = Now();
+			Check( WaitOnce( useSet ), c_readyObject, name, "signalled", i, waitStart );
+		}
+		double ready = ( Now() - start ) / g_iterations * 1e9;
+		g_events[c_readyObject]->Reset();
+
+		// Woken by another thread
+		pthread_t thread;
+		pthread_create( &thread, NULL, Producer, NULL );
+		start = Now();
+		for( int i=0; i<g_iterations; ++i )
+		{
+			double waitStart = Now();
+			Check( WaitOnce( useSet ), c_wokenObject, name, "woken", i, waitStart );
+			g_events[c_wokenObject]->Reset();
+			g_ack->Set();
+		}
+		double woken = ( Now() - start ) / g_iterations * 1e9;
+		pthread_join( thread, NULL );
+
+		printf( "%s  signalled: %6.0f ns per wait   woken by another thread: %6.0f ns per round trip\n", name, ready, woken );
+	}
+
+	delete g_waitSet;
+	for( uint32 i=0; i<c_numObjects; ++i )
+	{
+		g_events[i]->Release();
+	}
+	g_ack->Release();
+	return 0;
+}
@@ -303,6 +303,10 @@ int main( int argc, char* argv[] )
 	{
 		Manager::Get()->AddDriver( "HID Controller", Driver::ControllerInterface_Hid );
 	}
+	else if( strcasecmp( port.c_str(), "sim" ) == 0 )
+	{
+		Manager::Get()->AddDriver( "Simulated Controller", Driver::ControllerInterface_Simulated );
+	}
 	else
 	{
 		Manager::Get()->AddDriver( port );
@@ -385,6 +389,10 @@ int main( int argc, char* argv[] )
 	{
 		Manager::Get()->RemoveDriver( "HID Controller" );
 	}
+	else if( strcasecmp( port.c_str(), "sim" ) == 0 )
+	{
+		Manager::Get()->RemoveDriver( "Simulated Controller" );
+	}
 	else
 	{
 		Manager::Get()->RemoveDriver( port );
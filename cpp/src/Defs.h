@@ -212,6 +212,8 @@ namespace OpenZWave
 #define MAX_MAX_TRIES		7	// Don't exceed this retry limit
 #define ACK_TIMEOUT	1000		// How long to wait for an ACK
 #define BYTE_TIMEOUT	150
+#define FRAME_LENGTH_TIMEOUT	50		// How long a partial frame may wait for its length byte after the SOF
+#define FRAME_BODY_TIMEOUT	500		// How long a partial frame may wait for the rest of its data after the length byte
 //#define RETRY_TIMEOUT	40000		// Retry send after 40 seconds
 #define RETRY_TIMEOUT	10000		// Retry send after 10 seconds (we might need to keep this below 10 for Security CC to function correctly)
 
@@ -252,6 +254,7 @@ namespace OpenZWave
 
 #define FUNC_ID_ZW_SEND_NODE_INFORMATION				0x12
 #define FUNC_ID_ZW_SEND_DATA							0x13
+#define FUNC_ID_ZW_SEND_DATA_MULTI						0x14
 #define FUNC_ID_ZW_GET_VERSION							0x15
 #define FUNC_ID_ZW_R_F_POWER_LEVEL_SET					0x17
 #define FUNC_ID_ZW_GET_RANDOM							0x1c
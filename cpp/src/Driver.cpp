@@ -37,12 +37,15 @@
 #include "platform/Event.h"
 #include "platform/Mutex.h"
 #include "platform/SerialController.h"
+#include "platform/SimulatedController.h"
+#include "platform/ReplayController.h"
 #ifdef WINRT
 #include "platform/winRT/HidControllerWinRT.h"
 #else
 #include "platform/HidController.h"
 #endif
 #include "platform/Thread.h"
+#include "platform/WaitSet.h"
 #include "platform/Log.h"
 #include "platform/TimeStamp.h"
 
@@ -51,6 +54,7 @@
 #include "command_classes/ControllerReplication.h"
 #include "command_classes/Security.h"
 #include "command_classes/WakeUp.h"
+#include "command_classes/MultiCmd.h"
 #include "command_classes/SwitchAll.h"
 #include "command_classes/ManufacturerSpecific.h"
 #include "command_classes/NoOperation.h"
@@ -58,6 +62,8 @@
 #include "value_classes/ValueID.h"
 #include "value_classes/Value.h"
 #include "value_classes/ValueStore.h"
+#include "value_classes/ValueBool.h"
+#include "value_classes/ValueByte.h"
 
 #include "tinyxml.h"
 
@@ -84,6 +90,14 @@ using namespace OpenZWave;
 //
 uint32 const c_configVersion = 3;
 
+// Largest MultiCmd encapsulated command built when batching requests, which
+// keeps the frame within the Z-Wave payload limit
+uint32 const c_maxBatchLength = 46;
+
+// With adaptive polling, the most times the poll interval of an unchanging value
+// is doubled, unless the value has its own maximum interval
+uint8 const c_maxPollBackoff = 6;
+
 static char const* c_libraryTypeNames[] =
 {
 		"Unknown",			// library type 0
@@ -169,15 +183,27 @@ m_expectedCallbackId( 0 ),
 m_expectedReply( 0 ),
 m_expectedCommandClassId( 0 ),
 m_expectedNodeId( 0 ),
+m_readState( ReadState_Idle ),
 m_pollThread( new Thread( "poll" ) ),
 m_pollMutex( new Mutex() ),
+m_pollEvent( new Event() ),
+m_queueDrainedEvent( new Event() ),
+m_pollGeneration( 0 ),
 m_pollInterval( 0 ),
 m_bIntervalBetweenPolls( false ),				// if set to true (via SetPollInterval), the pollInterval will be interspersed between each poll (so a much smaller m_pollInterval like 100, 500, or 1,000 may be appropriate)
+m_bAdaptivePolling( false ),
+m_bSuppressRefreshedPolls( false ),
 m_currentControllerCommand( NULL ),
 m_SUCNodeId( 0 ),
 m_controllerResetEvent( NULL ),
+m_bFairScheduling( false ),
+m_bBatchRequests( true ),
 m_sendMutex( new Mutex() ),
 m_currentMsg( NULL ),
+m_currentMsgQueued( false ),
+m_bCoalesceRequests( false ),
+m_bAdaptiveRetryTimeout( false ),
+m_retryTimeoutMin( 2000 ),
 m_virtualNeighborsReceived( false ),
 m_notificationsEvent( new Event() ),
 m_SOFCnt( 0 ),
@@ -201,6 +227,7 @@ m_nondelivery( 0 ),
 m_routedbusy( 0 ),
 m_broadcastReadCnt( 0 ),
 m_broadcastWriteCnt( 0 ),
+m_coalesced( 0 ),
 AuthKey( 0 ),
 EncryptKey( 0 ),
 m_nonceReportSent( 0 ),
@@ -218,6 +245,14 @@ m_nonceReportSentAttempt( 0 )
 	// Clear the nodes array
 	memset( m_nodes, 0, sizeof(Node*) * 256 );
 
+	// Every node starts with an equal share of the send queues
+	memset( m_queueCredit, 0, sizeof(m_queueCredit) );
+	memset( m_nodeSendWeight, 1, sizeof(m_nodeSendWeight) );
+	memset( m_nodeBatchRequests, 1, sizeof(m_nodeBatchRequests) );
+
+	// Clear the frame decoder buffer
+	memset( m_readBuffer, 0, sizeof(m_readBuffer) );
+
 	// Clear the virtual neighbors array
 	memset( m_virtualNeighbors, 0, NUM_NODE_BITFIELD_BYTES );
 
@@ -229,15 +264,39 @@ m_nonceReportSentAttempt( 0 )
 	{
 		m_controller = new HidController();
 	}
+	else if( ControllerInterface_Simulated == _interface )
+	{
+		m_controller = new SimulatedController();
+	}
+	else if( ControllerInterface_Replay == _interface )
+	{
+		m_controller = new ReplayController();
+	}
 	else
 	{
 		m_controller = new SerialController();
 	}
+
+	string captureFile;
+	Options::Get()->GetOptionAsString( "CaptureFile", &captureFile );
+	if( !captureFile.empty() )
+	{
+		string userPath;
+		Options::Get()->GetOptionAsString( "UserPath", &userPath );
+		m_controller->StartCapture( userPath + captureFile );
+	}
 	m_controller->SetSignalThreshold( 1 );
 
 	Options::Get()->GetOptionAsBool( "NotifyTransactions", &m_notifytransactions );
 	Options::Get()->GetOptionAsInt( "PollInterval", &m_pollInterval );
 	Options::Get()->GetOptionAsBool( "IntervalBetweenPolls", &m_bIntervalBetweenPolls );
+	Options::Get()->GetOptionAsBool( "AdaptivePolling", &m_bAdaptivePolling );
+	Options::Get()->GetOptionAsBool( "SuppressRefreshedPolls", &m_bSuppressRefreshedPolls );
+	Options::Get()->GetOptionAsBool( "CoalesceRequests", &m_bCoalesceRequests );
+	Options::Get()->GetOptionAsBool( "FairScheduling", &m_bFairScheduling );
+	Options::Get()->GetOptionAsBool( "BatchRequests", &m_bBatchRequests );
+	Options::Get()->GetOptionAsBool( "AdaptiveRetryTimeout", &m_bAdaptiveRetryTimeout );
+	Options::Get()->GetOptionAsInt( "RetryTimeoutMin", &m_retryTimeoutMin );
 }
 
 //-----------------------------------------------------------------------------
@@ -312,6 +371,8 @@ Driver::~Driver
 	}
 	// Don't release until all nodes have removed their poll values
 	m_pollMutex->Release();
+	m_pollEvent->Release();
+	m_queueDrainedEvent->Release();
 
 	// Clear the send Queue
 	for( int32 i=0; i<MsgQueue_Count; ++i )
@@ -415,6 +476,9 @@ void Driver::DriverThreadProc
 			waitObjects[9] = m_queueEvent[MsgQueue_Query];		// Node queries are pending.
 			waitObjects[10] = m_queueEvent[MsgQueue_Poll];		// Poll request is waiting.
 
+			// Register with the objects once, rather than on every pass through the loop
+			WaitSet waitSet( waitObjects, 11 );
+
 			TimeStamp retryTimeStamp;
 			int retryTimeout = RETRY_TIMEOUT;
 			Options::Get()->GetOptionAsInt( "RetryTimeout", &retryTimeout );
@@ -445,13 +509,44 @@ void Driver::DriverThreadProc
 					Log::QueueClear();							// clear the log queue when starting a new message
 				}
 
+				// Wake the poll thread if it is waiting for the library to go quiet.  This
+				// is checked on every pass, as a controller command can run for a long time.
+				if( IsSendQueueIdle() )
+				{
+					m_queueDrainedEvent->Set();
+				}
+
+				// If part of a frame has been received, don't wait longer
+				// than the time allowed for the rest of it to arrive.
+				bool frameTimeout = false;
+				if( m_readState != ReadState_Idle )
+				{
+					int32 frameRemaining = m_readTimeStamp.TimeRemaining();
+					if( frameRemaining < 0 )
+					{
+						frameRemaining = 0;
+					}
+					if( timeout == Wait::Timeout_Infinite || frameRemaining <= timeout )
+					{
+						timeout = frameRemaining;
+						frameTimeout = true;
+					}
+				}
+
 				// Wait for something to do
-				int32 res = Wait::Multiple( waitObjects, count, timeout );
+				int32 res = waitSet.Multiple( count, timeout );
 
 				switch( res )
 				{
 					case -1:
 					{
+						if( frameTimeout )
+						{
+							// The rest of a partial frame never arrived
+							AbortFrame();
+							break;
+						}
+
 						// Wait has timed out - time to resend
 						if( m_currentMsg != NULL )
 						{
@@ -459,10 +554,18 @@ void Driver::DriverThreadProc
 							notification->SetHomeAndNodeIds( m_homeId, m_currentMsg->GetTargetNodeId() );
 							notification->SetNotification( Notification::Code_Timeout );
 							QueueNotification( notification );
+
+							if( !m_waitingForAck )
+							{
+								if( Node* node = GetNodeUnsafe( m_currentMsg->GetTargetNodeId() ) )
+								{
+									node->BackOffRetryTimeout();
+								}
+							}
 						}
 						if( WriteMsg( "Wait Timeout" ) )
 						{
-							retryTimeStamp.SetTime( retryTimeout );
+							retryTimeStamp.SetTime( GetRetryTimeout( retryTimeout ) );
 						}
 						break;
 					}
@@ -479,7 +582,7 @@ void Driver::DriverThreadProc
 					}
 					case 2:
 					{
-						// Data has been received
+						// Data has been received.  Decode every complete frame in the buffer.
 						ReadMsg();
 						break;
 					}
@@ -488,7 +591,7 @@ void Driver::DriverThreadProc
 						// All the other events are sending message queue items
 						if( WriteNextMsg( (MsgQueue)(res-3) ) )
 						{
-							retryTimeStamp.SetTime( retryTimeout );
+							retryTimeStamp.SetTime( GetRetryTimeout( retryTimeout ) );
 						}
 						break;
 					}
@@ -548,6 +651,7 @@ bool Driver::Init
 
 	m_Controller_nodeId = -1;
 	m_waitingForAck = false;
+	m_readState = ReadState_Idle;
 
 	// Open the controller
 	Log::Write( LogLevel_Info, "  Opening controller %s", m_controllerPath.c_str() );
@@ -597,34 +701,54 @@ void Driver::RemoveQueues
 	// Clear the send Queue
 	for( int32 i=0; i<MsgQueue_Count; ++i )
 	{
-		list<MsgQueueItem>::iterator it = m_msgQueue[i].begin();
-		while( it != m_msgQueue[i].end() )
+		if( MsgQueue_Controller == i )
 		{
-			bool remove = false;
-			MsgQueueItem const& item = *it;
-			if( MsgQueueCmd_SendMsg == item.m_command && _nodeId == item.m_msg->GetTargetNodeId() )
-			{
-				delete item.m_msg;
-				remove = true;
-			}
-			else if( MsgQueueCmd_QueryStageComplete == item.m_command && _nodeId == item.m_nodeId )
-			{
-				remove = true;
-			}
-			else if( MsgQueueCmd_Controller == item.m_command && _nodeId == item.m_cci->m_controllerCommandNode && m_currentControllerCommand != item.m_cci )
-			{
-				delete item.m_cci;
-				remove = true;
-			}
-			if( remove )
+			// The controller queue may hold controller commands, which are
+			// not indexed by node, so scan it
+			list<MsgQueueItem>::iterator it = m_msgQueue[i].begin();
+			while( it != m_msgQueue[i].end() )
 			{
-				it = m_msgQueue[i].erase( it );
+				bool remove = false;
+				MsgQueueItem const& item = *it;
+				if( MsgQueueCmd_SendMsg == item.m_command && _nodeId == item.m_msg->GetTargetNodeId() )
+				{
+					delete item.m_msg;
+					remove = true;
+				}
+				else if( MsgQueueCmd_QueryStageComplete == item.m_command && _nodeId == item.m_nodeId )
+				{
+					remove = true;
+				}
+				else if( MsgQueueCmd_Controller == item.m_command && _nodeId == item.m_cci->m_controllerCommandNode && m_currentControllerCommand != item.m_cci )
+				{
+					delete item.m_cci;
+					remove = true;
+				}
+				if( remove )
+				{
+					it = m_msgQueue[i].erase( it );
+				}
+				else
+				{
+					++it;
+				}
 			}
-			else
+		}
+		else
+		{
+			list<list<MsgQueueItem>::iterator>& index = m_nodeQueueIndex[_nodeId][i];
+			for( list<list<MsgQueueItem>::iterator>::iterator it = index.begin(); it != index.end(); ++it )
 			{
-				++it;
+				MsgQueueItem const& item = **it;
+				if( MsgQueueCmd_SendMsg == item.m_command )
+				{
+					delete item.m_msg;
+				}
+				m_msgQueue[i].erase( *it );
 			}
 		}
+		ClearNodeQueueIndex( _nodeId, (MsgQueue)i );
+
 		if( m_msgQueue[i].empty() )
 		{
 			m_queueEvent[i]->Reset();
@@ -912,7 +1036,10 @@ void Driver::SendQueryStageComplete
 				{
 					// If the message is for a sleeping node, we queue it in the node itself.
 					Log::Write( LogLevel_Info, "" );
-					Log::Write( LogLevel_Detail, node->GetNodeId(), "Queuing (%s) Query Stage Complete (%s)", c_sendQueueNames[MsgQueue_WakeUp], node->GetQueryStageName( _stage ).c_str() );
+					if( Log::IsLevelEnabled( LogLevel_Detail ) )
+					{
+						Log::Write( LogLevel_Detail, node->GetNodeId(), "Queuing (%s) Query Stage Complete (%s)", c_sendQueueNames[MsgQueue_WakeUp], node->GetQueryStageName( _stage ).c_str() );
+					}
 					wakeUp->QueueMsg( item );
 					return;
 				}
@@ -920,10 +1047,12 @@ void Driver::SendQueryStageComplete
 		}
 
 		// Non-sleeping node
-		Log::Write( LogLevel_Detail, node->GetNodeId(), "Queuing (%s) Query Stage Complete (%s)", c_sendQueueNames[MsgQueue_Query], node->GetQueryStageName( _stage ).c_str() );
+		if( Log::IsLevelEnabled( LogLevel_Detail ) )
+		{
+			Log::Write( LogLevel_Detail, node->GetNodeId(), "Queuing (%s) Query Stage Complete (%s)", c_sendQueueNames[MsgQueue_Query], node->GetQueryStageName( _stage ).c_str() );
+		}
 		m_sendMutex->Lock();
-		m_msgQueue[MsgQueue_Query].push_back( item );
-		m_queueEvent[MsgQueue_Query]->Set();
+		PushQueueItem( MsgQueue_Query, item );
 		m_sendMutex->Unlock();
 
 	}
@@ -946,11 +1075,12 @@ void Driver::RetryQueryStageComplete
 
 	m_sendMutex->Lock();
 
-	for( list<MsgQueueItem>::iterator it = m_msgQueue[MsgQueue_Query].begin(); it != m_msgQueue[MsgQueue_Query].end(); ++it )
+	list<list<MsgQueueItem>::iterator>& index = m_nodeQueueIndex[_nodeId][MsgQueue_Query];
+	for( list<list<MsgQueueItem>::iterator>::iterator it = index.begin(); it != index.end(); ++it )
 	{
-		if( *it == item )
+		if( **it == item )
 		{
-			(*it).m_retry = true;
+			(**it).m_retry = true;
 			break;
 		}
 	}
@@ -984,7 +1114,10 @@ void Driver::SendMsg
 				CommandClass *cc = node->GetCommandClass(_msg->GetSendingCommandClass());
 				if ( (cc) && (cc->IsSecured()) )
 				{
-					Log::Write( LogLevel_Detail, GetNodeNumber( _msg ), "Setting Encryption Flag on Message For Command Class %s", cc->GetCommandClassName().c_str());
+					if( Log::IsLevelEnabled( LogLevel_Detail ) )
+					{
+						Log::Write( LogLevel_Detail, GetNodeNumber( _msg ), "Setting Encryption Flag on Message For Command Class %s", cc->GetCommandClassName().c_str());
+					}
 					item.m_msg->setEncrypted();
 				}
 			}
@@ -994,7 +1127,7 @@ void Driver::SendMsg
 			{
 				if( WakeUp* wakeUp = static_cast<WakeUp*>( node->GetCommandClass( WakeUp::StaticGetCommandClassId() ) ) )
 				{
-					if( !wakeUp->IsAwake() )
+					if( wakeUp->IsHoldingMsgs() )
 					{
 						Log::Write( LogLevel_Detail, "" );
 						// Handle saving multi-step controller commands
@@ -1009,7 +1142,10 @@ void Driver::SendMsg
 						}
 						else
 						{
-							Log::Write( LogLevel_Detail, GetNodeNumber( _msg ), "Queuing (%s) %s", c_sendQueueNames[MsgQueue_WakeUp], _msg->GetAsString().c_str() );
+							if( Log::IsLevelEnabled( LogLevel_Detail ) )
+							{
+								Log::Write( LogLevel_Detail, GetNodeNumber( _msg ), "Queuing (%s) %s", c_sendQueueNames[MsgQueue_WakeUp], _msg->GetAsString().c_str() );
+							}
 						}
 						wakeUp->QueueMsg( item );
 						return;
@@ -1018,170 +1154,530 @@ void Driver::SendMsg
 			}
 		}
 	}
-	Log::Write( LogLevel_Detail, GetNodeNumber( _msg ), "Queuing (%s) %s", c_sendQueueNames[_queue], _msg->GetAsString().c_str() );
+	if( m_bCoalesceRequests )
+	{
+		// Sending the same request again would only fetch the same report
+		m_sendMutex->Lock();
+		bool pending = IsRequestPending( _msg, _queue );
+		if( pending )
+		{
+			m_coalesced++;
+		}
+		m_sendMutex->Unlock();
+
+		if( pending )
+		{
+			if( Log::IsLevelEnabled( LogLevel_Detail ) )
+			{
+				Log::Write( LogLevel_Detail, GetNodeNumber( _msg ), "Not queuing (%s) %s - an identical request is already waiting", c_sendQueueNames[_queue], _msg->GetAsString().c_str() );
+			}
+			delete _msg;
+			return;
+		}
+	}
+	if( Log::IsLevelEnabled( LogLevel_Detail ) )
+	{
+		Log::Write( LogLevel_Detail, GetNodeNumber( _msg ), "Queuing (%s) %s", c_sendQueueNames[_queue], _msg->GetAsString().c_str() );
+	}
 	m_sendMutex->Lock();
-	m_msgQueue[_queue].push_back( item );
-	m_queueEvent[_queue]->Set();
+	PushQueueItem( _queue, item );
 	m_sendMutex->Unlock();
 }
 
 //-----------------------------------------------------------------------------
-// <Driver::WriteNextMsg>
-// Transmit a queued message to the Z-Wave controller
+// <Driver::PushQueueItem>
+// Append an item to a send queue, and to the index of its node's items
 //-----------------------------------------------------------------------------
-bool Driver::WriteNextMsg
+void Driver::PushQueueItem
 (
-		MsgQueue const _queue
+		MsgQueue const _queue,
+		MsgQueueItem const& _item
 )
 {
-
-	// There are messages to send, so get the one at the front of the queue
-	m_sendMutex->Lock();
-	MsgQueueItem item = m_msgQueue[_queue].front();
-
-	if( MsgQueueCmd_SendMsg == item.m_command )
+	m_msgQueue[_queue].push_back( _item );
+	if( MsgQueueCmd_Controller != _item.m_command )
 	{
-		// Send a message
-		m_currentMsg = item.m_msg;
-		m_currentMsgQueueSource = _queue;
-		m_msgQueue[_queue].pop_front();
-		if( m_msgQueue[_queue].empty() )
+		uint8 nodeId = ( MsgQueueCmd_SendMsg == _item.m_command ) ? _item.m_msg->GetTargetNodeId() : _item.m_nodeId;
+		list<list<MsgQueueItem>::iterator>& index = m_nodeQueueIndex[nodeId][_queue];
+		if( index.empty() )
 		{
-			m_queueEvent[_queue]->Reset();
+			// The node joins the back of the rotation for this queue
+			m_queueRotationPos[nodeId][_queue] = m_queueRotation[_queue].insert( m_queueRotation[_queue].end(), nodeId );
 		}
-		if (m_nonceReportSent > 0) {
-			MsgQueueItem item_new;
-			item_new.m_command = MsgQueueCmd_SendMsg;
-			item_new.m_nodeId = item.m_msg->GetTargetNodeId();
-			item_new.m_retry = item.m_retry;
-			item_new.m_msg = new Msg(*item.m_msg);
-			m_msgQueue[_queue].push_front(item_new);
-			m_queueEvent[_queue]->Set();
-		}
-		m_sendMutex->Unlock();
-		return WriteMsg( "WriteNextMsg" );
+		index.push_back( --m_msgQueue[_queue].end() );
 	}
+	m_queueEvent[_queue]->Set();
+}
 
-	if( MsgQueueCmd_QueryStageComplete == item.m_command )
+//-----------------------------------------------------------------------------
+// <Driver::GetNextQueueItem>
+// Choose the next item to send from a queue.  Normally this is simply the
+// oldest, but with fair scheduling the nodes take turns, each sending up to
+// its weight in messages (oldest first) before moving to the back of the
+// rotation.  The controller queue is always first come first served.
+//-----------------------------------------------------------------------------
+list<Driver::MsgQueueItem>::iterator Driver::GetNextQueueItem
+(
+		MsgQueue const _queue
+)
+{
+	if( !m_bFairScheduling || MsgQueue_Controller == _queue || m_queueRotation[_queue].empty() )
 	{
-		// Move to the next query stage
-		m_currentMsg = NULL;
-		Node::QueryStage stage = item.m_queryStage;
-		m_msgQueue[_queue].pop_front();
-		if( m_msgQueue[_queue].empty() )
-		{
-			m_queueEvent[_queue]->Reset();
-		}
-		m_sendMutex->Unlock();
+		return m_msgQueue[_queue].begin();
+	}
 
-		Node* node = GetNodeUnsafe( item.m_nodeId );
-		if( node != NULL )
-		{
-			Log::Write( LogLevel_Detail, node->GetNodeId(), "Query Stage Complete (%s)", node->GetQueryStageName( stage ).c_str() );
-			if( !item.m_retry )
-			{
-				node->QueryStageComplete( stage );
-			}
-			node->AdvanceQueries();
-			return true;
-		}
+	uint8 nodeId = m_queueRotation[_queue].front();
+	if( m_queueCredit[_queue] == 0 )
+	{
+		// Start of this node's turn
+		m_queueCredit[_queue] = m_nodeSendWeight[nodeId];
 	}
+	return m_nodeQueueIndex[nodeId][_queue].front();
+}
 
-	if( MsgQueueCmd_Controller == item.m_command )
+//-----------------------------------------------------------------------------
+// <Driver::IsRequestPending>
+// Check whether a Get identical to this one is already waiting in the queue it
+// is going into or one served before it, such as a refresh the application
+// asked for while a poll of the same value is queued behind it.
+// Only the node's items that will be sent last are considered: once anything
+// other than a Get (such as a Set) is due to be sent for the node, a new Get
+// must still be sent after it.
+//-----------------------------------------------------------------------------
+bool Driver::IsRequestPending
+(
+		Msg const* _msg,
+		MsgQueue const _queue
+)
+{
+	if( FUNC_ID_APPLICATION_COMMAND_HANDLER != _msg->GetExpectedReply() )
 	{
-		// Run a multi-step controller command
-		m_currentControllerCommand = item.m_cci;
-		m_sendMutex->Unlock();
-		// Figure out if done with command
-		if ( m_currentControllerCommand->m_controllerCommandDone )
+		return false;
+	}
+
+	// A queue is only served once every queue before it is empty, so walking the
+	// queues from _queue to the first, and each node index from back to front,
+	// visits the node's items in the reverse of the order they will be sent.
+	// A copy in a later queue is not enough, as the request would then wait
+	// behind everything of higher priority than the queue it was meant for.
+	uint8 nodeId = _msg->GetTargetNodeId();
+	for( int32 i=_queue; i>=0; --i )
+	{
+		list<list<MsgQueueItem>::iterator>& index = m_nodeQueueIndex[nodeId][i];
+		for( list<list<MsgQueueItem>::iterator>::reverse_iterator it = index.rbegin(); it != index.rend(); ++it )
 		{
-			m_sendMutex->Lock();
-			m_msgQueue[_queue].pop_front();
-			if( m_msgQueue[_queue].empty() )
+			MsgQueueItem const& item = **it;
+			if( MsgQueueCmd_SendMsg != item.m_command || FUNC_ID_APPLICATION_COMMAND_HANDLER != item.m_msg->GetExpectedReply() )
 			{
-				m_queueEvent[_queue]->Reset();
+				return false;
 			}
-			m_sendMutex->Unlock();
-			if( m_currentControllerCommand->m_controllerCallback )
+			if( *item.m_msg == *_msg )
 			{
-				m_currentControllerCommand->m_controllerCallback( m_currentControllerCommand->m_controllerState, m_currentControllerCommand->m_controllerReturnError, m_currentControllerCommand->m_controllerCallbackContext );
+				return true;
 			}
-			m_sendMutex->Lock();
-			delete m_currentControllerCommand;
-			m_currentControllerCommand = NULL;
-			m_sendMutex->Unlock();
 		}
-		else if( m_currentControllerCommand->m_controllerState == ControllerState_Normal )
+	}
+	return false;
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::PopQueueItem>
+// Remove an item chosen by GetNextQueueItem from a send queue.  Items only
+// ever join the back of a queue, and each node's items are sent in order, so
+// it is also the first entry in its node's index.
+//-----------------------------------------------------------------------------
+void Driver::PopQueueItem
+(
+		MsgQueue const _queue,
+		list<MsgQueueItem>::iterator _it
+)
+{
+	MsgQueueItem const& item = *_it;
+	if( MsgQueueCmd_Controller != item.m_command )
+	{
+		uint8 nodeId = ( MsgQueueCmd_SendMsg == item.m_command ) ? item.m_msg->GetTargetNodeId() : item.m_nodeId;
+		list<list<MsgQueueItem>::iterator>& index = m_nodeQueueIndex[nodeId][_queue];
+		index.pop_front();
+
+		list<uint8>::iterator pos = m_queueRotationPos[nodeId][_queue];
+		if( index.empty() )
 		{
-			DoControllerCommand();
+			if( pos == m_queueRotation[_queue].begin() )
+			{
+				m_queueCredit[_queue] = 0;
+			}
+			m_queueRotation[_queue].erase( pos );
 		}
-		else if( m_currentControllerCommand->m_controllerStateChanged )
+		else if( pos == m_queueRotation[_queue].begin() && m_queueCredit[_queue] > 0 )
 		{
-			if( m_currentControllerCommand->m_controllerCallback )
+			if( --m_queueCredit[_queue] == 0 )
 			{
-				m_currentControllerCommand->m_controllerCallback( m_currentControllerCommand->m_controllerState, m_currentControllerCommand->m_controllerReturnError, m_currentControllerCommand->m_controllerCallbackContext );
+				// End of this node's turn
+				m_queueRotation[_queue].splice( m_queueRotation[_queue].end(), m_queueRotation[_queue], pos );
 			}
-			m_currentControllerCommand->m_controllerStateChanged = false;
 		}
-		else
+	}
+	m_msgQueue[_queue].erase( _it );
+	if( m_msgQueue[_queue].empty() )
+	{
+		m_queueEvent[_queue]->Reset();
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::ClearNodeQueueIndex>
+// Forget a node's items in a send queue, once they have been removed from it
+//-----------------------------------------------------------------------------
+void Driver::ClearNodeQueueIndex
+(
+		uint8 const _nodeId,
+		MsgQueue const _queue
+)
+{
+	if( !m_nodeQueueIndex[_nodeId][_queue].empty() )
+	{
+		list<uint8>::iterator pos = m_queueRotationPos[_nodeId][_queue];
+		if( pos == m_queueRotation[_queue].begin() )
 		{
-			Log::Write( LogLevel_Info, "WriteNextMsg Controller nothing to do" );
-			m_sendMutex->Lock();
-			m_queueEvent[_queue]->Reset();
-			m_sendMutex->Unlock();
+			m_queueCredit[_queue] = 0;
 		}
-		return true;
+		m_queueRotation[_queue].erase( pos );
+		m_nodeQueueIndex[_nodeId][_queue].clear();
 	}
+}
 
-	return false;
+//-----------------------------------------------------------------------------
+// <Driver::SetNodeSendWeight>
+// Set how many messages a node may send from a queue per turn
+//-----------------------------------------------------------------------------
+void Driver::SetNodeSendWeight
+(
+		uint8 const _nodeId,
+		uint8 const _weight
+)
+{
+	LockGuard LG(m_sendMutex);
+	m_nodeSendWeight[_nodeId] = ( _weight > 0 ) ? _weight : 1;
 }
 
 //-----------------------------------------------------------------------------
-// <Driver::WriteMsg>
-// Transmit the current message to the Z-Wave controller
+// <Driver::GetNodeSendWeight>
+// Get how many messages a node may send from a queue per turn
 //-----------------------------------------------------------------------------
-bool Driver::WriteMsg
+uint8 Driver::GetNodeSendWeight
 (
-		string const &msg
+		uint8 const _nodeId
 )
 {
-	if( !m_currentMsg )
+	LockGuard LG(m_sendMutex);
+	return m_nodeSendWeight[_nodeId];
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::SetNodeBatchRequests>
+// Set whether a node's Gets may be packed into MultiCmd frames
+//-----------------------------------------------------------------------------
+void Driver::SetNodeBatchRequests
+(
+		uint8 const _nodeId,
+		bool const _batch
+)
+{
+	LockGuard LG(m_sendMutex);
+	m_nodeBatchRequests[_nodeId] = _batch;
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::GetNodeBatchRequests>
+// Get whether a node's Gets may be packed into MultiCmd frames
+//-----------------------------------------------------------------------------
+bool Driver::GetNodeBatchRequests
+(
+		uint8 const _nodeId
+)
+{
+	LockGuard LG(m_sendMutex);
+	return m_nodeBatchRequests[_nodeId];
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::GetRetryTimeout>
+// How long to wait for the current message to complete before resending it
+//-----------------------------------------------------------------------------
+int32 Driver::GetRetryTimeout
+(
+		int32 const _default
+)
+{
+	// Encrypted messages wait on nonce exchanges as well, which the measurements do not cover
+	if( !m_bAdaptiveRetryTimeout || m_currentMsg == NULL || m_currentMsg->isEncrypted() )
 	{
-		Log::Write( LogLevel_Detail, GetNodeNumber( m_currentMsg ), "WriteMsg %s m_currentMsg=%08x", msg.c_str(), m_currentMsg );
-		// We try not to hang when this happenes
-		m_expectedCallbackId = 0;
-		m_expectedCommandClassId = 0;
-		m_expectedNodeId = 0;
-		m_expectedReply = 0;
-		m_waitingForAck = false;
-		return false;
-	}
-	/* if this is called with m_nonceReportSent > 0 it means that we have
-	 * tried to send a NONCE report and it timed out or was NAK'd
-	 *
-	 */
-	uint8 attempts;
-	uint8 nodeId;
-	if (m_nonceReportSent > 0) {
-		attempts = m_nonceReportSentAttempt++;
-		nodeId = m_nonceReportSent;
-	} else {
-		attempts = m_currentMsg->GetSendAttempts();
-		nodeId = m_currentMsg->GetTargetNodeId();
+		return _default;
 	}
-	LockGuard LG(m_nodeMutex);
-	Node* node = GetNode( nodeId );
-	if( attempts >= m_currentMsg->GetMaxSendAttempts() ||
-			(node != NULL && !node->IsNodeAlive() && !m_currentMsg->IsNoOperation() ) )
+
+	if( Node* node = GetNodeUnsafe( m_currentMsg->GetTargetNodeId() ) )
 	{
-		if( node != NULL && !node->IsNodeAlive() )
+		int32 timeout = node->GetRetryTimeout( FUNC_ID_APPLICATION_COMMAND_HANDLER == m_currentMsg->GetExpectedReply(), m_retryTimeoutMin, _default );
+		if( Log::IsLevelEnabled( LogLevel_Detail ) )
 		{
-			Log::Write( LogLevel_Error, nodeId, "ERROR: Dropping command because node is presumed dead" );
+			Log::Write( LogLevel_Detail, node->GetNodeId(), "Retry timeout %dms", timeout );
 		}
-		else
-		{
-			// That's it - already tried to send GetMaxSendAttempt() times.
-			Log::Write( LogLevel_Error, nodeId, "ERROR: Dropping command, expected response not received after %d attempt(s)", m_currentMsg->GetMaxSendAttempts() );
+		return timeout;
+	}
+	return _default;
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::IsBatchableRequest>
+// Check whether a message is a plain Get that can go inside a MultiCmd frame
+//-----------------------------------------------------------------------------
+bool Driver::IsBatchableRequest
+(
+		Msg* _msg
+)
+{
+	if( _msg->isEncrypted() || _msg->GetSendAttempts() != 0 || _msg->GetExpectedCommandClassId() == 0 ||
+			FUNC_ID_APPLICATION_COMMAND_HANDLER != _msg->GetExpectedReply() )
+	{
+		return false;
+	}
+
+	// REQUEST, FUNC_ID_ZW_SEND_DATA, node, length, command...
+	uint8 const* buffer = _msg->GetBuffer();
+	return( ( FUNC_ID_ZW_SEND_DATA == buffer[3] ) && ( buffer[5] >= 2 ) && ( MultiCmd::StaticGetCommandClassId() != buffer[6] ) );
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::BatchRequests>
+// If the current message is a Get for a node that supports MultiCmd, pack it
+// together with the Gets queued behind it for the same node, so that one
+// frame and one callback replace several.  Only the run of Gets at the front
+// of the node's queue is taken, so they still go out in order with respect to
+// anything else queued for the node.  The transaction completes on the reply
+// to the last Get, or on a MultiCmd encapsulated reply to them all.
+//-----------------------------------------------------------------------------
+void Driver::BatchRequests
+(
+		MsgQueue const _queue
+)
+{
+	uint8 nodeId = m_currentMsg->GetTargetNodeId();
+	if( !m_bBatchRequests || !m_nodeBatchRequests[nodeId] || m_nodeQueueIndex[nodeId][_queue].empty() || !IsBatchableRequest( m_currentMsg ) )
+	{
+		return;
+	}
+
+	Node* node = GetNodeUnsafe( nodeId );
+	if( node == NULL )
+	{
+		return;
+	}
+	CommandClass* cc = node->GetCommandClass( MultiCmd::StaticGetCommandClassId() );
+	if( cc == NULL || cc->IsAfterMark() || cc->IsSecured() )
+	{
+		return;
+	}
+
+	vector<Msg*> msgs;
+	msgs.push_back( m_currentMsg );
+	uint32 length = 4 + m_currentMsg->GetBuffer()[5];		// MultiCmd header plus the first command and its length byte
+	list<list<MsgQueueItem>::iterator>& index = m_nodeQueueIndex[nodeId][_queue];
+	while( !index.empty() )
+	{
+		list<MsgQueueItem>::iterator it = index.front();
+		if( MsgQueueCmd_SendMsg != it->m_command || !IsBatchableRequest( it->m_msg ) || ( length + 1 + it->m_msg->GetBuffer()[5] ) > c_maxBatchLength )
+		{
+			break;
+		}
+		length += 1 + it->m_msg->GetBuffer()[5];
+		msgs.push_back( it->m_msg );
+		PopQueueItem( _queue, it );
+	}
+
+	if( msgs.size() < 2 )
+	{
+		return;
+	}
+
+	Msg* msg = new Msg( "MultiCmd Encapsulated Requests", nodeId, REQUEST, FUNC_ID_ZW_SEND_DATA, true, true, FUNC_ID_APPLICATION_COMMAND_HANDLER, msgs.back()->GetExpectedCommandClassId() );
+	msg->Append( nodeId );
+	msg->Append( (uint8)length );
+	msg->Append( MultiCmd::StaticGetCommandClassId() );
+	msg->Append( MultiCmd::MultiCmdCmd_Encap );
+	msg->Append( (uint8)msgs.size() );
+	for( vector<Msg*>::iterator it = msgs.begin(); it != msgs.end(); ++it )
+	{
+		uint8 const* buffer = (*it)->GetBuffer();
+		if( Log::IsLevelEnabled( LogLevel_Detail ) )
+		{
+			Log::Write( LogLevel_Detail, nodeId, "Batching %s", (*it)->GetAsString().c_str() );
+		}
+		for( uint8 i=0; i<=buffer[5]; ++i )
+		{
+			msg->Append( buffer[5+i] );
+		}
+		delete *it;
+	}
+	msg->Append( GetTransmitOptions() );
+	msg->SetHomeId( m_homeId );
+	msg->Finalize();
+
+	Log::Write( LogLevel_Info, nodeId, "Sending %d requests in one MultiCmd frame", (int)msgs.size() );
+	m_currentMsg = msg;
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::WriteNextMsg>
+// Transmit a queued message to the Z-Wave controller
+//-----------------------------------------------------------------------------
+bool Driver::WriteNextMsg
+(
+		MsgQueue const _queue
+)
+{
+
+	// There are messages to send, so get the one at the front of the queue
+	m_sendMutex->Lock();
+	list<MsgQueueItem>::iterator next = GetNextQueueItem( _queue );
+	MsgQueueItem item = *next;
+
+	if( MsgQueueCmd_SendMsg == item.m_command )
+	{
+		// Send a message
+		m_currentMsg = item.m_msg;
+		m_currentMsgQueueSource = _queue;
+		if( m_nonceReportSent > 0 )
+		{
+			// A nonce report goes out first.  Leave the message at the front
+			// of the queue so it is sent afterwards, rather than copying it.
+			m_currentMsgQueued = true;
+		}
+		else
+		{
+			m_currentMsgQueued = false;
+			PopQueueItem( _queue, next );
+			BatchRequests( _queue );
+		}
+		m_sendMutex->Unlock();
+		return WriteMsg( "WriteNextMsg" );
+	}
+
+	if( MsgQueueCmd_QueryStageComplete == item.m_command )
+	{
+		// Move to the next query stage
+		m_currentMsg = NULL;
+		m_currentMsgQueued = false;
+		Node::QueryStage stage = item.m_queryStage;
+		PopQueueItem( _queue, next );
+		m_sendMutex->Unlock();
+
+		Node* node = GetNodeUnsafe( item.m_nodeId );
+		if( node != NULL )
+		{
+			if( Log::IsLevelEnabled( LogLevel_Detail ) )
+			{
+				Log::Write( LogLevel_Detail, node->GetNodeId(), "Query Stage Complete (%s)", node->GetQueryStageName( stage ).c_str() );
+			}
+			if( !item.m_retry )
+			{
+				node->QueryStageComplete( stage );
+			}
+			node->AdvanceQueries();
+			return true;
+		}
+	}
+
+	if( MsgQueueCmd_Controller == item.m_command )
+	{
+		// Run a multi-step controller command
+		m_currentControllerCommand = item.m_cci;
+		m_sendMutex->Unlock();
+		// Figure out if done with command
+		if ( m_currentControllerCommand->m_controllerCommandDone )
+		{
+			m_sendMutex->Lock();
+			PopQueueItem( _queue, m_msgQueue[_queue].begin() );
+			m_sendMutex->Unlock();
+			if( m_currentControllerCommand->m_controllerCallback )
+			{
+				m_currentControllerCommand->m_controllerCallback( m_currentControllerCommand->m_controllerState, m_currentControllerCommand->m_controllerReturnError, m_currentControllerCommand->m_controllerCallbackContext );
+			}
+			m_sendMutex->Lock();
+			delete m_currentControllerCommand;
+			m_currentControllerCommand = NULL;
+			m_sendMutex->Unlock();
+		}
+		else if( m_currentControllerCommand->m_controllerState == ControllerState_Normal )
+		{
+			DoControllerCommand();
+		}
+		else if( m_currentControllerCommand->m_controllerStateChanged )
+		{
+			if( m_currentControllerCommand->m_controllerCallback )
+			{
+				m_currentControllerCommand->m_controllerCallback( m_currentControllerCommand->m_controllerState, m_currentControllerCommand->m_controllerReturnError, m_currentControllerCommand->m_controllerCallbackContext );
+			}
+			m_currentControllerCommand->m_controllerStateChanged = false;
+		}
+		else
+		{
+			Log::Write( LogLevel_Info, "WriteNextMsg Controller nothing to do" );
+			m_sendMutex->Lock();
+			m_queueEvent[_queue]->Reset();
+			m_sendMutex->Unlock();
+		}
+		return true;
+	}
+
+	return false;
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::WriteMsg>
+// Transmit the current message to the Z-Wave controller
+//-----------------------------------------------------------------------------
+bool Driver::WriteMsg
+(
+		string const &msg
+)
+{
+	if( !m_currentMsg )
+	{
+		Log::Write( LogLevel_Detail, GetNodeNumber( m_currentMsg ), "WriteMsg %s m_currentMsg=%08x", msg.c_str(), m_currentMsg );
+		// We try not to hang when this happenes
+		m_expectedCallbackId = 0;
+		m_expectedCommandClassId = 0;
+		m_expectedNodeId = 0;
+		m_expectedReply = 0;
+		m_waitingForAck = false;
+		return false;
+	}
+	/* if this is called with m_nonceReportSent > 0 it means that we have
+	 * tried to send a NONCE report and it timed out or was NAK'd
+	 *
+	 */
+	uint8 attempts;
+	uint8 nodeId;
+	if (m_nonceReportSent > 0) {
+		attempts = m_nonceReportSentAttempt++;
+		nodeId = m_nonceReportSent;
+	} else {
+		attempts = m_currentMsg->GetSendAttempts();
+		nodeId = m_currentMsg->GetTargetNodeId();
+	}
+	LockGuard LG(m_nodeMutex);
+	Node* node = GetNode( nodeId );
+	if( attempts >= m_currentMsg->GetMaxSendAttempts() ||
+			(node != NULL && !node->IsNodeAlive() && !m_currentMsg->IsNoOperation() ) )
+	{
+		if( node != NULL && !node->IsNodeAlive() )
+		{
+			Log::Write( LogLevel_Error, nodeId, "ERROR: Dropping command because node is presumed dead" );
+		}
+		else
+		{
+			// That's it - already tried to send GetMaxSendAttempt() times.
+			Log::Write( LogLevel_Error, nodeId, "ERROR: Dropping command, expected response not received after %d attempt(s)", m_currentMsg->GetMaxSendAttempts() );
 		}
 		if( m_currentControllerCommand != NULL )
 		{
@@ -1189,6 +1685,11 @@ bool Driver::WriteMsg
 			UpdateControllerState( ControllerState_Error, ControllerError_Failed);
 
 		}
+		if( m_currentMsg->IsMulticast() )
+		{
+			// The nodes may never have seen it, so send the command to each of them
+			CompleteMulticast( false );
+		}
 
 		RemoveCurrentMsg();
 		m_dropped++;
@@ -1297,9 +1798,13 @@ void Driver::RemoveCurrentMsg
 	Log::Write( LogLevel_Detail, GetNodeNumber( m_currentMsg ), "Removing current message" );
 	if( m_currentMsg != NULL)
 	{
-		delete m_currentMsg;
+		if( !m_currentMsgQueued )
+		{
+			delete m_currentMsg;
+		}
 		m_currentMsg = NULL;
 	}
+	m_currentMsgQueued = false;
 
 	m_expectedCallbackId = 0;
 	m_expectedCommandClassId = 0;
@@ -1347,7 +1852,21 @@ bool Driver::MoveMessagesToWakeUpQueue
 					// Then try the current message first
 					if( m_currentMsg )
 					{
-						if( _targetNodeId == m_currentMsg->GetTargetNodeId() )
+						if( m_currentMsgQueued )
+						{
+							// Still at the front of its queue, so it is moved with the rest below
+							if( _targetNodeId == m_currentMsg->GetTargetNodeId() )
+							{
+								m_currentMsg = NULL;
+								m_currentMsgQueued = false;
+								m_expectedCallbackId = 0;
+								m_expectedCommandClassId = 0;
+								m_expectedNodeId = 0;
+								m_expectedReply = 0;
+								m_waitingForAck = false;
+							}
+						}
+						else if( _targetNodeId == m_currentMsg->GetTargetNodeId() )
 						{
 							// This message is for the unresponsive node
 							// We do not move any "Wake Up No More Information"
@@ -1380,62 +1899,33 @@ bool Driver::MoveMessagesToWakeUpQueue
 					// Now the message queues
 					for( int i=0; i<MsgQueue_Count; ++i )
 					{
-						list<MsgQueueItem>::iterator it = m_msgQueue[i].begin();
-						while( it != m_msgQueue[i].end() )
+						if( MsgQueue_Controller == i )
 						{
-							bool remove = false;
-							MsgQueueItem const& item = *it;
-							if( MsgQueueCmd_SendMsg == item.m_command )
-							{
-								if( _targetNodeId == item.m_msg->GetTargetNodeId() )
-								{
-									// This message is for the unresponsive node
-									// We do not move any "Wake Up No More Information"
-									// commands or NoOperations to the pending queue.
-									if( !item.m_msg->IsWakeUpNoMoreInformationCommand() && !item.m_msg->IsNoOperation() )
-									{
-										Log::Write( LogLevel_Info, item.m_msg->GetTargetNodeId(), "Node not responding - moving message to Wake-Up queue: %s", item.m_msg->GetAsString().c_str() );
-										/* reset any SendAttempts */
-										item.m_msg->SetSendAttempts(0);
-										wakeUp->QueueMsg( item );
-									}
-									else
-									{
-										delete item.m_msg;
-									}
-									remove = true;
-								}
-							}
-							if( MsgQueueCmd_QueryStageComplete == item.m_command )
+							// The controller queue may hold controller commands, which
+							// are not indexed by node, so scan it
+							list<MsgQueueItem>::iterator it = m_msgQueue[i].begin();
+							while( it != m_msgQueue[i].end() )
 							{
-								if( _targetNodeId == item.m_nodeId )
+								if( MoveQueueItemToWakeUp( _targetNodeId, *it, wakeUp ) )
 								{
-									Log::Write( LogLevel_Info, _targetNodeId, "Node not responding - moving QueryStageComplete command to Wake-Up queue" );
-
-									wakeUp->QueueMsg( item );
-									remove = true;
+									it = m_msgQueue[i].erase( it );
 								}
-							}
-							if( MsgQueueCmd_Controller == item.m_command )
-							{
-								if( _targetNodeId == item.m_cci->m_controllerCommandNode )
+								else
 								{
-									Log::Write( LogLevel_Info, _targetNodeId, "Node not responding - moving controller command to Wake-Up queue: %s", c_controllerCommandNames[item.m_cci->m_controllerCommand] );
-
-									wakeUp->QueueMsg( item );
-									remove = true;
+									++it;
 								}
 							}
-
-							if( remove )
-							{
-								it = m_msgQueue[i].erase( it );
-							}
-							else
+						}
+						else
+						{
+							list<list<MsgQueueItem>::iterator>& index = m_nodeQueueIndex[_targetNodeId][i];
+							for( list<list<MsgQueueItem>::iterator>::iterator it = index.begin(); it != index.end(); ++it )
 							{
-								++it;
+								MoveQueueItemToWakeUp( _targetNodeId, **it, wakeUp );
+								m_msgQueue[i].erase( *it );
 							}
 						}
+						ClearNodeQueueIndex( _targetNodeId, (MsgQueue)i );
 
 						// If the queue is now empty, we need to clear its event
 						if( m_msgQueue[i].empty() )
@@ -1452,8 +1942,7 @@ bool Driver::MoveMessagesToWakeUpQueue
 						item.m_command = MsgQueueCmd_Controller;
 						item.m_cci = new ControllerCommandItem( *m_currentControllerCommand );
 						m_currentControllerCommand = item.m_cci;
-						m_msgQueue[MsgQueue_Controller].push_back( item );
-						m_queueEvent[MsgQueue_Controller]->Set();
+						PushQueueItem( MsgQueue_Controller, item );
 					}
 
 					m_sendMutex->Unlock();
@@ -1469,6 +1958,61 @@ bool Driver::MoveMessagesToWakeUpQueue
 	return false;
 }
 
+//-----------------------------------------------------------------------------
+// <Driver::MoveQueueItemToWakeUp>
+// Move a send queue item for a sleeping node to its wake-up queue
+//-----------------------------------------------------------------------------
+bool Driver::MoveQueueItemToWakeUp
+(
+		uint8 const _targetNodeId,
+		MsgQueueItem const& _item,
+		WakeUp* _wakeUp
+)
+{
+	if( MsgQueueCmd_SendMsg == _item.m_command )
+	{
+		if( _targetNodeId == _item.m_msg->GetTargetNodeId() )
+		{
+			// This message is for the unresponsive node
+			// We do not move any "Wake Up No More Information"
+			// commands or NoOperations to the pending queue.
+			if( !_item.m_msg->IsWakeUpNoMoreInformationCommand() && !_item.m_msg->IsNoOperation() )
+			{
+				Log::Write( LogLevel_Info, _item.m_msg->GetTargetNodeId(), "Node not responding - moving message to Wake-Up queue: %s", _item.m_msg->GetAsString().c_str() );
+				/* reset any SendAttempts */
+				_item.m_msg->SetSendAttempts(0);
+				_wakeUp->QueueMsg( _item );
+			}
+			else
+			{
+				delete _item.m_msg;
+			}
+			return true;
+		}
+	}
+	if( MsgQueueCmd_QueryStageComplete == _item.m_command )
+	{
+		if( _targetNodeId == _item.m_nodeId )
+		{
+			Log::Write( LogLevel_Info, _targetNodeId, "Node not responding - moving QueryStageComplete command to Wake-Up queue" );
+
+			_wakeUp->QueueMsg( _item );
+			return true;
+		}
+	}
+	if( MsgQueueCmd_Controller == _item.m_command )
+	{
+		if( _targetNodeId == _item.m_cci->m_controllerCommandNode )
+		{
+			Log::Write( LogLevel_Info, _targetNodeId, "Node not responding - moving controller command to Wake-Up queue: %s", c_controllerCommandNames[_item.m_cci->m_controllerCommand] );
+
+			_wakeUp->QueueMsg( _item );
+			return true;
+		}
+	}
+	return false;
+}
+
 //-----------------------------------------------------------------------------
 // <Driver::HandleErrorResponse>
 // For messages that return a ZW_SEND_DATA response, process the results here
@@ -1619,6 +2163,7 @@ bool Driver::IsExpectedReply
 			m_expectedReply == FUNC_ID_ZW_ASSIGN_RETURN_ROUTE ||
 			m_expectedReply == FUNC_ID_ZW_DELETE_RETURN_ROUTE ||
 			m_expectedReply == FUNC_ID_ZW_SEND_DATA ||
+			m_expectedReply == FUNC_ID_ZW_SEND_DATA_MULTI ||
 			m_expectedReply == FUNC_ID_ZW_SEND_NODE_INFORMATION ||
 			m_expectedReply == FUNC_ID_ZW_REQUEST_NODE_NEIGHBOR_UPDATE ||
 			m_expectedReply == FUNC_ID_ZW_ENABLE_SUC ||
@@ -1641,169 +2186,232 @@ bool Driver::IsExpectedReply
 
 //-----------------------------------------------------------------------------
 // <Driver::ReadMsg>
-// Read data from the serial port
+// Decode all of the frames currently buffered from the serial port
 //-----------------------------------------------------------------------------
 bool Driver::ReadMsg
 (
 )
 {
-	uint8 buffer[1024] = {0};
-
-	if( !m_controller->Read( buffer, 1 ) )
-	{
-		// Nothing to read
-		return false;
-	}
+	bool dataRead = false;
 
-	switch( buffer[0] )
+	while( true )
 	{
-		case SOF:
+		switch( m_readState )
 		{
-			m_SOFCnt++;
-			if( m_waitingForAck )
+			case ReadState_Idle:
 			{
-				// This can happen on any normal network when a transmission overlaps an unexpected
-				// reception and the data in the buffer doesn't contain the ACK. The controller will
-				// notice and send us a CAN to retransmit.
-				Log::Write( LogLevel_Detail, "Unsolicited message received while waiting for ACK." );
-				m_ACKWaiting++;
-			}
+				if( !m_controller->GetDataSize() )
+				{
+					// Nothing more to read
+					m_controller->SetSignalThreshold( 1 );
+					return dataRead;
+				}
 
-			// Read the length byte.  Keep trying until we get it.
-			m_controller->SetSignalThreshold( 1 );
-			int32 response = Wait::Single( m_controller, 50 );
-			if( response < 0 )
-			{
-				Log::Write( LogLevel_Warning, "WARNING: 50ms passed without finding the length byte...aborting frame read");
-				m_readAborts++;
-				break;
-			}
+				m_controller->Read( m_readBuffer, 1 );
+				dataRead = true;
 
-			m_controller->Read( &buffer[1], 1 );
-			m_controller->SetSignalThreshold( buffer[1] );
-			if( Wait::Single( m_controller, 500 ) < 0 )
-			{
-				Log::Write( LogLevel_Warning, "WARNING: 500ms passed without reading the rest of the frame...aborting frame read" );
-				m_readAborts++;
-				m_controller->SetSignalThreshold( 1 );
-				break;
-			}
+				switch( m_readBuffer[0] )
+				{
+					case SOF:
+					{
+						m_SOFCnt++;
+						if( m_waitingForAck )
+						{
+							// This can happen on any normal network when a transmission overlaps an unexpected
+							// reception and the data in the buffer doesn't contain the ACK. The controller will
+							// notice and send us a CAN to retransmit.
+							Log::Write( LogLevel_Detail, "Unsolicited message received while waiting for ACK." );
+							m_ACKWaiting++;
+						}
 
-			m_controller->Read( &buffer[2], buffer[1] );
-			m_controller->SetSignalThreshold( 1 );
+						// The length byte must follow shortly
+						m_readState = ReadState_Length;
+						m_readTimeStamp.SetTime( FRAME_LENGTH_TIMEOUT );
+						break;
+					}
 
-			uint32 length = buffer[1] + 2;
+					case CAN:
+					{
+						// This is the other side of an unsolicited ACK. As mentioned there if we receive a message
+						// just after we transmitted one, the controller will notice and tell us to retransmit here.
+						// Don't increment the transmission counter as it is possible the message will never get out
+						// on very busy networks with lots of unsolicited messages being received. Increase the amount
+						// of retries but only up to a limit so we don't stay here forever.
+						Log::Write( LogLevel_Detail, GetNodeNumber( m_currentMsg ), "CAN received...triggering resend" );
+						m_CANCnt++;
+						if( m_currentMsg != NULL )
+						{
+							m_currentMsg->SetMaxSendAttempts( m_currentMsg->GetMaxSendAttempts() + 1 );
+						}
+						else
+						{
+							Log::Write( LogLevel_Warning, "m_currentMsg was NULL when trying to set MaxSendAttempts" );
+							Log::QueueDump();
+						}
+						WriteMsg( "CAN" );
+						break;
+					}
 
-			// Log the data
-			string str = "";
-			for( uint32 i=0; i<length; ++i )
-			{
-				if( i )
-				{
-					str += ", ";
-				}
+					case NAK:
+					{
+						Log::Write( LogLevel_Warning, GetNodeNumber( m_currentMsg ), "WARNING: NAK received...triggering resend" );
+						m_NAKCnt++;
+						WriteMsg( "NAK" );
+						break;
+					}
 
-				char byteStr[8];
-				snprintf( byteStr, sizeof(byteStr), "0x%.2x", buffer[i] );
-				str += byteStr;
-			}
-			uint8 nodeId = NodeFromMessage( buffer );
-			if( nodeId == 0 )
-			{
-				nodeId = GetNodeNumber( m_currentMsg );
-			}
-			Log::Write( LogLevel_Detail, nodeId, "  Received: %s", str.c_str() );
+					case ACK:
+					{
+						m_ACKCnt++;
+						m_waitingForAck = false;
+						if( m_currentMsg == NULL )
+						{
+							Log::Write( LogLevel_StreamDetail, 255, "  ACK received" );
+						}
+						else
+						{
+							Log::Write( LogLevel_StreamDetail, GetNodeNumber( m_currentMsg ), "  ACK received CallbackId 0x%.2x Reply 0x%.2x", m_expectedCallbackId, m_expectedReply );
+							if( ( 0 == m_expectedCallbackId ) && ( 0 == m_expectedReply ) )
+							{
+								// Remove the message from the queue, now that it has been acknowledged.
+								RemoveCurrentMsg();
+							}
+						}
+						break;
+					}
 
-			// Verify checksum
-			uint8 checksum = 0xff;
-			for( uint32 i=1; i<(length-1); ++i )
-			{
-				checksum ^= buffer[i];
+					default:
+					{
+						Log::Write( LogLevel_Warning, "WARNING: Out of frame flow! (0x%.2x).  Sending NAK.", m_readBuffer[0] );
+						m_OOFCnt++;
+						uint8 nak = NAK;
+						m_controller->Write( &nak, 1 );
+						m_controller->Purge();
+						break;
+					}
+				}
+				break;
 			}
 
-			if( buffer[length-1] == checksum )
+			case ReadState_Length:
 			{
-				// Checksum correct - send ACK
-				uint8 ack = ACK;
-				m_controller->Write( &ack, 1 );
-				m_readCnt++;
+				if( !m_controller->GetDataSize() )
+				{
+					// Keep the SOF and wait for the length byte to arrive
+					m_controller->SetSignalThreshold( 1 );
+					return dataRead;
+				}
 
-				// Process the received message
-				ProcessMsg( &buffer[2] );
-			}
-			else
-			{
-				Log::Write( LogLevel_Warning, nodeId, "WARNING: Checksum incorrect - sending NAK" );
-				m_badChecksum++;
-				uint8 nak = NAK;
-				m_controller->Write( &nak, 1 );
-				m_controller->Purge();
+				m_controller->Read( &m_readBuffer[1], 1 );
+				dataRead = true;
+				m_readState = ReadState_Data;
+				m_readTimeStamp.SetTime( FRAME_BODY_TIMEOUT );
+				break;
 			}
-			break;
-		}
 
-		case CAN:
-		{
-			// This is the other side of an unsolicited ACK. As mentioned there if we receive a message
-			// just after we transmitted one, the controller will notice and tell us to retransmit here.
-			// Don't increment the transmission counter as it is possible the message will never get out
-			// on very busy networks with lots of unsolicited messages being received. Increase the amount
-			// of retries but only up to a limit so we don't stay here forever.
-			Log::Write( LogLevel_Detail, GetNodeNumber( m_currentMsg ), "CAN received...triggering resend" );
-			m_CANCnt++;
-			if( m_currentMsg != NULL )
-			{
-				m_currentMsg->SetMaxSendAttempts( m_currentMsg->GetMaxSendAttempts() + 1 );
-			}
-			else
+			case ReadState_Data:
 			{
-				Log::Write( LogLevel_Warning, "m_currentMsg was NULL when trying to set MaxSendAttempts" );
-				Log::QueueDump();
+				if( m_controller->GetDataSize() < m_readBuffer[1] )
+				{
+					// Keep what we have and wait for the rest of the frame to arrive
+					m_controller->SetSignalThreshold( m_readBuffer[1] );
+					return dataRead;
+				}
+
+				m_controller->Read( &m_readBuffer[2], m_readBuffer[1] );
+				dataRead = true;
+				m_readState = ReadState_Idle;
+				ProcessFrame();
+				break;
 			}
-			WriteMsg( "CAN" );
-			break;
 		}
+	}
+}
 
-		case NAK:
-		{
-			Log::Write( LogLevel_Warning, GetNodeNumber( m_currentMsg ), "WARNING: NAK received...triggering resend" );
-			m_NAKCnt++;
-			WriteMsg( "NAK" );
-			break;
-		}
+//-----------------------------------------------------------------------------
+// <Driver::AbortFrame>
+// Discard a partial frame whose remaining bytes did not arrive in time
+//-----------------------------------------------------------------------------
+void Driver::AbortFrame
+(
+)
+{
+	if( m_readState == ReadState_Length )
+	{
+		Log::Write( LogLevel_Warning, "WARNING: %dms passed without finding the length byte...aborting frame read", FRAME_LENGTH_TIMEOUT );
+	}
+	else
+	{
+		Log::Write( LogLevel_Warning, "WARNING: %dms passed without reading the rest of the frame...aborting frame read", FRAME_BODY_TIMEOUT );
+	}
+	m_readAborts++;
+	m_readState = ReadState_Idle;
+	m_controller->SetSignalThreshold( 1 );
+}
 
-		case ACK:
+//-----------------------------------------------------------------------------
+// <Driver::ProcessFrame>
+// Verify and acknowledge a complete frame, then process it
+//-----------------------------------------------------------------------------
+void Driver::ProcessFrame
+(
+)
+{
+	uint8* buffer = m_readBuffer;
+	uint32 length = buffer[1] + 2;
+
+	// Clear out anything left over from a longer previous frame
+	memset( &buffer[length], 0, sizeof(m_readBuffer) - length );
+
+	uint8 nodeId = NodeFromMessage( buffer );
+	if( nodeId == 0 )
+	{
+		nodeId = GetNodeNumber( m_currentMsg );
+	}
+
+	// Log the data
+	if( Log::IsLevelEnabled( LogLevel_Detail ) )
+	{
+		string str = "";
+		for( uint32 i=0; i<length; ++i )
 		{
-			m_ACKCnt++;
-			m_waitingForAck = false;
-			if( m_currentMsg == NULL )
+			if( i )
 			{
-				Log::Write( LogLevel_StreamDetail, 255, "  ACK received" );
-			}
-			else
-			{
-				Log::Write( LogLevel_StreamDetail, GetNodeNumber( m_currentMsg ), "  ACK received CallbackId 0x%.2x Reply 0x%.2x", m_expectedCallbackId, m_expectedReply );
-				if( ( 0 == m_expectedCallbackId ) && ( 0 == m_expectedReply ) )
-				{
-					// Remove the message from the queue, now that it has been acknowledged.
-					RemoveCurrentMsg();
-				}
+				str += ", ";
 			}
-			break;
-		}
 
-		default:
-		{
-			Log::Write( LogLevel_Warning, "WARNING: Out of frame flow! (0x%.2x).  Sending NAK.", buffer[0] );
-			m_OOFCnt++;
-			uint8 nak = NAK;
-			m_controller->Write( &nak, 1 );
-			m_controller->Purge();
-			break;
+			char byteStr[8];
+			snprintf( byteStr, sizeof(byteStr), "0x%.2x", buffer[i] );
+			str += byteStr;
 		}
+		Log::Write( LogLevel_Detail, nodeId, "  Received: %s", str.c_str() );
 	}
 
-	return true;
+	// Verify checksum
+	uint8 checksum = 0xff;
+	for( uint32 i=1; i<(length-1); ++i )
+	{
+		checksum ^= buffer[i];
+	}
+
+	if( buffer[length-1] == checksum )
+	{
+		// Checksum correct - send ACK
+		uint8 ack = ACK;
+		m_controller->Write( &ack, 1 );
+		m_readCnt++;
+
+		// Process the received message
+		ProcessMsg( &buffer[2] );
+	}
+	else
+	{
+		Log::Write( LogLevel_Warning, nodeId, "WARNING: Checksum incorrect - sending NAK" );
+		m_badChecksum++;
+		uint8 nak = NAK;
+		m_controller->Write( &nak, 1 );
+		m_controller->Purge();
+	}
 }
 
 //-----------------------------------------------------------------------------
@@ -1967,6 +2575,19 @@ void Driver::ProcessMsg
 				handleCallback = false;			// Skip the callback handling - a subsequent FUNC_ID_ZW_SEND_DATA request will deal with that
 				break;
 			}
+			case FUNC_ID_ZW_SEND_DATA_MULTI:
+			{
+				if( HandleSendDataMultiResponse( _data ) )
+				{
+					handleCallback = false;			// Skip the callback handling - a subsequent FUNC_ID_ZW_SEND_DATA_MULTI request will deal with that
+				}
+				else
+				{
+					CompleteMulticast( false );
+					m_expectedCallbackId = 0;		// The callback message won't be coming, so we force the transaction to complete
+				}
+				break;
+			}
 			case FUNC_ID_ZW_GET_VERSION:
 			{
 				Log::Write( LogLevel_Detail, "" );
@@ -2177,6 +2798,11 @@ void Driver::ProcessMsg
 				HandleSendDataRequest( _data, false );
 				break;
 			}
+			case FUNC_ID_ZW_SEND_DATA_MULTI:
+			{
+				HandleSendDataMultiRequest( _data );
+				break;
+			}
 			case FUNC_ID_ZW_REPLICATION_COMMAND_COMPLETE:
 			{
 				if( m_controllerReplication )
@@ -2331,7 +2957,9 @@ void Driver::ProcessMsg
 				{
 					if( m_expectedCommandClassId && ( m_expectedReply == FUNC_ID_APPLICATION_COMMAND_HANDLER ) )
 					{
-						if( m_expectedCallbackId == 0 && m_expectedCommandClassId == _data[5] && m_expectedNodeId == _data[3] )
+						// A node may answer batched requests with one MultiCmd encapsulated frame
+						bool batchReply = ( MultiCmd::StaticGetCommandClassId() == _data[5] ) && m_currentMsg && m_currentMsg->IsMultiCmdEncap();
+						if( m_expectedCallbackId == 0 && ( m_expectedCommandClassId == _data[5] || batchReply ) && m_expectedNodeId == _data[3] )
 						{
 							Log::Write( LogLevel_Detail, _data[3], "  Expected reply and command class was received" );
 							m_waitingForAck = false;
@@ -2958,6 +3586,26 @@ void Driver::HandleSendDataResponse
 	}
 }
 
+//-----------------------------------------------------------------------------
+// <Driver::HandleSendDataMultiResponse>
+// Process a response from the Z-Wave PC interface
+//-----------------------------------------------------------------------------
+bool Driver::HandleSendDataMultiResponse
+(
+		uint8* _data
+)
+{
+	if( _data[2] )
+	{
+		Log::Write( LogLevel_Detail, "  ZW_SEND_DATA_MULTI delivered to Z-Wave stack" );
+		return true;
+	}
+
+	Log::Write( LogLevel_Error, "ERROR: ZW_SEND_DATA_MULTI could not be delivered to Z-Wave stack" );
+	m_nondelivery++;
+	return false;
+}
+
 //-----------------------------------------------------------------------------
 // <Driver::HandleGetRoutingInfoResponse>
 // Process a response from the Z-Wave PC interface
@@ -2995,6 +3643,31 @@ void Driver::HandleGetRoutingInfoResponse
 	}
 }
 
+//-----------------------------------------------------------------------------
+// <Driver::HandleSendDataMultiRequest>
+// Process a request from the Z-Wave PC interface
+//-----------------------------------------------------------------------------
+void Driver::HandleSendDataMultiRequest
+(
+		uint8* _data
+)
+{
+	Log::Write( LogLevel_Detail, "  ZW_SEND_DATA_MULTI Request with callback ID 0x%.2x received (expected 0x%.2x)", _data[2], m_expectedCallbackId );
+	if( _data[2] != m_expectedCallbackId )
+	{
+		// Wrong callback ID
+		m_callbacks++;
+		Log::Write( LogLevel_Warning, "WARNING: Unexpected Callback ID received" );
+		return;
+	}
+
+	if( _data[3] != TRANSMIT_COMPLETE_OK )
+	{
+		Log::Write( LogLevel_Warning, "WARNING: ZW_SEND_DATA_MULTI failed with status 0x%.2x", _data[3] );
+	}
+	CompleteMulticast( _data[3] == TRANSMIT_COMPLETE_OK );
+}
+
 //-----------------------------------------------------------------------------
 // <Driver::HandleSendDataRequest>
 // Process a request from the Z-Wave PC interface
@@ -3035,6 +3708,9 @@ void Driver::HandleSendDataRequest
 					node->m_averageRequestRTT = node->m_lastRequestRTT;
 				}
 				Log::Write(LogLevel_Info, nodeId, "Request RTT %d Average Request RTT %d", node->m_lastRequestRTT, node->m_averageRequestRTT );
+
+				// Each attempt has its own callback ID, so this is always the time taken by the latest one
+				node->UpdateRTT( false, node->m_lastRequestRTT );
 			}
 		}
 
@@ -3538,6 +4214,12 @@ void Driver::HandleApplicationCommandHandlerRequest
 				node->m_averageResponseRTT = node->m_lastResponseRTT;
 			}
 			Log::Write(LogLevel_Info, nodeId, "Response RTT %d Average Response RTT %d", node->m_lastResponseRTT, node->m_averageResponseRTT );
+
+			// If the request was sent more than once, the report could be the answer to any of the attempts
+			if( m_currentMsg != NULL && m_currentMsg->GetSendAttempts() <= 1 )
+			{
+				node->UpdateRTT( true, node->m_lastResponseRTT );
+			}
 		}
 		else
 		{
@@ -3983,6 +4665,24 @@ void Driver::CommonAddNodeStatusRequestHandler
 //	Polling Z-Wave devices
 //-----------------------------------------------------------------------------
 
+//-----------------------------------------------------------------------------
+// <Driver::SetPollInterval>
+// Set the interval used to derive the poll schedule
+//-----------------------------------------------------------------------------
+void Driver::SetPollInterval
+(
+		int32 _milliseconds,
+		bool _bIntervalBetweenPolls
+)
+{
+	LockGuard LG(m_pollMutex);
+	m_pollInterval = _milliseconds;
+	m_bIntervalBetweenPolls = _bIntervalBetweenPolls;
+
+	// Let the poll thread recalculate how long it has to wait
+	m_pollEvent->Set();
+}
+
 //-----------------------------------------------------------------------------
 // <Driver::EnablePoll>
 // Enable polling of a value
@@ -3993,64 +4693,67 @@ bool Driver::EnablePoll
 		uint8 const _intensity
 )
 {
-	// make sure the polling thread doesn't lock the node while we're in this function
-	m_pollMutex->Lock();
-
-	// confirm that this node exists
+	// confirm that this node exists, holding the node lock only while we touch the value
 	uint8 nodeId = _valueId.GetNodeId();
-	LockGuard LG(m_nodeMutex);
-	Node* node = GetNode( nodeId );
-	if( node != NULL )
 	{
-		// confirm that this value is in the node's value store
-		if( Value* value = node->GetValue( _valueId ) )
+		LockGuard LG(m_nodeMutex);
+		Node* node = GetNode( nodeId );
+		if( node == NULL )
 		{
-			// update the value's pollIntensity
-			value->SetPollIntensity( _intensity );
+			Log::Write( LogLevel_Info, "EnablePoll failed - node %d not found", nodeId );
+			return false;
+		}
 
-			// Add the valueid to the polling list
-			// See if the node is already in the poll list.
-			for( list<PollEntry>::iterator it = m_pollList.begin(); it != m_pollList.end(); ++it )
-			{
-				if( (*it).m_id == _valueId )
-				{
-					// It is already in the poll list, so we have nothing to do.
-					Log::Write( LogLevel_Detail, "EnablePoll not required to do anything (value is already in the poll list)" );
-					value->Release();
-					m_pollMutex->Unlock();
-					return true;
-				}
-			}
+		// confirm that this value is in the node's value store
+		Value* value = node->GetValue( _valueId );
+		if( value == NULL )
+		{
+			Log::Write( LogLevel_Info, nodeId, "EnablePoll failed - value not found for node %d", nodeId );
+			return false;
+		}
 
-			// Not in the list, so we add it
-			PollEntry pe;
-			pe.m_id = _valueId;
-			pe.m_pollCounter = value->GetPollIntensity();
-			m_pollList.push_back( pe );
-			value->Release();
-			m_pollMutex->Unlock();
+		// update the value's pollIntensity
+		value->SetPollIntensity( _intensity );
+		value->Release();
+	}
 
-			// send notification to indicate polling is enabled
-			Notification* notification = new Notification( Notification::Type_PollingEnabled );
-			notification->SetHomeAndNodeIds( m_homeId, _valueId.GetNodeId() );
-			QueueNotification( notification );
-			Log::Write( LogLevel_Info, nodeId, "EnablePoll for HomeID 0x%.8x, value(cc=0x%02x,in=0x%02x,id=0x%02x)--poll list has %d items",
-					_valueId.GetHomeId(), _valueId.GetCommandClassId(), _valueId.GetIndex(), _valueId.GetInstance(), m_pollList.size() );
-			return true;
-		}
+	// make sure the polling thread doesn't change the schedule while we're in this function
+	m_pollMutex->Lock();
 
-		// allow the poll thread to continue
+	// See if the value is already being polled.
+	if( m_pollValues.Find( _valueId ) )
+	{
+		// It is already in the poll schedule, so we have nothing to do.
 		m_pollMutex->Unlock();
-
-		Log::Write( LogLevel_Info, nodeId, "EnablePoll failed - value not found for node %d", nodeId );
-		return false;
+		Log::Write( LogLevel_Detail, "EnablePoll not required to do anything (value is already in the poll list)" );
+		return true;
 	}
 
-	// allow the poll thread to continue
+	// Not in the schedule, so we add it and poll it as soon as possible
+	PollState state;
+	state.m_interval = 0;
+	state.m_minInterval = 0;
+	state.m_maxInterval = 0;
+	state.m_generation = 0;
+	state.m_period = 0;
+	state.m_lastPoll = 0;
+	state.m_lastRefresh = 0;
+	state.m_backoff = 0;
+	state.m_pollPending = false;
+	state.m_refreshed = false;
+	state.m_suppressIfRefreshed = m_bSuppressRefreshedPolls;
+	m_pollValues.Insert( _valueId, state );
+	SchedulePoll( _valueId, GetPollTime() );
+	size_t count = m_pollValues.Size();
 	m_pollMutex->Unlock();
 
-	Log::Write( LogLevel_Info, "EnablePoll failed - node %d not found", nodeId );
-	return false;
+	// send notification to indicate polling is enabled
+	Notification* notification = new Notification( Notification::Type_PollingEnabled );
+	notification->SetHomeAndNodeIds( m_homeId, _valueId.GetNodeId() );
+	QueueNotification( notification );
+	Log::Write( LogLevel_Info, nodeId, "EnablePoll for HomeID 0x%.8x, value(cc=0x%02x,in=0x%02x,id=0x%02x)--poll list has %d items",
+			_valueId.GetHomeId(), _valueId.GetCommandClassId(), _valueId.GetIndex(), _valueId.GetInstance(), (int)count );
+	return true;
 }
 
 //-----------------------------------------------------------------------------
@@ -4062,53 +4765,38 @@ bool Driver::DisablePoll
 		ValueID const &_valueId
 )
 {
-	// make sure the polling thread doesn't lock the node while we're in this function
+	// Remove the value from the poll schedule.  Its heap entry is now stale, and
+	// is discarded by the poll thread when it reaches the front of the heap.
 	m_pollMutex->Lock();
+	bool removed = m_pollValues.Erase( _valueId );
+	size_t count = m_pollValues.Size();
+	m_pollMutex->Unlock();
 
-	// confirm that this node exists
 	uint8 nodeId = _valueId.GetNodeId();
-	LockGuard LG(m_nodeMutex);
-	Node* node = GetNode( nodeId );
-	if( node != NULL)
+	if( !removed )
 	{
-		// See if the value is already in the poll list.
-		for( list<PollEntry>::iterator it = m_pollList.begin(); it != m_pollList.end(); ++it )
-		{
-			if( (*it).m_id == _valueId )
-			{
-				// Found it
-				// remove it from the poll list
-				m_pollList.erase( it );
-
-				// get the value object and reset pollIntensity to zero (indicating no polling)
-				Value* value = GetValue( _valueId );
-				if (!value)
-					continue;
-				value->SetPollIntensity( 0 );
-				value->Release();
-				m_pollMutex->Unlock();
-
-				// send notification to indicate polling is disabled
-				Notification* notification = new Notification( Notification::Type_PollingDisabled );
-				notification->SetHomeAndNodeIds( m_homeId, _valueId.GetNodeId() );
-				QueueNotification( notification );
-				Log::Write( LogLevel_Info, nodeId, "DisablePoll for HomeID 0x%.8x, value(cc=0x%02x,in=0x%02x,id=0x%02x)--poll list has %d items",
-						_valueId.GetHomeId(), _valueId.GetCommandClassId(), _valueId.GetIndex(), _valueId.GetInstance(), m_pollList.size() );
-				return true;
-			}
-		}
-
 		// Not in the list
-		m_pollMutex->Unlock();
 		Log::Write( LogLevel_Info, nodeId, "DisablePoll failed - value not on list");
 		return false;
 	}
 
-	// allow the poll thread to continue
-	m_pollMutex->Unlock();
+	// get the value object and reset pollIntensity to zero (indicating no polling)
+	{
+		LockGuard LG(m_nodeMutex);
+		if( Value* value = GetValue( _valueId ) )
+		{
+			value->SetPollIntensity( 0 );
+			value->Release();
+		}
+	}
 
-	Log::Write( LogLevel_Info, "DisablePoll failed - node %d not found", nodeId );
-	return false;
+	// send notification to indicate polling is disabled
+	Notification* notification = new Notification( Notification::Type_PollingDisabled );
+	notification->SetHomeAndNodeIds( m_homeId, _valueId.GetNodeId() );
+	QueueNotification( notification );
+	Log::Write( LogLevel_Info, nodeId, "DisablePoll for HomeID 0x%.8x, value(cc=0x%02x,in=0x%02x,id=0x%02x)--poll list has %d items",
+			_valueId.GetHomeId(), _valueId.GetCommandClassId(), _valueId.GetIndex(), _valueId.GetInstance(), (int)count );
+	return true;
 }
 
 //-----------------------------------------------------------------------------
@@ -4120,93 +4808,425 @@ bool Driver::isPolled
 		ValueID const &_valueId
 )
 {
-	bool bPolled;
+	bool bPolled = false;
+	bool bFound = false;
 
-	// make sure the polling thread doesn't lock the node while we're in this function
-	m_pollMutex->Lock();
-
-	Value* value = GetValue( _valueId );
-	if( value && value->GetPollIntensity() != 0 )
+	uint8 nodeId = _valueId.GetNodeId();
 	{
-		bPolled = true;
+		LockGuard LG(m_nodeMutex);
+		if( GetNode( nodeId ) != NULL )
+		{
+			bFound = true;
+			if( Value* value = GetValue( _valueId ) )
+			{
+				bPolled = ( value->GetPollIntensity() != 0 );
+				value->Release();
+			}
+		}
 	}
-	else
+
+	if( !bFound )
 	{
-		bPolled = false;
+		Log::Write( LogLevel_Info, "isPolled failed - node %d not found", nodeId );
+		return false;
 	}
 
-	if (value) value->Release();
-
 	/*
 	 * This code is retained for the moment as a belt-and-suspenders test to confirm that
-	 * the pollIntensity member of each value and the pollList contents do not get out
+	 * the pollIntensity member of each value and the poll schedule do not get out
 	 * of sync.
 	 */
-	// confirm that this node exists
-	uint8 nodeId = _valueId.GetNodeId();
+	m_pollMutex->Lock();
+	bool bScheduled = ( m_pollValues.Find( _valueId ) != NULL );
+	m_pollMutex->Unlock();
+
+	if( bScheduled != bPolled )
+	{
+		Log::Write( LogLevel_Error, nodeId, "IsPolled setting for valueId 0x%016x is not consistent with the poll list", _valueId.GetId() );
+		return false;
+	}
+	return bPolled;
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::SetPollIntensity>
+// Set the intensity with which this value is polled
+//-----------------------------------------------------------------------------
+void Driver::SetPollIntensity
+(
+		ValueID const &_valueId,
+		uint8 const _intensity
+)
+{
+	// the poll thread reads the intensity under the node lock
 	LockGuard LG(m_nodeMutex);
-	Node* node = GetNode( nodeId );
-	if( node != NULL)
+
+	Value* value = GetValue( _valueId );
+	if (!value)
+		return;
+	value->SetPollIntensity( _intensity );
+
+	value->Release();
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::SetPollInterval>
+// Set the interval between polls of a single value
+//-----------------------------------------------------------------------------
+bool Driver::SetPollInterval
+(
+		ValueID const& _valueId,
+		int32 _milliseconds
+)
+{
+	LockGuard LG(m_pollMutex);
+	PollState* state = m_pollValues.Find( _valueId );
+	if( state == NULL )
 	{
+		Log::Write( LogLevel_Info, _valueId.GetNodeId(), "SetPollInterval failed - value is not polled" );
+		return false;
+	}
 
-		// See if the value is already in the poll list.
-		for( list<PollEntry>::iterator it = m_pollList.begin(); it != m_pollList.end(); ++it )
+	state->m_interval = ( _milliseconds > 0 ) ? _milliseconds : 0;
+	if( state->m_interval > 0 )
+	{
+		// Move the next poll to the new interval
+		state->m_period = state->m_interval;
+		SchedulePoll( _valueId, GetPollTime() + (uint32)state->m_interval );
+	}
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::GetPollInterval>
+// Get the interval between polls of a single value
+//-----------------------------------------------------------------------------
+int32 Driver::GetPollInterval
+(
+		ValueID const& _valueId
+)
+{
+	uint8 intensity = 1;
+	{
+		LockGuard LG(m_nodeMutex);
+		if( Value* value = GetValue( _valueId ) )
 		{
-			if( (*it).m_id == _valueId )
-			{
-				// Found it
-				if( bPolled )
-				{
-					m_pollMutex->Unlock();
-					return true;
-				}
-				else
-				{
-					Log::Write( LogLevel_Error, nodeId, "IsPolled setting for valueId 0x%016x is not consistent with the poll list", _valueId.GetId() );
-				}
-			}
+			intensity = value->GetPollIntensity();
+			value->Release();
 		}
+	}
 
-		// Not in the list
+	LockGuard LG(m_pollMutex);
+	PollState* state = m_pollValues.Find( _valueId );
+	if( state == NULL )
+	{
+		return 0;
+	}
+	return GetPollPeriod( *state, intensity );
+}
 
-		if( !bPolled )
-		{
-			m_pollMutex->Unlock();
-			return false;
-		}
-		else
+//-----------------------------------------------------------------------------
+// <Driver::SetPollIntervalBounds>
+// Limit how far adaptive polling can change the interval of a value
+//-----------------------------------------------------------------------------
+bool Driver::SetPollIntervalBounds
+(
+		ValueID const& _valueId,
+		int32 _minMilliseconds,
+		int32 _maxMilliseconds
+)
+{
+	LockGuard LG(m_pollMutex);
+	PollState* state = m_pollValues.Find( _valueId );
+	if( state == NULL )
+	{
+		Log::Write( LogLevel_Info, _valueId.GetNodeId(), "SetPollIntervalBounds failed - value is not polled" );
+		return false;
+	}
+
+	state->m_minInterval = ( _minMilliseconds > 0 ) ? _minMilliseconds : 0;
+	state->m_maxInterval = ( _maxMilliseconds > 0 ) ? _maxMilliseconds : 0;
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::SetPollSuppression>
+// Choose whether a report of a value stands in for its next poll
+//-----------------------------------------------------------------------------
+bool Driver::SetPollSuppression
+(
+		ValueID const& _valueId,
+		bool _suppress
+)
+{
+	LockGuard LG(m_pollMutex);
+	PollState* state = m_pollValues.Find( _valueId );
+	if( state == NULL )
+	{
+		Log::Write( LogLevel_Info, _valueId.GetNodeId(), "SetPollSuppression failed - value is not polled" );
+		return false;
+	}
+
+	state->m_suppressIfRefreshed = _suppress;
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::OnPolledValueRefreshed>
+// Note refreshes that can stand in for a poll, and with adaptive polling, lengthen
+// the poll interval of a value that isn't changing, or reset it when it does
+//-----------------------------------------------------------------------------
+void Driver::OnPolledValueRefreshed
+(
+		ValueID const& _valueId,
+		uint8 const _intensity,
+		bool const _changed
+)
+{
+	LockGuard LG(m_pollMutex);
+	PollState* state = m_pollValues.Find( _valueId );
+	if( state == NULL )
+	{
+		return;
+	}
+
+	bool pollAnswer = state->m_pollPending;
+	state->m_pollPending = false;
+	if( !pollAnswer )
+	{
+		// An unsolicited report, which the poll thread can use in place of the next poll
+		state->m_refreshed = true;
+		state->m_lastRefresh = GetPollTime();
+	}
+
+	if( !m_bAdaptivePolling )
+	{
+		return;
+	}
+
+	uint8 backoff = state->m_backoff;
+	if( _changed )
+	{
+		backoff = 0;
+	}
+	else if( pollAnswer )
+	{
+		// Only back off on the answer to a poll, and stop once the interval is at its limit
+		PollState next = *state;
+		next.m_backoff = backoff + 1;
+		if( backoff < 31 && GetPollPeriod( next, _intensity ) > GetPollPeriod( *state, _intensity ) )
 		{
-			Log::Write( LogLevel_Error, nodeId, "IsPolled setting for valueId 0x%016x is not consistent with the poll list", _valueId.GetId() );
+			backoff = next.m_backoff;
 		}
 	}
 
-	// allow the poll thread to continue
-	m_pollMutex->Unlock();
+	if( backoff == state->m_backoff )
+	{
+		return;
+	}
 
-	Log::Write( LogLevel_Info, "isPolled failed - node %d not found (the value reported that it is%s polled)", nodeId, bPolled?"":" not" );
-	return false;
+	state->m_backoff = backoff;
+	int32 period = GetPollPeriod( *state, _intensity );
+	state->m_period = period;
+	Log::Write( LogLevel_Detail, _valueId.GetNodeId(), "Adaptive polling: value(cc=0x%02x,in=0x%02x,id=0x%02x) %s, now polled every %d ms",
+			_valueId.GetCommandClassId(), _valueId.GetIndex(), _valueId.GetInstance(), _changed ? "changed" : "unchanged", period );
+
+	if( _changed )
+	{
+		// Go straight back to the short interval, counting from the fresh value we just received
+		SchedulePoll( _valueId, GetPollTime() + (uint32)period );
+	}
+	else
+	{
+		SchedulePoll( _valueId, state->m_lastPoll + (uint32)period );
+	}
 }
 
 //-----------------------------------------------------------------------------
-// <Driver::SetPollIntensity>
-// Set the intensity with which this value is polled
+// <Driver::GetPollTime>
+// Milliseconds since the driver was created, used to order the poll schedule
 //-----------------------------------------------------------------------------
-void Driver::SetPollIntensity
+uint32 Driver::GetPollTime
 (
-		ValueID const &_valueId,
-		uint8 const _intensity
 )
 {
-	// make sure the polling thread doesn't lock the value while we're in this function
-	m_pollMutex->Lock();
+	// The result wraps after 49 days, so callers compare poll times by their
+	// signed difference.
+	return (uint32)( -m_pollEpoch.TimeRemaining() );
+}
 
-	Value* value = GetValue( _valueId );
-	if (!value)
+//-----------------------------------------------------------------------------
+// <Driver::GetValuePollInterval>
+// Work out how long to wait between polls of a value
+//-----------------------------------------------------------------------------
+int32 Driver::GetValuePollInterval
+(
+		int32 _interval,
+		uint8 _intensity
+)
+{
+	if( _interval > 0 )
+	{
+		// The application asked for a specific interval
+		return _interval;
+	}
+
+	// Otherwise each value is polled once per pass through all the polled values,
+	// or once every _intensity passes.
+	int32 interval = m_pollInterval;
+	if( m_bIntervalBetweenPolls )
+	{
+		interval *= (int32)m_pollValues.Size();
+	}
+	else if( interval < 100 )
+	{
+		// Legacy setting in seconds
+		interval *= 1000;
+	}
+	if( _intensity > 1 )
+	{
+		interval *= _intensity;
+	}
+	return( interval > 0 ? interval : 0 );
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::GetPollPeriod>
+// Work out how long to wait between polls of a value, allowing for adaptive polling
+//-----------------------------------------------------------------------------
+int32 Driver::GetPollPeriod
+(
+		PollState const& _state,
+		uint8 _intensity
+)
+{
+	int32 period = GetValuePollInterval( _state.m_interval, _intensity );
+	if( !m_bAdaptivePolling )
+	{
+		return period;
+	}
+
+	// Double the interval for each poll in a row that found the value unchanged
+	int32 maxPeriod = _state.m_maxInterval;
+	if( maxPeriod == 0 )
+	{
+		maxPeriod = ( period < ( 0x7fffffff >> c_maxPollBackoff ) ) ? ( period << c_maxPollBackoff ) : 0x7fffffff;
+	}
+	for( uint8 i = 0; i < _state.m_backoff && period < maxPeriod; ++i )
+	{
+		period = ( period < ( maxPeriod >> 1 ) ) ? ( period << 1 ) : maxPeriod;
+	}
+
+	if( period < _state.m_minInterval )
+	{
+		period = _state.m_minInterval;
+	}
+	if( _state.m_maxInterval > 0 && period > _state.m_maxInterval )
+	{
+		period = _state.m_maxInterval;
+	}
+	return period;
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::GetPollSpacing>
+// The minimum time between the end of one poll and the start of the next
+//-----------------------------------------------------------------------------
+int32 Driver::GetPollSpacing
+(
+)
+{
+	if( m_bIntervalBetweenPolls )
+	{
+		return m_pollInterval;
+	}
+
+	// Spread the polls evenly across the poll interval, so that values
+	// that fall due together don't all hit the network at once.
+	if( m_pollValues.Size() == 0 )
+	{
+		return 0;
+	}
+	return( GetValuePollInterval( 0, 1 ) / (int32)m_pollValues.Size() );
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::SchedulePoll>
+// Add an entry for a value to the poll heap.  Called with m_pollMutex held.
+//-----------------------------------------------------------------------------
+void Driver::SchedulePoll
+(
+		ValueID const& _valueId,
+		uint32 _due
+)
+{
+	PollState* state = m_pollValues.Find( _valueId );
+	if( state == NULL )
+	{
 		return;
-	value->SetPollIntensity( _intensity );
+	}
 
-	value->Release();
-	m_pollMutex->Unlock();
+	// Any entry the value already has in the heap becomes stale
+	state->m_generation = ++m_pollGeneration;
+
+	// Stale entries are normally discarded as they reach the front of the heap.
+	// If values are rescheduled faster than that, rebuild the heap without them.
+	if( m_pollHeap.size() > 2 * m_pollValues.Size() + 16 )
+	{
+		vector<PollEntry> live;
+		for( vector<PollEntry>::iterator it = m_pollHeap.begin(); it != m_pollHeap.end(); ++it )
+		{
+			if( IsLivePollEntry( *it ) )
+			{
+				live.push_back( *it );
+			}
+		}
+		m_pollHeap.swap( live );
+		make_heap( m_pollHeap.begin(), m_pollHeap.end(), PollEntryCompare() );
+	}
+
+	PollEntry pe;
+	pe.m_id = _valueId;
+	pe.m_due = _due;
+	pe.m_generation = state->m_generation;
+	m_pollHeap.push_back( pe );
+	push_heap( m_pollHeap.begin(), m_pollHeap.end(), PollEntryCompare() );
+
+	// Wake the poll thread in case this value is now the first one due
+	m_pollEvent->Set();
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::IsLivePollEntry>
+// Check that a heap entry is the current one for its value
+//-----------------------------------------------------------------------------
+bool Driver::IsLivePollEntry
+(
+		PollEntry const& _entry
+)
+{
+	PollState* state = m_pollValues.Find( _entry.m_id );
+	return( state != NULL && state->m_generation == _entry.m_generation );
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::IsSendQueueIdle>
+// Check whether the library has stopped sending messages
+//-----------------------------------------------------------------------------
+bool Driver::IsSendQueueIdle
+(
+)
+{
+	// Only the queues that carry device traffic are tested.  The security, NoOp,
+	// controller and wake-up queues are served ahead of the poll queue anyway, and
+	// a controller command such as inclusion could otherwise hold polling back for
+	// as long as it runs.
+	LockGuard LG(m_sendMutex);
+	return( m_currentMsg == NULL
+			&& m_msgQueue[MsgQueue_Poll].empty()
+			&& m_msgQueue[MsgQueue_Send].empty()
+			&& m_msgQueue[MsgQueue_Command].empty()
+			&& m_msgQueue[MsgQueue_Query].empty() );
 }
 
 //-----------------------------------------------------------------------------
@@ -4235,58 +5255,108 @@ void Driver::PollThreadProc
 		Event* _exitEvent
 )
 {
+	Wait* waitObjects[2];
+	waitObjects[0] = _exitEvent;			// Thread must exit.
+	waitObjects[1] = m_pollEvent;			// The poll schedule has changed.
+
+	Wait* drainObjects[2];
+	drainObjects[0] = _exitEvent;			// Thread must exit.
+	drainObjects[1] = m_queueDrainedEvent;	// The driver thread has nothing left to send.
+
+	uint32 lastPollTime = 0;
+	bool polled = false;
+
 	while( 1 )
 	{
-		int32 pollInterval = m_pollInterval;
+		int32 timeout = 500;
+		bool pollDue = false;
+		bool pollSuppressed = false;
+		PollEntry pe;
 
-		if( m_awakeNodesQueried && !m_pollList.empty() )
+		// Don't poll until the awake nodes have been fully queried
+		if( m_awakeNodesQueried )
 		{
-			// We only bother getting the lock if the pollList is not empty
-			m_pollMutex->Lock();
+			LockGuard LG(m_pollMutex);
+			m_pollEvent->Reset();
 
-			// Get the next value to be polled
-			PollEntry pe = m_pollList.front();
-			m_pollList.pop_front();
-			ValueID  valueId = pe.m_id;
-
-			// only execute this poll if pe.m_pollCounter == 1; otherwise decrement the counter and process the next polled value
-			if( pe.m_pollCounter != 1)
+			// Discard entries belonging to values that have since been disabled or rescheduled
+			while( !m_pollHeap.empty() && !IsLivePollEntry( m_pollHeap.front() ) )
 			{
-				pe.m_pollCounter--;
-				m_pollList.push_back( pe );
-				m_pollMutex->Unlock();
-				continue;
+				pop_heap( m_pollHeap.begin(), m_pollHeap.end(), PollEntryCompare() );
+				m_pollHeap.pop_back();
 			}
 
-			// reset the poll counter to the full pollIntensity value and push it at the end of the list
-			// release the value object referenced; call GetNode to ensure the node objects are locked during this period
+			if( m_pollHeap.empty() )
 			{
-				LockGuard LG(m_nodeMutex);
-				(void)GetNode( valueId.GetNodeId() );
-				Value* value = GetValue( valueId );
-				if (!value)
-					continue;
-				pe.m_pollCounter = value->GetPollIntensity();
-				m_pollList.push_back( pe );
-				value->Release();
+				// Nothing to do until a value is added to the schedule
+				timeout = Wait::Timeout_Infinite;
 			}
-			// If the polling interval is for the whole poll list, calculate the time before the next poll,
-			// so that all polls can take place within the user-specified interval.
-			if( !m_bIntervalBetweenPolls )
+			else
 			{
-				if( pollInterval < 100 )
+				uint32 now = GetPollTime();
+				int32 remaining = (int32)( m_pollHeap.front().m_due - now );
+				if( polled )
 				{
-					Log::Write( LogLevel_Info, "The pollInterval setting is only %d, which appears to be a legacy setting.  Multiplying by 1000 to convert to ms.", pollInterval );
-					pollInterval *= 1000;
+					int32 spacing = (int32)( lastPollTime + (uint32)GetPollSpacing() - now );
+					if( spacing > remaining )
+					{
+						remaining = spacing;
+					}
+				}
+
+				if( remaining > 0 )
+				{
+					timeout = remaining;
+				}
+				else
+				{
+					// Take the value off the heap.  It is rescheduled once we know its intensity.
+					pe = m_pollHeap.front();
+					pop_heap( m_pollHeap.begin(), m_pollHeap.end(), PollEntryCompare() );
+					m_pollHeap.pop_back();
+					pollDue = true;
+
+					PollState* state = m_pollValues.Find( pe.m_id );
+					if( state->m_suppressIfRefreshed && state->m_refreshed && state->m_period > 0 )
+					{
+						// The device has reported the value since it was last polled, which is as
+						// good as a poll, so count the interval from that report instead.
+						state->m_refreshed = false;
+						SchedulePoll( pe.m_id, state->m_lastRefresh + (uint32)state->m_period );
+						pollDue = false;
+						pollSuppressed = true;
+						timeout = 0;
+					}
 				}
-				pollInterval /= (int32) m_pollList.size();
 			}
+		}
 
+		if( pollSuppressed )
+		{
+			LockGuard LG(m_nodeMutex);
+			if( Node* node = GetNode( pe.m_id.GetNodeId() ) )
+			{
+				node->m_suppressedPolls++;
+				Log::Write( LogLevel_Detail, node->m_nodeId, "Polling: skipped value(cc=0x%02x,in=0x%02x,id=0x%02x), which the device has reported since the last poll",
+						pe.m_id.GetCommandClassId(), pe.m_id.GetIndex(), pe.m_id.GetInstance() );
+			}
+		}
+
+		if( pollDue )
+		{
+			ValueID valueId = pe.m_id;
+			bool found = false;
+			uint8 intensity = 1;
 			{
 				LockGuard LG(m_nodeMutex);
 				// Request the state of the value from the node to which it belongs
-				if( Node* node = GetNode( valueId.GetNodeId() ) )
+				Node* node = GetNode( valueId.GetNodeId() );
+				Value* value = GetValue( valueId );
+				if( node && value )
 				{
+					found = true;
+					intensity = value->GetPollIntensity();
+
 					bool requestState = true;
 					if( !node->IsListeningDevice() )
 					{
@@ -4309,62 +5379,84 @@ void Driver::PollThreadProc
 						if (cc) {
 							uint8 index = valueId.GetIndex();
 							uint8 instance = valueId.GetInstance();
-							Log::Write( LogLevel_Detail, node->m_nodeId, "Polling: %s index = %d instance = %d (poll queue has %d messages)", cc->GetCommandClassName().c_str(), index, instance, m_msgQueue[MsgQueue_Poll].size() );
+							if( Log::IsLevelEnabled( LogLevel_Detail ) )
+							{
+								Log::Write( LogLevel_Detail, node->m_nodeId, "Polling: %s index = %d instance = %d (poll queue has %d messages)", cc->GetCommandClassName().c_str(), index, instance, m_msgQueue[MsgQueue_Poll].size() );
+							}
 							cc->RequestValue( 0, index, instance, MsgQueue_Poll );
 						}
 					}
-
+				}
+				if( value )
+				{
+					value->Release();
 				}
 			}
 
-			m_pollMutex->Unlock();
-
-			// Polling messages are only sent when there are no other messages waiting to be sent
-			// While this makes the polls much more variable and uncertain if some other activity dominates
-			// a send queue, that may be appropriate
-			// TODO we can have a debate about whether to test all four queues or just the Poll queue
-			// Wait until the library isn't actively sending messages (or in the midst of a transaction)
-			int i32;
-			int loopCount = 0;
-			while( !m_msgQueue[MsgQueue_Poll].empty()
-					|| !m_msgQueue[MsgQueue_Send].empty()
-					|| !m_msgQueue[MsgQueue_Command].empty()
-					|| !m_msgQueue[MsgQueue_Query].empty()
-					|| m_currentMsg != NULL )
+			// Schedule the next poll, unless the value was disabled or rescheduled in the meantime
+			LockGuard LG(m_pollMutex);
+			if( IsLivePollEntry( pe ) )
 			{
-				i32 = Wait::Single( _exitEvent, 10);		// test conditions every 10ms
-				if( i32 == 0 )
+				if( found )
 				{
-					// Exit has been called
-					return;
+					PollState* state = m_pollValues.Find( valueId );
+					state->m_period = GetPollPeriod( *state, intensity );
+					state->m_lastPoll = GetPollTime();
+					state->m_pollPending = true;
+					state->m_refreshed = false;
+					SchedulePoll( valueId, state->m_lastPoll + (uint32)state->m_period );
 				}
-				loopCount++;
-				if( loopCount == 3000*10 )		// 300 seconds worth of delay?  Something unusual is going on
+				else
 				{
-					Log::Write( LogLevel_Warning, "Poll queue hasn't been able to execute for 300 secs or more" );
-					Log::QueueDump();
-					//					assert( 0 );
+					// The value has gone away without being disabled
+					m_pollValues.Erase( valueId );
+					pollDue = false;
+					timeout = 0;
 				}
 			}
+		}
 
-			// ready for next poll...insert the pollInterval delay
-			i32 = Wait::Single( _exitEvent, pollInterval );
-			if( i32 == 0 )
+		if( !pollDue )
+		{
+			// Sleep until the next value is due, the schedule changes or we are told to exit
+			if( Wait::Multiple( waitObjects, 2, timeout ) == 0 )
 			{
 				// Exit has been called
 				return;
 			}
+			continue;
 		}
-		else		// poll list is empty or awake nodes haven't been fully queried yet
+
+		// Polling messages are only sent when there are no other messages waiting to be sent
+		// While this makes the polls much more variable and uncertain if some other activity dominates
+		// a send queue, that may be appropriate
+		// Wait until the library isn't actively sending messages (or in the midst of a transaction).
+		// The driver thread signals m_queueDrainedEvent each time it runs out of work.
+		while( 1 )
 		{
-			// don't poll just yet, wait for the pollInterval or exit before re-checking to see if the pollList has elements
-			int32 i32 = Wait::Single( _exitEvent, 500 );
-			if( i32 == 0 )
+			m_queueDrainedEvent->Reset();
+			if( IsSendQueueIdle() )
+			{
+				break;
+			}
+
+			int32 res = Wait::Multiple( drainObjects, 2, 300*1000 );
+			if( res == 0 )
 			{
 				// Exit has been called
 				return;
 			}
+			if( res < 0 )
+			{
+				// 300 seconds worth of delay?  Something unusual is going on
+				Log::Write( LogLevel_Warning, "Poll queue hasn't been able to execute for 300 secs or more" );
+				Log::QueueDump();
+			}
 		}
+
+		// The spacing before the next poll runs from the end of this one
+		lastPollTime = GetPollTime();
+		polled = true;
 	}
 }
 
@@ -5081,6 +6173,15 @@ Value* Driver::GetValue
 {
 
 	// This method is only called by code that has already locked the node
+	if( Value** value = m_valueIndex.Find( _id ) )
+	{
+		// The caller must call Release on the value when they are done with it
+		(*value)->AddRef();
+		return *value;
+	}
+
+	// The index only matches the whole ValueID, while the node's value store
+	// ignores the genre and type, so try there before giving up.
 	if( Node* node = m_nodes[_id.GetNodeId()] )
 	{
 		return node->GetValue( _id );
@@ -5185,8 +6286,7 @@ bool Driver::BeginControllerCommand
 	item.m_cci = cci;
 
 	m_sendMutex->Lock();
-	m_msgQueue[MsgQueue_Controller].push_back( item );
-	m_queueEvent[MsgQueue_Controller]->Set();
+	PushQueueItem( MsgQueue_Controller, item );
 	m_sendMutex->Unlock();
 
 	return true;
@@ -5730,17 +6830,27 @@ void Driver::SwitchAllOn
 {
 	SwitchAll::On( this, 0xff );
 
+	// Nodes that are awake and do not need the command encrypted share one multicast
+	vector<uint8> nodeIds;
 	LockGuard LG(m_nodeMutex);
 	for( int i=0; i<256; ++i )
 	{
 		if( GetNodeUnsafe( i ) )
 		{
-			if( m_nodes[i]->GetCommandClass( SwitchAll::StaticGetCommandClassId() ) )
+			if( CommandClass* cc = m_nodes[i]->GetCommandClass( SwitchAll::StaticGetCommandClassId() ) )
 			{
-				SwitchAll::On( this, (uint8)i );
+				if( m_nodes[i]->IsListeningDevice() && m_nodes[i]->IsNodeAlive() && !cc->IsSecured() )
+				{
+					nodeIds.push_back( (uint8)i );
+				}
+				else
+				{
+					SwitchAll::On( this, (uint8)i );
+				}
 			}
 		}
 	}
+	SwitchAll::On( this, nodeIds );
 }
 
 //-----------------------------------------------------------------------------
@@ -5753,16 +6863,411 @@ void Driver::SwitchAllOff
 {
 	SwitchAll::Off( this, 0xff );
 
+	// Nodes that are awake and do not need the command encrypted share one multicast
+	vector<uint8> nodeIds;
 	LockGuard LG(m_nodeMutex);
 	for( int i=0; i<256; ++i )
 	{
 		if( GetNodeUnsafe( i ) )
 		{
-			if( m_nodes[i]->GetCommandClass( SwitchAll::StaticGetCommandClassId() ) )
+			if( CommandClass* cc = m_nodes[i]->GetCommandClass( SwitchAll::StaticGetCommandClassId() ) )
+			{
+				if( m_nodes[i]->IsListeningDevice() && m_nodes[i]->IsNodeAlive() && !cc->IsSecured() )
+				{
+					nodeIds.push_back( (uint8)i );
+				}
+				else
+				{
+					SwitchAll::Off( this, (uint8)i );
+				}
+			}
+		}
+	}
+	SwitchAll::Off( this, nodeIds );
+}
+
+//-----------------------------------------------------------------------------
+//	Multicast
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// <Driver::SetValuesMulticast>
+// Set a bool or byte value on several nodes, multicasting wherever possible
+//-----------------------------------------------------------------------------
+bool Driver::SetValuesMulticast
+(
+		vector<ValueID> const& _valueIds,
+		uint8 const _value
+)
+{
+	bool res = true;
+	vector<uint8> nodeIds;
+	vector<ValueID> multicastIds;
+	vector<ValueID> unicastIds;
+	uint8 command[c_maxMulticastCommand];
+	uint8 length = 0;
+
+	{
+		LockGuard LG(m_nodeMutex);
+		for( vector<ValueID>::const_iterator it = _valueIds.begin(); it != _valueIds.end(); ++it )
+		{
+			Node* node = GetNode( it->GetNodeId() );
+			Value* value = GetValue( *it );
+			if( node == NULL || value == NULL || value->IsReadOnly() || it->GetNodeId() == m_Controller_nodeId )
+			{
+				Log::Write( LogLevel_Warning, it->GetNodeId(), "WARNING: Cannot set value with index %d", it->GetIndex() );
+				if( value != NULL )
+				{
+					value->Release();
+				}
+				res = false;
+				continue;
+			}
+			value->Release();
+
+			// Only nodes that are awake and would take the plain command can share the
+			// transmission.  Encrypted and multi channel commands have to go to each node.
+			uint8 nodeCommand[c_maxMulticastCommand];
+			uint8 nodeLength = 0;
+			CommandClass* cc = node->GetCommandClass( it->GetCommandClassId() );
+			if( cc != NULL && node->IsListeningDevice() && node->IsNodeAlive() && !cc->IsSecured()
+					&& it->GetInstance() == 1 && cc->GetEndPoint( 1 ) == 0
+					&& find( nodeIds.begin(), nodeIds.end(), it->GetNodeId() ) == nodeIds.end() )
+			{
+				nodeLength = cc->GetMulticastSet( it->GetIndex(), _value, nodeCommand );
+			}
+
+			if( nodeLength != 0 && ( length == 0 || ( nodeLength == length && !memcmp( nodeCommand, command, length ) ) ) )
+			{
+				memcpy( command, nodeCommand, nodeLength );
+				length = nodeLength;
+				nodeIds.push_back( it->GetNodeId() );
+				multicastIds.push_back( *it );
+			}
+			else
+			{
+				unicastIds.push_back( *it );
+			}
+		}
+	}
+
+	if( nodeIds.size() < 2 )
+	{
+		unicastIds.insert( unicastIds.end(), multicastIds.begin(), multicastIds.end() );
+	}
+	else
+	{
+		SendMulticast( nodeIds, multicastIds, _value, command, length );
+	}
+
+	// Everything else is set one node at a time, as Manager::SetValue would
+	for( vector<ValueID>::iterator it = unicastIds.begin(); it != unicastIds.end(); ++it )
+	{
+		LockGuard LG(m_nodeMutex);
+		if( Value* value = GetValue( *it ) )
+		{
+			if( ValueID::ValueType_Bool == it->GetType() )
+			{
+				res = static_cast<ValueBool*>( value )->Set( _value != 0 ) && res;
+			}
+			else
+			{
+				res = static_cast<ValueByte*>( value )->Set( _value ) && res;
+			}
+			value->Release();
+		}
+	}
+
+	return res;
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::SendMulticast>
+// Send the same command to several nodes in one transmission
+//-----------------------------------------------------------------------------
+void Driver::SendMulticast
+(
+		vector<uint8> const& _nodeIds,
+		vector<ValueID> const& _valueIds,
+		uint8 const _value,
+		uint8 const* _command,
+		uint8 const _length
+)
+{
+	if( _length == 0 || _length > c_maxMulticastCommand )
+	{
+		return;
+	}
+
+	if( _nodeIds.size() < 2 )
+	{
+		// Nothing to be gained from a multicast
+		for( size_t i=0; i<_nodeIds.size(); ++i )
+		{
+			SendUnicastCommand( _nodeIds[i], _command, _length );
+			if( i < _valueIds.size() )
+			{
+				RequestValue( _valueIds[i] );
+			}
+		}
+		return;
+	}
+
+	for( size_t start=0; start<_nodeIds.size(); start+=c_maxMulticastNodes )
+	{
+		size_t end = start + c_maxMulticastNodes;
+		if( end > _nodeIds.size() )
+		{
+			end = _nodeIds.size();
+		}
+
+		MulticastGroup group;
+		group.m_nodeIds.assign( _nodeIds.begin()+start, _nodeIds.begin()+end );
+		if( end <= _valueIds.size() )
+		{
+			group.m_valueIds.assign( _valueIds.begin()+start, _valueIds.begin()+end );
+		}
+		group.m_value = _value;
+		memcpy( group.m_command, _command, _length );
+		group.m_length = _length;
+
+		Msg* msg = new Msg( "ZW_SEND_DATA_MULTI", 0xff, REQUEST, FUNC_ID_ZW_SEND_DATA_MULTI, true );
+		msg->Append( (uint8)group.m_nodeIds.size() );
+		for( vector<uint8>::iterator it = group.m_nodeIds.begin(); it != group.m_nodeIds.end(); ++it )
+		{
+			msg->Append( *it );
+		}
+		msg->Append( _length );
+		for( uint8 i=0; i<_length; ++i )
+		{
+			msg->Append( _command[i] );
+		}
+		msg->Append( GetTransmitOptions() );
+		group.m_msg = msg;
+
+		uint32 now = GetPollTime();
+		m_sendMutex->Lock();
+		// Forget the targets of earlier multicasts that no report ever confirmed
+		map<ValueID,MulticastTarget>::iterator tit = m_multicastTargets.begin();
+		while( tit != m_multicastTargets.end() )
+		{
+			if( (int32)( now - tit->second.m_expiry ) >= 0 )
+			{
+				m_multicastTargets.erase( tit++ );
+			}
+			else
+			{
+				++tit;
+			}
+		}
+		for( vector<ValueID>::iterator it = group.m_valueIds.begin(); it != group.m_valueIds.end(); ++it )
+		{
+			MulticastTarget& target = m_multicastTargets[*it];
+			target.m_value = _value;
+			target.m_sent = false;
+			target.m_expiry = now + c_multicastTargetTimeout;
+			memcpy( target.m_command, _command, _length );
+			target.m_length = _length;
+		}
+		m_multicastGroups.push_back( group );
+		m_sendMutex->Unlock();
+
+		Log::Write( LogLevel_Info, "Multicasting command 0x%.2x 0x%.2x to %d nodes", _command[0], _length > 1 ? _command[1] : 0, (int)group.m_nodeIds.size() );
+		SendMsg( msg, MsgQueue_Send );
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::SendUnicastCommand>
+// Send a multicast command to just one node
+//-----------------------------------------------------------------------------
+void Driver::SendUnicastCommand
+(
+		uint8 const _nodeId,
+		uint8 const* _command,
+		uint8 const _length
+)
+{
+	Msg* msg = new Msg( "Multicast command sent directly", _nodeId, REQUEST, FUNC_ID_ZW_SEND_DATA, true );
+	msg->Append( _nodeId );
+	msg->Append( _length );
+	for( uint8 i=0; i<_length; ++i )
+	{
+		msg->Append( _command[i] );
+	}
+	msg->Append( GetTransmitOptions() );
+	SendMsg( msg, MsgQueue_Send );
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::RequestValue>
+// Queue a Get to read back a value that was set
+//-----------------------------------------------------------------------------
+void Driver::RequestValue
+(
+		ValueID const& _valueId
+)
+{
+	LockGuard LG(m_nodeMutex);
+	if( Node* node = GetNode( _valueId.GetNodeId() ) )
+	{
+		if( CommandClass* cc = node->GetCommandClass( _valueId.GetCommandClassId() ) )
+		{
+			cc->RequestValue( 0, _valueId.GetIndex(), _valueId.GetInstance(), MsgQueue_Send );
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::CompleteMulticast>
+// The controller has finished with the current multicast message.  Read back
+// the values no node has confirmed yet, or if the transmission failed, send
+// the command to each node individually.
+//-----------------------------------------------------------------------------
+void Driver::CompleteMulticast
+(
+		bool const _delivered
+)
+{
+	MulticastGroup group;
+	vector<uint8> unicastNodeIds;
+	vector<ValueID> requestIds;
+	{
+		LockGuard LG(m_sendMutex);
+		list<MulticastGroup>::iterator it = m_multicastGroups.begin();
+		while( it != m_multicastGroups.end() && it->m_msg != m_currentMsg )
+		{
+			++it;
+		}
+		if( it == m_multicastGroups.end() )
+		{
+			return;
+		}
+		group = *it;
+		m_multicastGroups.erase( it );
+
+		for( size_t i=0; i<group.m_nodeIds.size(); ++i )
+		{
+			if( i >= group.m_valueIds.size() )
+			{
+				// Nothing to read back, so a node can only be retried on failure
+				if( !_delivered )
+				{
+					unicastNodeIds.push_back( group.m_nodeIds[i] );
+				}
+				continue;
+			}
+
+			map<ValueID,MulticastTarget>::iterator target = m_multicastTargets.find( group.m_valueIds[i] );
+			if( target == m_multicastTargets.end() || target->second.m_value != group.m_value )
+			{
+				// Already confirmed by a report, or superseded by a later multicast
+				continue;
+			}
+
+			if( _delivered )
+			{
+				target->second.m_sent = true;
+				target->second.m_expiry = GetPollTime() + c_multicastTargetTimeout;
+			}
+			else
+			{
+				unicastNodeIds.push_back( group.m_nodeIds[i] );
+				m_multicastTargets.erase( target );
+			}
+			requestIds.push_back( group.m_valueIds[i] );
+		}
+	}
+
+	if( _delivered )
+	{
+		Log::Write( LogLevel_Info, "Multicast to %d nodes complete, %d value(s) still to be confirmed", (int)group.m_nodeIds.size(), (int)requestIds.size() );
+	}
+	else
+	{
+		Log::Write( LogLevel_Warning, "WARNING: Multicast to %d nodes failed, sending to %d node(s) directly", (int)group.m_nodeIds.size(), (int)unicastNodeIds.size() );
+	}
+
+	for( vector<uint8>::iterator it = unicastNodeIds.begin(); it != unicastNodeIds.end(); ++it )
+	{
+		SendUnicastCommand( *it, group.m_command, group.m_length );
+	}
+	for( vector<ValueID>::iterator it = requestIds.begin(); it != requestIds.end(); ++it )
+	{
+		RequestValue( *it );
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::OnMulticastValueReport>
+// A node has reported a value.  If it was set by multicast, either the set is
+// confirmed or the node missed it and the command is sent to it directly.
+//-----------------------------------------------------------------------------
+void Driver::OnMulticastValueReport
+(
+		ValueID const& _valueId,
+		uint8 const _value
+)
+{
+	uint8 command[c_maxMulticastCommand];
+	uint8 length = 0;
+	{
+		LockGuard LG(m_sendMutex);
+		if( m_multicastTargets.empty() )
+		{
+			return;
+		}
+
+		map<ValueID,MulticastTarget>::iterator it = m_multicastTargets.find( _valueId );
+		if( it == m_multicastTargets.end() )
+		{
+			return;
+		}
+
+		if( (int32)( GetPollTime() - it->second.m_expiry ) >= 0 )
+		{
+			// The read-back never arrived.  Repeating the Set now could undo a
+			// change made since, so give up on it.
+			m_multicastTargets.erase( it );
+			return;
+		}
+
+		// A Set of 0xff asks for "on", at whatever level the device chooses
+		MulticastTarget const& target = it->second;
+		if( _value != target.m_value && !( target.m_value == 0xff && _value != 0 ) )
+		{
+			if( !target.m_sent )
 			{
-				SwitchAll::Off( this, (uint8)i );
+				// This report may have been sent before the multicast arrived
+				return;
 			}
+			memcpy( command, target.m_command, target.m_length );
+			length = target.m_length;
 		}
+		m_multicastTargets.erase( it );
+	}
+
+	if( length != 0 )
+	{
+		Log::Write( LogLevel_Warning, _valueId.GetNodeId(), "WARNING: Node missed a multicast command, sending it directly" );
+		SendUnicastCommand( _valueId.GetNodeId(), command, length );
+		RequestValue( _valueId );
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::CancelMulticastTarget>
+// A value is being set again, so stop checking it against an earlier multicast
+//-----------------------------------------------------------------------------
+void Driver::CancelMulticastTarget
+(
+		ValueID const& _valueId
+)
+{
+	LockGuard LG(m_sendMutex);
+	if( !m_multicastTargets.empty() )
+	{
+		m_multicastTargets.erase( _valueId );
 	}
 }
 
@@ -5988,7 +7493,10 @@ void Driver::NotifyWatchers
 				break;
 		}
 
-		Log::Write(LogLevel_Detail, notification->GetNodeId(), "Notification: %s", notification->GetAsString().c_str());
+		if( Log::IsLevelEnabled( LogLevel_Detail ) )
+		{
+			Log::Write(LogLevel_Detail, notification->GetNodeId(), "Notification: %s", notification->GetAsString().c_str());
+		}
 
 		Manager::Get()->NotifyWatchers( notification );
 
@@ -6160,10 +7668,8 @@ void Driver::SendVirtualNodeInfo
 		uint8 const _ToNodeId
 )
 {
-	char str[80];
-
-	snprintf( str, sizeof(str), "Send Virtual Node Info from %d to %d", _FromNodeId, _ToNodeId );
-	Msg* msg = new Msg( str, 0xff, REQUEST, FUNC_ID_ZW_SEND_SLAVE_NODE_INFO, true );
+	Log::Write( LogLevel_Info, "Send Virtual Node Info from %d to %d", _FromNodeId, _ToNodeId );
+	Msg* msg = new Msg( "Send Virtual Node Info", 0xff, REQUEST, FUNC_ID_ZW_SEND_SLAVE_NODE_INFO, true );
 	msg->Append( _FromNodeId );		// from the virtual node
 	msg->Append( _ToNodeId );		// to the handheld controller
 	msg->Append( TRANSMIT_OPTION_ACK );
@@ -6672,6 +8178,7 @@ void Driver::GetDriverStatistics
 	_data->m_routedbusy = m_routedbusy;
 	_data->m_broadcastReadCnt = m_broadcastReadCnt;
 	_data->m_broadcastWriteCnt = m_broadcastWriteCnt;
+	_data->m_coalesced = m_coalesced;
 }
 
 //-----------------------------------------------------------------------------
@@ -6692,6 +8199,75 @@ void Driver::GetNodeStatistics
 	}
 }
 
+//-----------------------------------------------------------------------------
+// <Driver::SnapshotValues>
+// Copy the state of many values in one pass over the nodes
+//-----------------------------------------------------------------------------
+uint32 Driver::SnapshotValues
+(
+		uint8 const* _nodeMask,
+		uint8 const _genreMask,
+		ValueRecord* o_records,
+		uint32 const _maxRecords,
+		uint32* io_generation
+)
+{
+	// The generation is read before the values, so a change that races the copy
+	// moves it on again and is picked up by the caller's next snapshot.
+	uint32 generation = m_valueSnapshots.GetGeneration();
+	if( io_generation != NULL )
+	{
+		if( *io_generation == generation )
+		{
+			return 0;
+		}
+		*io_generation = generation;
+	}
+
+	uint32 count = 0;
+	LockGuard LG(m_nodeMutex);
+	for( int nodeId = 1; nodeId <= NUM_NODE_BITFIELD_BYTES*8; ++nodeId )
+	{
+		if( _nodeMask != NULL && ( _nodeMask[(nodeId-1)>>3] & ( 1 << ((nodeId-1)&0x07) ) ) == 0 )
+		{
+			continue;
+		}
+
+		Node* node = m_nodes[nodeId];
+		if( node == NULL )
+		{
+			continue;
+		}
+
+		ValueStore* store = node->GetValueStore();
+		for( ValueStore::Iterator it = store->Begin(); it != store->End(); ++it )
+		{
+			Value const* value = it->second;
+			ValueID const& id = value->GetID();
+			if( ( _genreMask & ( 1 << id.GetGenre() ) ) == 0 )
+			{
+				continue;
+			}
+
+			if( count < _maxRecords )
+			{
+				ValueRecord& record = o_records[count];
+				record.m_id = id.GetId();
+				record.m_refreshTime = value->m_refreshTime;
+				record.m_type = (uint8)id.GetType();
+				record.m_isNumber = value->GetAsNumber( &record.m_number );
+				if( !record.m_isNumber )
+				{
+					record.m_number = 0;
+				}
+			}
+			++count;
+		}
+	}
+
+	return count;
+}
+
 //-----------------------------------------------------------------------------
 // <Driver::LogDriverStatistics>
 // Report driver statistics to the driver's log
@@ -6720,6 +8296,7 @@ void Driver::LogDriverStatistics
 	Log::Write( LogLevel_Always, "Total messages successfully received: . . . . . . . . . . %ld", data.m_readCnt );
 	Log::Write( LogLevel_Always, "Total Messages successfully sent: . . . . . . . . . . . . %ld", data.m_writeCnt );
 	Log::Write( LogLevel_Always, "ACKs received from controller:  . . . . . . . . . . . . . %ld", data.m_ACKCnt );
+	Log::Write( LogLevel_Always, "Duplicate requests not sent:  . . . . . . . . . . . . . . %ld", data.m_coalesced );
 	// Consider tracking and adding:
 	//		Initialization messages
 	//		Ad-hoc command messages
@@ -31,10 +31,14 @@
 #include <string>
 #include <map>
 #include <list>
+#include <vector>
+#include <time.h>
 
 #include "Defs.h"
 #include "Group.h"
 #include "value_classes/ValueID.h"
+#include "value_classes/ValueIDIndex.h"
+#include "value_classes/ValueSnapshots.h"
 #include "Node.h"
 #include "platform/Event.h"
 #include "platform/Mutex.h"
@@ -51,6 +55,7 @@ namespace OpenZWave
 	class Thread;
 	class ControllerReplication;
 	class Notification;
+	class WakeUp;
 
 	/** \brief The Driver class handles communication between OpenZWave
 	 *  and a device attached via a serial port (typically a controller).
@@ -84,7 +89,9 @@ namespace OpenZWave
 		{
 			ControllerInterface_Unknown = 0,
 			ControllerInterface_Serial,
-			ControllerInterface_Hid
+			ControllerInterface_Hid,
+			ControllerInterface_Simulated,
+			ControllerInterface_Replay
 		};
 
 	//-----------------------------------------------------------------------------
@@ -265,6 +272,8 @@ namespace OpenZWave
 		uint8					m_Controller_nodeId;						// Z-Wave Controller's own node ID.
 		Node*					m_nodes[256];								// Array containing all the node objects.
 		Mutex*					m_nodeMutex;								// Serializes access to node data
+		ValueIDIndex<Value*>	m_valueIndex;								// Every value of the network, kept in step by ValueStore.  m_nodeMutex must be held.
+		ValueSnapshots			m_valueSnapshots;							// Copies of the values that Manager can read without m_nodeMutex
 
 		ControllerReplication*	m_controllerReplication;					// Controller replication is handled separately from the other command classes, due to older hand-held controllers using invalid node IDs.
 
@@ -274,7 +283,33 @@ namespace OpenZWave
 	//	Receiving Z-Wave messages
 	//-----------------------------------------------------------------------------
 	private:
+		// State of the frame decoder in ReadMsg.  A frame that has only partly
+		// arrived is kept here until the rest of it is in the controller stream.
+		enum ReadState
+		{
+			ReadState_Idle = 0,							// Waiting for the first byte of a frame (SOF, ACK, NAK or CAN)
+			ReadState_Length,							// SOF received, waiting for the length byte
+			ReadState_Data								// Length received, waiting for the rest of the frame
+		};
+
+		/**
+		 *  Decodes every complete frame that is already buffered in the controller stream,
+		 *  without blocking.  If only part of a frame is available, the decoder state is
+		 *  saved and the stream signal threshold is set to the number of bytes still needed,
+		 *  so that the driver thread is woken once the rest of the frame has arrived.
+		 *  \return true if at least one byte was consumed from the stream.
+		 *  \see AbortFrame, ProcessMsg
+		 */
 		bool ReadMsg();
+		/**
+		 *  Discards a partially received frame whose remaining bytes did not arrive in time.
+		 */
+		void AbortFrame();
+		/**
+		 *  Verifies the checksum of a complete frame held in m_readBuffer, acknowledges it
+		 *  and passes it to ProcessMsg.
+		 */
+		void ProcessFrame();
 		void ProcessMsg( uint8* _data );
 
 		void HandleGetVersionResponse( uint8* _data );
@@ -307,10 +342,12 @@ namespace OpenZWave
 		bool HandleDeleteReturnRouteResponse( uint8* _data );
 		void HandleSendNodeInformationRequest( uint8* _data );
 		void HandleSendDataResponse( uint8* _data, bool _replication );
+		bool HandleSendDataMultiResponse( uint8* _data );
 		bool HandleNetworkUpdateResponse( uint8* _data );
 		void HandleGetRoutingInfoResponse( uint8* _data );
 
 		void HandleSendDataRequest( uint8* _data, bool _replication );
+		void HandleSendDataMultiRequest( uint8* _data );
 		void HandleAddNodeToNetworkRequest( uint8* _data );
 		void HandleCreateNewPrimaryRequest( uint8* _data );
 		void HandleControllerChangeRequest( uint8* _data );
@@ -345,31 +382,76 @@ namespace OpenZWave
 		uint8					m_expectedCommandClassId;					// If the expected reply is FUNC_ID_APPLICATION_COMMAND_HANDLER, this value stores the command class we're waiting to hear from
 		uint8					m_expectedNodeId;							// If we are waiting for a FUNC_ID_APPLICATION_COMMAND_HANDLER, make sure we only accept it from this node.
 
+		ReadState				m_readState;								// Progress of the frame currently being decoded by ReadMsg
+		uint8					m_readBuffer[1024];							// Frame currently being decoded by ReadMsg
+		TimeStamp				m_readTimeStamp;							// Time by which the rest of a partial frame must have arrived
+
 	//-----------------------------------------------------------------------------
 	//	Polling Z-Wave devices
 	//-----------------------------------------------------------------------------
 	private:
 		int32 GetPollInterval(){ return m_pollInterval ; }
-		void SetPollInterval( int32 _milliseconds, bool _bIntervalBetweenPolls ){ m_pollInterval = _milliseconds; m_bIntervalBetweenPolls = _bIntervalBetweenPolls; }
+		void SetPollInterval( int32 _milliseconds, bool _bIntervalBetweenPolls );
 		bool EnablePoll( const ValueID &_valueId, uint8 _intensity = 1 );
 		bool DisablePoll( const ValueID &_valueId );
 		bool isPolled( const ValueID &_valueId );
 		void SetPollIntensity( const ValueID &_valueId, uint8 _intensity );
+		bool SetPollInterval( ValueID const& _valueId, int32 _milliseconds );
+		int32 GetPollInterval( ValueID const& _valueId );
+		bool SetPollIntervalBounds( ValueID const& _valueId, int32 _minMilliseconds, int32 _maxMilliseconds );
+		bool SetPollSuppression( ValueID const& _valueId, bool _suppress );
 		static void PollThreadEntryPoint( Event* _exitEvent, void* _context );
 		void PollThreadProc( Event* _exitEvent );
 
+		uint32 GetPollTime();
+		int32 GetValuePollInterval( int32 _interval, uint8 _intensity );
+		int32 GetPollSpacing();
+		void SchedulePoll( ValueID const& _valueId, uint32 _due );
+		bool IsSendQueueIdle();
+
 		Thread*					m_pollThread;								// Thread for polling devices on the Z-Wave network
 		struct PollEntry
 		{
 			ValueID	m_id;
-			uint8	m_pollCounter;
+			uint32	m_due;													// Poll time (see GetPollTime) at which the value is next due
+			uint32	m_generation;											// Entries whose generation no longer matches the PollState are stale
+		};
+		struct PollEntryCompare
+		{
+			// Orders the heap so that the entry due soonest is at the front.  Poll
+			// times wrap, so compare the signed difference rather than the values.
+			bool operator()( PollEntry const& _a, PollEntry const& _b )const{ return( (int32)(_a.m_due - _b.m_due) > 0 ); }
+		};
+		struct PollState
+		{
+			int32	m_interval;												// Interval in ms between polls of the value, or zero to derive it from the poll intensity
+			int32	m_minInterval;											// With adaptive polling, the shortest interval between polls, or zero for no limit
+			int32	m_maxInterval;											// With adaptive polling, the longest interval between polls, or zero for the default limit
+			int32	m_period;												// Interval used when the value was last scheduled, or zero if it hasn't been polled yet
+			uint32	m_generation;											// Generation of the value's live entry in m_pollHeap
+			uint32	m_lastPoll;												// Poll time at which the value was last polled
+			uint32	m_lastRefresh;											// Poll time of the last unsolicited report of the value
+			uint8	m_backoff;												// With adaptive polling, the interval is doubled this many times
+			bool	m_pollPending;											// True from polling the value until it is refreshed
+			bool	m_refreshed;											// True if the value has been reported since it was last polled
+			bool	m_suppressIfRefreshed;									// If true, a report of the value stands in for its next poll
 		};
+		bool IsLivePollEntry( PollEntry const& _entry );
+		int32 GetPollPeriod( PollState const& _state, uint8 _intensity );
+
 OPENZWAVE_EXPORT_WARNINGS_OFF
-		list<PollEntry>			m_pollList;									// List of nodes that need to be polled
+		vector<PollEntry>		m_pollHeap;									// Min-heap of polled values, ordered by the time each one is next due
+		ValueIDIndex<PollState>	m_pollValues;								// Values that are polled, and the generation of their heap entry
 OPENZWAVE_EXPORT_WARNINGS_ON
 		Mutex*					m_pollMutex;								// Serialize access to the polling list
+		Event*					m_pollEvent;								// Signalled when the poll schedule changes, to wake the poll thread
+		Event*					m_queueDrainedEvent;						// Signalled by the driver thread when it has nothing left to send
+		TimeStamp				m_pollEpoch;								// Origin of the poll times held in m_pollHeap
+		uint32					m_pollGeneration;							// Source of PollEntry generations
 		int32					m_pollInterval;								// Time interval during which all nodes must be polled
 		bool					m_bIntervalBetweenPolls;					// if true, the library intersperses m_pollInterval between polls; if false, the library attempts to complete all polls within m_pollInterval
+		bool					m_bAdaptivePolling;							// if true, values that don't change between polls are polled less often
+		bool					m_bSuppressRefreshedPolls;					// default for PollState::m_suppressIfRefreshed
 
 	//-----------------------------------------------------------------------------
 	//	Retrieving Node information
@@ -691,13 +773,43 @@ OPENZWAVE_EXPORT_WARNINGS_ON
 			ControllerCommandItem*		m_cci;
 		};
 
+		void PushQueueItem( MsgQueue const _queue, MsgQueueItem const& _item );	// Append an item to a send queue and its node's index.  m_sendMutex must be held.
+		list<MsgQueueItem>::iterator GetNextQueueItem( MsgQueue const _queue );	// Choose the item to send next from a send queue.  m_sendMutex must be held.
+		void PopQueueItem( MsgQueue const _queue, list<MsgQueueItem>::iterator _it );	// Remove an item chosen by GetNextQueueItem from a send queue.  m_sendMutex must be held.
+		void ClearNodeQueueIndex( uint8 const _nodeId, MsgQueue const _queue );	// Forget a node's items in a send queue, once they have been removed.  m_sendMutex must be held.
+		void SetNodeSendWeight( uint8 const _nodeId, uint8 const _weight );
+		uint8 GetNodeSendWeight( uint8 const _nodeId );
+		void SetNodeBatchRequests( uint8 const _nodeId, bool const _batch );
+		bool GetNodeBatchRequests( uint8 const _nodeId );
+		void BatchRequests( MsgQueue const _queue );	// Pack the Gets queued behind the current message for the same node into one MultiCmd frame.  m_sendMutex must be held.
+		bool IsBatchableRequest( Msg* _msg );
+		int32 GetRetryTimeout( int32 const _default );	// How long to wait for the current message to complete.  _default is the RetryTimeout option, which is also the longest adaptive timeout.
+		bool IsRequestPending( Msg const* _msg, MsgQueue const _queue );		// True if an identical Get is waiting in _queue or a queue served before it, with nothing but Gets for the node to be sent after it.  m_sendMutex must be held.
+		bool MoveQueueItemToWakeUp( uint8 const _targetNodeId, MsgQueueItem const& _item, WakeUp* _wakeUp );	// Move (or discard) an item for a sleeping node.  Returns false if the item is for another node.
+
 OPENZWAVE_EXPORT_WARNINGS_OFF
 		list<MsgQueueItem>			m_msgQueue[MsgQueue_Count];
+		// For each node, the SendMsg and QueryStageComplete items it has in each send queue, in queue order,
+		// so that they can be found without walking the whole queue.  Controller command items are not
+		// indexed, since their target node can change while they run; MsgQueue_Controller is short and is scanned.
+		list<list<MsgQueueItem>::iterator>	m_nodeQueueIndex[256][MsgQueue_Count];
+		// The nodes with indexed items in each send queue, in the order they take turns when m_bFairScheduling is set.
+		list<uint8>				m_queueRotation[MsgQueue_Count];
+		list<uint8>::iterator	m_queueRotationPos[256][MsgQueue_Count];	// Each node's place in m_queueRotation, valid while it has indexed items
 OPENZWAVE_EXPORT_WARNINGS_ON
+		uint8					m_queueCredit[MsgQueue_Count];		// Messages the node at the head of each rotation may still send before its turn ends
+		uint8					m_nodeSendWeight[256];				// Messages each node may send per turn
+		bool					m_bFairScheduling;					// if true, nodes take turns to send from each queue rather than strictly first come first served
+		bool					m_nodeBatchRequests[256];			// false for nodes whose Gets must not be packed into MultiCmd frames
+		bool					m_bBatchRequests;					// if true, consecutive Gets for a node that supports MultiCmd are sent in one frame
 		Event*					m_queueEvent[MsgQueue_Count];		// Events for each queue, which are signaled when the queue is not empty
 		Mutex*					m_sendMutex;						// Serialize access to the queues
 		Msg*					m_currentMsg;
 		MsgQueue				m_currentMsgQueueSource;			// identifies which queue held m_currentMsg
+		bool					m_currentMsgQueued;					// m_currentMsg is still at the front of its queue, so must not be deleted
+		bool					m_bCoalesceRequests;				// if true, SendMsg drops a Get identical to one already waiting for the same node in the same or a higher priority queue
+		bool					m_bAdaptiveRetryTimeout;			// if true, the retry timeout for each node follows its measured round trip times
+		int32					m_retryTimeoutMin;					// Shortest adaptive retry timeout, in milliseconds
 		TimeStamp				m_resendTimeStamp;
 
 	//-----------------------------------------------------------------------------
@@ -734,6 +846,65 @@ OPENZWAVE_EXPORT_WARNINGS_ON
 		void SwitchAllOn();
 		void SwitchAllOff();
 
+	//-----------------------------------------------------------------------------
+	// Multicast
+	//-----------------------------------------------------------------------------
+	public:
+		/**
+		 * \brief Send the same command to several nodes in one FUNC_ID_ZW_SEND_DATA_MULTI transmission.
+		 * Multicast frames are not acknowledged, so if the controller reports that the transmission
+		 * failed the command is sent to each node individually instead.  If the command sets values,
+		 * each value is then read back, unless its node has already reported the new value.
+		 * \param _nodeIds The nodes to send the command to.
+		 * \param _valueIds The values the command sets (one per node, in the same order), or empty.
+		 * \param _value The new value, to check against the nodes' reports (bools as 0 or 1).
+		 * \param _command The command, starting with the command class ID.
+		 * \param _length The length of the command.
+		 */
+		void SendMulticast( vector<uint8> const& _nodeIds, vector<ValueID> const& _valueIds, uint8 const _value, uint8 const* _command, uint8 const _length );
+		void OnMulticastValueReport( ValueID const& _valueId, uint8 const _value );	// Called when a device reports a bool or byte value, to confirm or retry a multicast Set
+		void CancelMulticastTarget( ValueID const& _valueId );	// Called when a value is Set, so that an older multicast Set of it is never repeated
+		void OnPolledValueRefreshed( ValueID const& _valueId, uint8 const _intensity, bool const _changed );	// Called when a polled value is refreshed, to adapt its poll interval
+
+	private:
+		// The public interface is provided via the wrappers in the Manager class
+		bool SetValuesMulticast( vector<ValueID> const& _valueIds, uint8 const _value );
+
+		void SendUnicastCommand( uint8 const _nodeId, uint8 const* _command, uint8 const _length );
+		void RequestValue( ValueID const& _valueId );
+		void CompleteMulticast( bool const _delivered );
+
+		enum
+		{
+			c_maxMulticastNodes = 64,		// Keeps each FUNC_ID_ZW_SEND_DATA_MULTI frame well inside the serial API's limits
+			c_maxMulticastCommand = 16,
+			c_multicastTargetTimeout = 30000	// Milliseconds a multicast Set waits for a report before it is forgotten
+		};
+
+		struct MulticastGroup						// A multicast transmission waiting for its callback
+		{
+			Msg*			m_msg;
+			vector<uint8>	m_nodeIds;
+			vector<ValueID>	m_valueIds;
+			uint8			m_value;
+			uint8			m_command[c_maxMulticastCommand];
+			uint8			m_length;
+		};
+
+		struct MulticastTarget						// A value set by multicast that no report has confirmed yet
+		{
+			uint8			m_value;
+			bool			m_sent;					// The multicast has completed, so a report of a different value means it was missed
+			uint32			m_expiry;				// Poll time (see GetPollTime) at which to give up waiting for a report
+			uint8			m_command[c_maxMulticastCommand];
+			uint8			m_length;
+		};
+
+OPENZWAVE_EXPORT_WARNINGS_OFF
+		list<MulticastGroup>			m_multicastGroups;		// In the order the transmissions were queued
+		map<ValueID,MulticastTarget>	m_multicastTargets;
+OPENZWAVE_EXPORT_WARNINGS_ON
+
 	//-----------------------------------------------------------------------------
 	// Configuration Parameters	(wrappers for the Node methods)
 	//-----------------------------------------------------------------------------
@@ -767,6 +938,22 @@ OPENZWAVE_EXPORT_WARNINGS_OFF
 OPENZWAVE_EXPORT_WARNINGS_ON
 		Event*				m_notificationsEvent;
 
+	//-----------------------------------------------------------------------------
+	//	Value snapshots
+	//-----------------------------------------------------------------------------
+	public:
+		struct ValueRecord
+		{
+			uint64	m_id;				// ValueID::GetId() of the value.  With the home ID, this makes a ValueID.
+			double	m_number;			// Numeric state of the value, if m_isNumber is set
+			time_t	m_refreshTime;		// When the value was last refreshed, or zero if it never has been
+			uint8	m_type;				// ValueID::ValueType of the value
+			bool	m_isNumber;			// False for strings, raw data, schedules and lists with no selection
+		};
+
+	private:
+		uint32 SnapshotValues( uint8 const* _nodeMask, uint8 const _genreMask, ValueRecord* o_records, uint32 const _maxRecords, uint32* io_generation );
+
 	//-----------------------------------------------------------------------------
 	//	Statistics
 	//-----------------------------------------------------------------------------
@@ -794,6 +981,7 @@ OPENZWAVE_EXPORT_WARNINGS_ON
 			uint32 m_routedbusy;		// Number of messages received with routed busy status
 			uint32 m_broadcastReadCnt;	// Number of broadcasts read
 			uint32 m_broadcastWriteCnt;	// Number of broadcasts sent
+			uint32 m_coalesced;			// Number of requests not queued because an identical one was already waiting
 		};
 
 		void LogDriverStatistics();
@@ -823,6 +1011,7 @@ OPENZWAVE_EXPORT_WARNINGS_ON
 		uint32 m_routedbusy;		// Number of messages received with routed busy status
 		uint32 m_broadcastReadCnt;	// Number of broadcasts read
 		uint32 m_broadcastWriteCnt;	// Number of broadcasts sent
+		uint32 m_coalesced;			// Number of requests not queued because an identical one was already waiting
 		//time_t m_commandStart;	// Start time of last command
 		//time_t m_timeoutLost;		// Cumulative time lost to timeouts
 
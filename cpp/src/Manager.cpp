@@ -184,6 +184,14 @@ m_notificationMutex( new Mutex() )
 	Log::Create( logFilename, bAppend, bConsoleOutput, (LogLevel) nSaveLogLevel, (LogLevel) nQueueLogLevel, (LogLevel) nDumpTrigger );
 	Log::SetLoggingState( logging );
 
+	int nQueueDepth = 500;
+	Options::Get()->GetOptionAsInt( "QueueLogDepth", &nQueueDepth );
+	if( nQueueDepth < 0 ) {
+		Log::Write(LogLevel_Warning, "Invalid QueueLogDepth Specified in Options.xml");
+		nQueueDepth = 500;
+	}
+	Log::SetQueueDepth( (uint32) nQueueDepth );
+
 	CommandClasses::RegisterCommandClasses();
 	Scene::ReadScenes();
 	Log::Write(LogLevel_Always, "OpenZwave Version %s Starting Up", getVersionAsString().c_str());
@@ -752,6 +760,81 @@ uint8 Manager::GetPollIntensity
 	return intensity;
 }
 
+//-----------------------------------------------------------------------------
+// <Manager::SetPollInterval>
+// Set the interval between polls of a value
+//-----------------------------------------------------------------------------
+bool Manager::SetPollInterval
+(
+		ValueID const &_valueId,
+		int32 const _milliseconds
+)
+{
+	if( Driver* driver = GetDriver( _valueId.GetHomeId() ) )
+	{
+		return( driver->SetPollInterval( _valueId, _milliseconds ) );
+	}
+
+	Log::Write( LogLevel_Info, "mgr,     SetPollInterval failed - Driver with Home ID 0x%.8x is not available", _valueId.GetHomeId() );
+	return false;
+}
+
+//-----------------------------------------------------------------------------
+// <Manager::GetPollInterval>
+// Get the interval between polls of a value
+//-----------------------------------------------------------------------------
+int32 Manager::GetPollInterval
+(
+		ValueID const &_valueId
+)
+{
+	if( Driver* driver = GetDriver( _valueId.GetHomeId() ) )
+	{
+		return( driver->GetPollInterval( _valueId ) );
+	}
+
+	return 0;
+}
+
+//-----------------------------------------------------------------------------
+// <Manager::SetPollIntervalBounds>
+// Limit the adaptive poll interval of a value
+//-----------------------------------------------------------------------------
+bool Manager::SetPollIntervalBounds
+(
+		ValueID const &_valueId,
+		int32 const _minMilliseconds,
+		int32 const _maxMilliseconds
+)
+{
+	if( Driver* driver = GetDriver( _valueId.GetHomeId() ) )
+	{
+		return( driver->SetPollIntervalBounds( _valueId, _minMilliseconds, _maxMilliseconds ) );
+	}
+
+	Log::Write( LogLevel_Info, "mgr,     SetPollIntervalBounds failed - Driver with Home ID 0x%.8x is not available", _valueId.GetHomeId() );
+	return false;
+}
+
+//-----------------------------------------------------------------------------
+// <Manager::SetPollSuppression>
+// Choose whether a report of a value stands in for its next poll
+//-----------------------------------------------------------------------------
+bool Manager::SetPollSuppression
+(
+		ValueID const &_valueId,
+		bool const _suppress
+)
+{
+	if( Driver* driver = GetDriver( _valueId.GetHomeId() ) )
+	{
+		return( driver->SetPollSuppression( _valueId, _suppress ) );
+	}
+
+	Log::Write( LogLevel_Info, "mgr,     SetPollSuppression failed - Driver with Home ID 0x%.8x is not available", _valueId.GetHomeId() );
+	return false;
+}
+
 //-----------------------------------------------------------------------------
 //	Retrieving Node information
 //-----------------------------------------------------------------------------
@@ -1390,6 +1473,76 @@ string Manager::GetNodePlusTypeString
 
 }
 
+//-----------------------------------------------------------------------------
+// <Manager::SetNodeSendWeight>
+// Set how many messages a node may send per turn with fair scheduling
+//-----------------------------------------------------------------------------
+void Manager::SetNodeSendWeight
+(
+		uint32 const _homeId,
+		uint8 const _nodeId,
+		uint8 const _weight
+)
+{
+	if( Driver* driver = GetDriver( _homeId ) )
+	{
+		driver->SetNodeSendWeight( _nodeId, _weight );
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <Manager::GetNodeSendWeight>
+// Get how many messages a node may send per turn with fair scheduling
+//-----------------------------------------------------------------------------
+uint8 Manager::GetNodeSendWeight
+(
+		uint32 const _homeId,
+		uint8 const _nodeId
+)
+{
+	if( Driver* driver = GetDriver( _homeId ) )
+	{
+		return driver->GetNodeSendWeight( _nodeId );
+	}
+
+	return 0;
+}
+
+//-----------------------------------------------------------------------------
+// <Manager::SetNodeBatchRequests>
+// Set whether a node's Gets may be packed into MultiCmd frames
+//-----------------------------------------------------------------------------
+void Manager::SetNodeBatchRequests
+(
+		uint32 const _homeId,
+		uint8 const _nodeId,
+		bool const _batch
+)
+{
+	if( Driver* driver = GetDriver( _homeId ) )
+	{
+		driver->SetNodeBatchRequests( _nodeId, _batch );
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <Manager::GetNodeBatchRequests>
+// Get whether a node's Gets may be packed into MultiCmd frames
+//-----------------------------------------------------------------------------
+bool Manager::GetNodeBatchRequests
+(
+		uint32 const _homeId,
+		uint8 const _nodeId
+)
+{
+	if( Driver* driver = GetDriver( _homeId ) )
+	{
+		return driver->GetNodeBatchRequests( _nodeId );
+	}
+
+	return false;
+}
+
 //-----------------------------------------------------------------------------
 // <Manager::GetNodeProductId>
 // Get the product Id value with the specified ID
@@ -1924,6 +2077,13 @@ bool Manager::GetValueAsBool
 		{
 			if( Driver* driver = GetDriver( _id.GetHomeId() ) )
 			{
+				int32 number;
+				if( driver->m_valueSnapshots.Read( _id, &number, NULL ) )
+				{
+					*o_value = ( number != 0 );
+					return true;
+				}
+
 				LockGuard LG(driver->m_nodeMutex);
 				if( ValueBool* value = static_cast<ValueBool*>( driver->GetValue( _id ) ) )
 				{
@@ -1939,6 +2099,13 @@ bool Manager::GetValueAsBool
 		{
 			if( Driver* driver = GetDriver( _id.GetHomeId() ) )
 			{
+				int32 number;
+				if( driver->m_valueSnapshots.Read( _id, &number, NULL ) )
+				{
+					*o_value = ( number != 0 );
+					return true;
+				}
+
 				LockGuard LG(driver->m_nodeMutex);
 				if( ValueButton* value = static_cast<ValueButton*>( driver->GetValue( _id ) ) )
 				{
@@ -1975,6 +2142,13 @@ bool Manager::GetValueAsByte
 		{
 			if( Driver* driver = GetDriver( _id.GetHomeId() ) )
 			{
+				int32 number;
+				if( driver->m_valueSnapshots.Read( _id, &number, NULL ) )
+				{
+					*o_value = (uint8)number;
+					return true;
+				}
+
 				LockGuard LG(driver->m_nodeMutex);
 				if( ValueByte* value = static_cast<ValueByte*>( driver->GetValue( _id ) ) )
 				{
@@ -2011,11 +2185,20 @@ bool Manager::GetValueAsFloat
 		{
 			if( Driver* driver = GetDriver( _id.GetHomeId() ) )
 			{
+				int32 number;
+				uint8 precision;
+				if( driver->m_valueSnapshots.Read( _id, &number, NULL, &precision ) )
+				{
+					*o_value = (float)ValueDecimal::FixedPoint( number, precision ).ToDouble();
+					return true;
+				}
+
 				LockGuard LG(driver->m_nodeMutex);
 				if( ValueDecimal* value = static_cast<ValueDecimal*>( driver->GetValue( _id ) ) )
 				{
-					string str = value->GetValue();
-					*o_value = (float)atof( str.c_str() );
+					double number;
+					value->GetAsNumber( &number );
+					*o_value = (float)number;
 					value->Release();
 					res = true;
 				} else {
@@ -2048,6 +2231,13 @@ bool Manager::GetValueAsInt
 		{
 			if( Driver* driver = GetDriver( _id.GetHomeId() ) )
 			{
+				int32 number;
+				if( driver->m_valueSnapshots.Read( _id, &number, NULL ) )
+				{
+					*o_value = number;
+					return true;
+				}
+
 				LockGuard LG(driver->m_nodeMutex);
 				if( ValueInt* value = static_cast<ValueInt*>( driver->GetValue( _id ) ) )
 				{
@@ -2123,6 +2313,13 @@ bool Manager::GetValueAsShort
 		{
 			if( Driver* driver = GetDriver( _id.GetHomeId() ) )
 			{
+				int32 number;
+				if( driver->m_valueSnapshots.Read( _id, &number, NULL ) )
+				{
+					*o_value = (int16)number;
+					return true;
+				}
+
 				LockGuard LG(driver->m_nodeMutex);
 				if( ValueShort* value = static_cast<ValueShort*>( driver->GetValue( _id ) ) )
 				{
@@ -2158,6 +2355,59 @@ bool Manager::GetValueAsString
 	{
 		if( Driver* driver = GetDriver( _id.GetHomeId() ) )
 		{
+			// Try the copy of the value first, which needs no lock
+			int32 number;
+			switch( _id.GetType() )
+			{
+				case ValueID::ValueType_Bool:
+				case ValueID::ValueType_Button:
+				{
+					if( driver->m_valueSnapshots.Read( _id, &number, NULL ) )
+					{
+						*o_value = number ? "True" : "False";
+						return true;
+					}
+					break;
+				}
+				case ValueID::ValueType_Byte:
+				case ValueID::ValueType_Int:
+				case ValueID::ValueType_Short:
+				{
+					if( driver->m_valueSnapshots.Read( _id, &number, NULL ) )
+					{
+						snprintf( str, sizeof(str), ValueID::ValueType_Byte == _id.GetType() ? "%u" : "%d", number );
+						*o_value = str;
+						return true;
+					}
+					break;
+				}
+				case ValueID::ValueType_Decimal:
+				{
+					int32 number;
+					uint8 precision;
+					if( driver->m_valueSnapshots.Read( _id, &number, NULL, &precision ) )
+					{
+						*o_value = ValueDecimal::FixedPoint( number, precision ).ToString();
+						return true;
+					}
+					break;
+				}
+				case ValueID::ValueType_List:
+				case ValueID::ValueType_String:
+				{
+					if( driver->m_valueSnapshots.Read( _id, NULL, o_value ) )
+					{
+						return true;
+					}
+					break;
+				}
+				default:
+				{
+					// Raw and schedule values are always read from the value itself
+					break;
+				}
+			}
+
 			LockGuard LG(driver->m_nodeMutex);
 
 			switch( _id.GetType() )
@@ -2503,6 +2753,28 @@ bool Manager::GetValueFloatPrecision
 	return res;
 }
 
+//-----------------------------------------------------------------------------
+// <Manager::SnapshotValues>
+// Copies the state of many values at once
+//-----------------------------------------------------------------------------
+uint32 Manager::SnapshotValues
+(
+		uint32 const _homeId,
+		uint8 const* _nodeMask,
+		uint8 const _genreMask,
+		Driver::ValueRecord* o_records,
+		uint32 const _maxRecords,
+		uint32* io_generation
+)
+{
+	if( Driver* driver = GetDriver( _homeId ) )
+	{
+		return driver->SnapshotValues( _nodeMask, _genreMask, o_records, _maxRecords, io_generation );
+	}
+
+	return 0;
+}
+
 //-----------------------------------------------------------------------------
 // <Manager::SetValue>
 // Sets the value from a bool
@@ -2573,6 +2845,86 @@ bool Manager::SetValue
 	return res;
 }
 
+//-----------------------------------------------------------------------------
+// <Manager::SetValues>
+// Sets several bools to the same value
+//-----------------------------------------------------------------------------
+bool Manager::SetValues
+(
+		vector<ValueID> const& _ids,
+		bool const _value
+)
+{
+	bool res = false;
+
+	if( IsSameValue( _ids, ValueID::ValueType_Bool ) )
+	{
+		if( Driver* driver = GetDriver( _ids.front().GetHomeId() ) )
+		{
+			res = driver->SetValuesMulticast( _ids, _value ? 1 : 0 );
+		}
+	}
+
+	return res;
+}
+
+//-----------------------------------------------------------------------------
+// <Manager::SetValues>
+// Sets several bytes to the same value
+//-----------------------------------------------------------------------------
+bool Manager::SetValues
+(
+		vector<ValueID> const& _ids,
+		uint8 const _value
+)
+{
+	bool res = false;
+
+	if( IsSameValue( _ids, ValueID::ValueType_Byte ) )
+	{
+		if( Driver* driver = GetDriver( _ids.front().GetHomeId() ) )
+		{
+			res = driver->SetValuesMulticast( _ids, _value );
+		}
+	}
+
+	return res;
+}
+
+//-----------------------------------------------------------------------------
+// <Manager::IsSameValue>
+// Check that a set of ValueIDs are all the same value of the same type on
+// different nodes, so they can be set together
+//-----------------------------------------------------------------------------
+bool Manager::IsSameValue
+(
+		vector<ValueID> const& _ids,
+		ValueID::ValueType const _type
+)
+{
+	if( _ids.empty() )
+	{
+		return false;
+	}
+
+	ValueID const& first = _ids.front();
+	for( vector<ValueID>::const_iterator it = _ids.begin(); it != _ids.end(); ++it )
+	{
+		if( _type != it->GetType() )
+		{
+			OZW_ERROR(OZWException::OZWEXCEPTION_CANNOT_CONVERT_VALUEID, "ValueID passed to SetValues is of the wrong type");
+			return false;
+		}
+		if( it->GetHomeId() != first.GetHomeId() || it->GetCommandClassId() != first.GetCommandClassId() || it->GetIndex() != first.GetIndex() )
+		{
+			OZW_ERROR(OZWException::OZWEXCEPTION_INVALID_VALUEID, "ValueIDs passed to SetValues do not all refer to the same value");
+			return false;
+		}
+	}
+
+	return true;
+}
+
 //-----------------------------------------------------------------------------
 // <Manager::SetValue>
 // Sets the value from a floating point number
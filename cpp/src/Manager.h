@@ -423,6 +423,51 @@ OPENZWAVE_EXPORT_WARNINGS_ON
 		 */
 		uint8 GetPollIntensity( ValueID const &_valueId );
 
+		/**
+		 * \brief Set how often a polled value is polled.
+		 * By default a value is polled once per poll interval (see SetPollInterval), or less often
+		 * if its poll intensity is greater than one.  Setting an interval here overrides that for
+		 * the one value.
+		 * \param _valueId The ID of a value that is being polled.
+		 * \param _milliseconds The time between polls of the value, or zero to go back to the default.
+		 * \return True if the interval was set, false if the value is not being polled.
+		 * \see EnablePoll
+		 */
+		bool SetPollInterval( ValueID const &_valueId, int32 const _milliseconds );
+
+		/**
+		 * \brief Get how often a polled value is polled.
+		 * \param _valueId The ID of the value.
+		 * \return The time in milliseconds between polls of the value, or zero if it is not being polled.
+		 */
+		int32 GetPollInterval( ValueID const &_valueId );
+
+		/**
+		 * \brief Limit the poll interval of a value when adaptive polling is enabled.
+		 * With the AdaptivePolling option set, the interval between polls of a value doubles each
+		 * time a poll finds it unchanged, and drops back as soon as the value changes.  Without a
+		 * maximum, the interval can grow to 64 times its normal length.
+		 * \param _valueId The ID of a value that is being polled.
+		 * \param _minMilliseconds The shortest time between polls of the value, or zero for no limit.
+		 * \param _maxMilliseconds The longest time between polls of the value, or zero for the default limit.
+		 * \return True if the limits were set, false if the value is not being polled.
+		 * \see SetPollInterval
+		 */
+		bool SetPollIntervalBounds( ValueID const &_valueId, int32 const _minMilliseconds, int32 const _maxMilliseconds );
+
+		/**
+		 * \brief Choose whether an unsolicited report of a polled value stands in for its next poll.
+		 * When this is on and the device reports the value between polls, the next poll is skipped and
+		 * the poll after it is scheduled one poll interval after the report.  The number of skipped polls
+		 * is counted in Node::NodeData::m_suppressedPolls.  The SuppressRefreshedPolls option sets the
+		 * default for each value when polling is enabled.
+		 * \param _valueId The ID of a value that is being polled.
+		 * \param _suppress True to skip polls of the value after it has been reported.
+		 * \return True if the setting was changed, false if the value is not being polled.
+		 * \see GetNodeStatistics
+		 */
+		bool SetPollSuppression( ValueID const &_valueId, bool const _suppress );
+
 	/*@}*/
 
 	//-----------------------------------------------------------------------------
@@ -871,6 +916,48 @@ OPENZWAVE_EXPORT_WARNINGS_ON
 		 */
 		string GetNodePlusTypeString ( uint32 const _homeId, uint8 const _nodeId );
 
+		/**
+		 * \brief Set a node's share of the send queues.
+		 * When the FairScheduling option is enabled, nodes with messages waiting in the same queue take turns,
+		 * so that one busy node cannot hold up commands for the others.  The weight is the number of messages
+		 * the node may send per turn.
+		 * \param _homeId The Home ID of the Z-Wave controller that manages the node.
+		 * \param _nodeId The ID of the node to change.
+		 * \param _weight Messages sent per turn (1 to 255).  The default is 1.
+		 * \see GetNodeSendWeight
+		 */
+		void SetNodeSendWeight( uint32 const _homeId, uint8 const _nodeId, uint8 const _weight );
+
+		/**
+		 * \brief Get a node's share of the send queues.
+		 * \param _homeId The Home ID of the Z-Wave controller that manages the node.
+		 * \param _nodeId The ID of the node to query.
+		 * \return Messages the node may send per turn when the FairScheduling option is enabled.
+		 * \see SetNodeSendWeight
+		 */
+		uint8 GetNodeSendWeight( uint32 const _homeId, uint8 const _nodeId );
+
+		/**
+		 * \brief Set whether a node's requests may be batched.
+		 * When the BatchRequests option is enabled, Gets queued one after another for a node that supports
+		 * COMMAND_CLASS_MULTI_CMD are packed into a single MultiCmd encapsulated frame.  Use this to turn that
+		 * off for a device that does not handle such frames properly.
+		 * \param _homeId The Home ID of the Z-Wave controller that manages the node.
+		 * \param _nodeId The ID of the node to change.
+		 * \param _batch false to send the node's requests one at a time.  The default is true.
+		 * \see GetNodeBatchRequests
+		 */
+		void SetNodeBatchRequests( uint32 const _homeId, uint8 const _nodeId, bool const _batch );
+
+		/**
+		 * \brief Get whether a node's requests may be batched.
+		 * \param _homeId The Home ID of the Z-Wave controller that manages the node.
+		 * \param _nodeId The ID of the node to query.
+		 * \return true if the node's Gets may be packed into MultiCmd frames when the BatchRequests option is enabled.
+		 * \see SetNodeBatchRequests
+		 */
+		bool GetNodeBatchRequests( uint32 const _homeId, uint8 const _nodeId );
+
 
 
 	/*@}*/
@@ -1150,6 +1237,31 @@ OPENZWAVE_EXPORT_WARNINGS_ON
 		 */
 		bool GetValueFloatPrecision( ValueID const& _id, uint8* o_value );
 
+		/**
+		 * \brief Copies the state of many values at once.
+		 * All the values of the chosen nodes and genres are copied in a single pass, with the
+		 * nodes locked once, into records that the caller allocates and may reuse between calls.
+		 * This suits applications that export every value at regular intervals, for which
+		 * calling GetValueAsString on each value would take and release the lock many times.
+		 * \param _homeId The Home ID of the Z-Wave controller.
+		 * \param _nodeMask Bit field of the nodes to copy, in which bit 0 of the first byte is node 1.
+		 * It must hold NUM_NODE_BITFIELD_BYTES bytes.  Pass NULL to copy the values of every node.
+		 * \param _genreMask The genres to copy, as a bit field in which bit n is set for genre n.
+		 * For example, ( 1 << ValueID::ValueGenre_User ) copies only the user values.
+		 * \param o_records Array to receive a record for each value.
+		 * \param _maxRecords The number of records that o_records can hold.
+		 * \param io_generation Pass the generation returned by the previous call, or zero for
+		 * the first call.  If no value has been added, removed or changed since, nothing is copied
+		 * and zero is returned, so the caller can carry on with its previous records.  Otherwise,
+		 * the current generation is stored here.  Refreshes that leave a value as it was do not
+		 * change the generation.  May be NULL, to copy the values every time.
+		 * \return The number of values that matched the masks.  If this is more than _maxRecords,
+		 * only the first _maxRecords were copied, and the caller should call again with a bigger
+		 * array and an io_generation of zero.
+		 * \see Driver::ValueRecord, GetValueAsString
+		 */
+		uint32 SnapshotValues( uint32 const _homeId, uint8 const* _nodeMask, uint8 const _genreMask, Driver::ValueRecord* o_records, uint32 const _maxRecords, uint32* io_generation );
+
 		/**
 		 * \brief Sets the state of a bool.
 		 * Due to the possibility of a device being asleep, the command is assumed to succeed, and the value
@@ -1179,6 +1291,41 @@ OPENZWAVE_EXPORT_WARNINGS_ON
 		 */
 		bool SetValue( ValueID const& _id, uint8 const _value );
 
+		/**
+		 * \brief Sets several bools to the same value at once.
+		 * Nodes that are awake and whose command class can take the same plain command are sent one
+		 * multicast transmission (FUNC_ID_ZW_SEND_DATA_MULTI) rather than one message each.  The values
+		 * of those nodes are read back afterwards, except where the node has already reported the new value.
+		 * Nodes that missed the multicast are sent the command directly.  All other values are set as by SetValue.
+		 * \param _ids The unique identifiers of the bool values.  They must all belong to the same command
+		 * class, index and Home ID.
+		 * \param _value The new value of the bools.
+		 * \return true if every value was set.
+		 * \throws OZWException with Type OZWException::OZWEXCEPTION_INVALID_VALUEID if the ValueIDs do not all refer to the same value
+		 * \throws OZWException with Type OZWException::OZWEXCEPTION_CANNOT_CONVERT_VALUEID if the Actual Values are of a different type
+		 * \throws OZWException with Type OZWException::OZWEXCEPTION_INVALID_HOMEID if the Driver cannot be found
+		 * \see SetValue
+		 */
+		bool SetValues( vector<ValueID> const& _ids, bool const _value );
+
+		/**
+		 * \brief Sets several bytes to the same value at once.
+		 * Works as the bool version of SetValues.
+		 * \param _ids The unique identifiers of the byte values.  They must all belong to the same command
+		 * class, index and Home ID.
+		 * \param _value The new value of the bytes.
+		 * \return true if every value was set.
+		 * \throws OZWException with Type OZWException::OZWEXCEPTION_INVALID_VALUEID if the ValueIDs do not all refer to the same value
+		 * \throws OZWException with Type OZWException::OZWEXCEPTION_CANNOT_CONVERT_VALUEID if the Actual Values are of a different type
+		 * \throws OZWException with Type OZWException::OZWEXCEPTION_INVALID_HOMEID if the Driver cannot be found
+		 * \see SetValue
+		 */
+		bool SetValues( vector<ValueID> const& _ids, uint8 const _value );
+
+	private:
+		bool IsSameValue( vector<ValueID> const& _ids, ValueID::ValueType const _type );	// Check the ValueIDs passed to SetValues
+	public:
+
 		/**
 		 * \brief Sets the value of a decimal.
 		 * It is usually better to handle decimal values using strings rather than floats, to avoid floating point accuracy issues.
@@ -36,6 +36,10 @@
 #include "command_classes/Security.h"
 #include "aes/aescpp.h"
 
+#ifdef _MSC_VER
+#include <windows.h>
+#endif
+
 using namespace OpenZWave;
 
 /* Callback for normal messages start at 10. Special Messages using a Callback prior to 10 */
@@ -43,6 +47,119 @@ uint8 Msg::s_nextCallbackId = 10;
 
 #define DEBUG 1
 
+namespace
+{
+	// A free slot in the message pool.  Slots are linked through their first bytes.
+	struct MsgSlot
+	{
+		MsgSlot*	m_next;
+	};
+}
+
+static uint32 const c_msgSlotSize = ( sizeof(Msg) + sizeof(void*) - 1 ) & ~( sizeof(void*) - 1 );
+static uint32 const c_msgSlotsPerBlock = 64;
+
+static MsgSlot* s_freeMsgSlots = NULL;		// Slots available for reuse
+static volatile long s_msgPoolLock = 0;		// Spinlock guarding s_freeMsgSlots.  Plain data, so safe during static init.
+
+//-----------------------------------------------------------------------------
+// <LockMsgPool>
+// Acquire the pool spinlock.  The lock is only held for a couple of pointer
+// swaps, so spinning is cheaper than a Mutex here.
+//-----------------------------------------------------------------------------
+static void LockMsgPool
+(
+)
+{
+#ifdef _MSC_VER
+	while( InterlockedExchange( &s_msgPoolLock, 1 ) != 0 )
+	{
+	}
+#else
+	while( __sync_lock_test_and_set( &s_msgPoolLock, 1 ) != 0 )
+	{
+	}
+#endif
+}
+
+//-----------------------------------------------------------------------------
+// <UnlockMsgPool>
+// Release the pool spinlock
+//-----------------------------------------------------------------------------
+static void UnlockMsgPool
+(
+)
+{
+#ifdef _MSC_VER
+	InterlockedExchange( &s_msgPoolLock, 0 );
+#else
+	__sync_lock_release( &s_msgPoolLock );
+#endif
+}
+
+//-----------------------------------------------------------------------------
+// <Msg::operator new>
+// Take a slot from the message pool, growing it by a block if it is empty
+//-----------------------------------------------------------------------------
+void* Msg::operator new
+(
+	size_t _size
+)
+{
+	if( _size != sizeof(Msg) )
+	{
+		// Not a plain Msg, so it will not fit a pool slot
+		return ::operator new( _size );
+	}
+
+	LockMsgPool();
+	if( s_freeMsgSlots == NULL )
+	{
+		// Blocks are never returned to the heap.  The pool only grows to the
+		// largest number of messages that have been in flight at once.
+		uint8* block = static_cast<uint8*>( ::operator new( c_msgSlotSize * c_msgSlotsPerBlock ) );
+		for( uint32 i=0; i<c_msgSlotsPerBlock; ++i )
+		{
+			MsgSlot* slot = reinterpret_cast<MsgSlot*>( block + ( i * c_msgSlotSize ) );
+			slot->m_next = s_freeMsgSlots;
+			s_freeMsgSlots = slot;
+		}
+	}
+
+	MsgSlot* slot = s_freeMsgSlots;
+	s_freeMsgSlots = slot->m_next;
+	UnlockMsgPool();
+	return slot;
+}
+
+//-----------------------------------------------------------------------------
+// <Msg::operator delete>
+// Return a slot to the message pool
+//-----------------------------------------------------------------------------
+void Msg::operator delete
+(
+	void* _p,
+	size_t _size
+)
+{
+	if( _p == NULL )
+	{
+		return;
+	}
+
+	if( _size != sizeof(Msg) )
+	{
+		::operator delete( _p );
+		return;
+	}
+
+	MsgSlot* slot = static_cast<MsgSlot*>( _p );
+	LockMsgPool();
+	slot->m_next = s_freeMsgSlots;
+	s_freeMsgSlots = slot;
+	UnlockMsgPool();
+}
+
 //-----------------------------------------------------------------------------
 // <Msg::Msg>
 // Constructor
@@ -58,23 +175,43 @@ Msg::Msg
 	uint8 const _expectedReply,			// = 0
 	uint8 const _expectedCommandClassId	// = 0
 ):
-	m_logText( _logText ),
-	m_bFinal( false ),
-	m_bCallbackRequired( _bCallbackRequired ),
-	m_callbackId( 0 ),
-	m_expectedReply( 0 ),
-	m_expectedCommandClassId( _expectedCommandClassId ),
-	m_length( 4 ),
-	m_targetNodeId( _targetNodeId ),
-	m_sendAttempts( 0 ),
-	m_maxSendAttempts( MAX_TRIES ),
-	m_instance( 1 ),
-	m_endPoint( 0 ),
-	m_flags( 0 ),
-	m_encrypted ( false ),
-	m_noncerecvd ( false ),
-	m_homeId ( 0 )
+	m_logText( NULL ),
+	m_logTextCopy( _logText )
 {
+	Init( _targetNodeId, _msgType, _function, _bCallbackRequired, _bReplyRequired, _expectedReply, _expectedCommandClassId );
+}
+
+//-----------------------------------------------------------------------------
+// <Msg::Init>
+// Set up the message, for all of the constructors
+//-----------------------------------------------------------------------------
+void Msg::Init
+(
+	uint8 _targetNodeId,
+	uint8 const _msgType,
+	uint8 const _function,
+	bool const _bCallbackRequired,
+	bool const _bReplyRequired,
+	uint8 const _expectedReply,
+	uint8 const _expectedCommandClassId
+)
+{
+	m_bFinal = false;
+	m_bCallbackRequired = _bCallbackRequired;
+	m_callbackId = 0;
+	m_expectedReply = 0;
+	m_expectedCommandClassId = _expectedCommandClassId;
+	m_length = 4;
+	m_targetNodeId = _targetNodeId;
+	m_sendAttempts = 0;
+	m_maxSendAttempts = MAX_TRIES;
+	m_instance = 1;
+	m_endPoint = 0;
+	m_flags = 0;
+	m_encrypted = false;
+	m_noncerecvd = false;
+	m_homeId = 0;
+
 	if( _bReplyRequired )
 	{
 		// Wait for this message before considering the transaction complete
@@ -217,13 +354,33 @@ void Msg::UpdateCallbackId()
 }
 
 
+//-----------------------------------------------------------------------------
+// <Msg::GetLogText>
+// Get the description of the message.  The encapsulation prefix is only
+// formatted here, so messages that are never logged do not pay for it.
+//-----------------------------------------------------------------------------
+string Msg::GetLogText
+(
+)const
+{
+	char const* logText = m_logText ? m_logText : m_logTextCopy.c_str();
+	if( m_bFinal && ( ( m_flags & ( m_MultiChannel | m_MultiInstance ) ) != 0 ) && ( m_buffer[3] == FUNC_ID_ZW_SEND_DATA ) )
+	{
+		char str[256];
+		snprintf( str, sizeof(str), "%s Encapsulated (instance=%d): %s", ( ( m_flags & m_MultiChannel ) != 0 ) ? "MultiChannel" : "MultiInstance", m_instance, logText );
+		return str;
+	}
+
+	return logText;
+}
+
 //-----------------------------------------------------------------------------
 // <Msg::GetAsString>
 // Create a string containing the raw data
 //-----------------------------------------------------------------------------
 string Msg::GetAsString()
 {
-	string str = m_logText;
+	string str = GetLogText();
 
 	char byteStr[16];
 	if( m_targetNodeId != 0xff )
@@ -256,7 +413,6 @@ void Msg::MultiEncap
 (
 )
 {
-	char str[256];
 	if( m_buffer[3]	!= FUNC_ID_ZW_SEND_DATA )
 	{
 		return;
@@ -277,9 +433,6 @@ void Msg::MultiEncap
 		m_buffer[8] = 1;
 		m_buffer[9] = m_endPoint;
 		m_length += 4;
-
-		snprintf( str, sizeof(str), "MultiChannel Encapsulated (instance=%d): %s", m_instance, m_logText.c_str() );
-		m_logText = str;
 	}
 	else
 	{
@@ -294,9 +447,6 @@ void Msg::MultiEncap
 		m_buffer[7] = MultiInstance::MultiInstanceCmd_Encap;
 		m_buffer[8] = m_instance;
 		m_length += 3;
-
-		snprintf( str, sizeof(str), "MultiInstance Encapsulated (instance=%d): %s", m_instance, m_logText.c_str() );
-		m_logText = str;
 	}
 }
 
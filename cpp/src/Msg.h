@@ -50,9 +50,42 @@ namespace OpenZWave
 			m_MultiInstance			= 0x02,		// Indicate MultiInstance encapsulation
 		};
 
+		/**
+		 * \brief Constructor.
+		 * \param _logtext Description of the message.  It is copied into the message.
+		 */
 		Msg( string const& _logtext, uint8 _targetNodeId, uint8 const _msgType, uint8 const _function, bool const _bCallbackRequired, bool const _bReplyRequired = true, uint8 const _expectedReply = 0, uint8 const _expectedCommandClassId = 0 );
+
+		/**
+		 * \brief Constructor for a description that is a string literal.
+		 * A literal lives for the whole program, so only the pointer is stored and nothing is copied.
+		 * Any other text, such as the result of c_str(), goes to the string constructor instead.
+		 */
+		template<size_t N> Msg( char const (&_logtext)[N], uint8 _targetNodeId, uint8 const _msgType, uint8 const _function, bool const _bCallbackRequired, bool const _bReplyRequired = true, uint8 const _expectedReply = 0, uint8 const _expectedCommandClassId = 0 ):
+			m_logText( _logtext )
+		{
+			Init( _targetNodeId, _msgType, _function, _bCallbackRequired, _bReplyRequired, _expectedReply, _expectedCommandClassId );
+		}
+
+		/**
+		 * \brief Constructor for a description in a writable buffer.  The buffer may be reused
+		 * or go out of scope, so the text is copied.
+		 */
+		template<size_t N> Msg( char (&_logtext)[N], uint8 _targetNodeId, uint8 const _msgType, uint8 const _function, bool const _bCallbackRequired, bool const _bReplyRequired = true, uint8 const _expectedReply = 0, uint8 const _expectedCommandClassId = 0 ):
+			m_logText( NULL ),
+			m_logTextCopy( _logtext )
+		{
+			Init( _targetNodeId, _msgType, _function, _bCallbackRequired, _bReplyRequired, _expectedReply, _expectedCommandClassId );
+		}
 		~Msg(){}
 
+		/**
+		 * \brief Messages are allocated from a pool of fixed size slots that are recycled rather
+		 * than returned to the heap, so that steady state traffic does not touch the allocator.
+		 */
+		static void* operator new( size_t _size );
+		static void operator delete( void* _p, size_t _size );
+
 		void SetInstance( CommandClass* _cc, uint8 const _instance );	// Used to enable wrapping with MultiInstance/MultiChannel during finalize.
 
 		void Append( uint8 const _data );
@@ -103,9 +136,9 @@ namespace OpenZWave
 //		uint8 GetExpectedIndex()const{ return m_expectedIndex; }
 		/**
 		 * \brief get the LogText Associated with this message
-		 * \return the LogText used during the constructor
+		 * \return the LogText used during the constructor, prefixed with the encapsulation details if any
 		 */
-		string GetLogText()const{ return m_logText; }
+		string GetLogText()const;
 
 		uint32 GetLength()const{ return m_encrypted == true ? m_length + 20 + 6 : m_length; }
 		uint8* GetBuffer();
@@ -125,6 +158,14 @@ namespace OpenZWave
 		{
 			return( m_bFinal && (m_length==11) && (m_buffer[3]==0x13) && (m_buffer[6]==0x00) && (m_buffer[7]==0x00) );
 		}
+		bool IsMulticast()const
+		{
+			return( m_bFinal && (m_buffer[3]==0x14) );
+		}
+		bool IsMultiCmdEncap()const
+		{
+			return( m_bFinal && (m_buffer[3]==0x13) && (m_buffer[6]==0x8f) && (m_buffer[7]==0x01) );
+		}
 
 		bool operator == ( Msg const& _other )const
 		{
@@ -172,9 +213,11 @@ namespace OpenZWave
 	private:
 
 
+		void Init( uint8 _targetNodeId, uint8 const _msgType, uint8 const _function, bool const _bCallbackRequired, bool const _bReplyRequired, uint8 const _expectedReply, uint8 const _expectedCommandClassId );
 		void MultiEncap();						// Encapsulate the data inside a MultiInstance/Multicommand message
 
-		string			m_logText;
+		char const*		m_logText;				// Description given as a string literal, or NULL if it was copied into m_logTextCopy
+		string			m_logTextCopy;			// Description that was not a literal.  Either is formatted with any encapsulation only when needed.
 		bool			m_bFinal;
 		bool			m_bCallbackRequired;
 
@@ -166,6 +166,7 @@ m_retries( 0 ),
 m_receivedCnt( 0 ),
 m_receivedDups( 0 ),
 m_receivedUnsolicited( 0 ),
+m_suppressedPolls( 0 ),
 m_lastRequestRTT( 0 ),
 m_lastResponseRTT( 0 ),
 m_averageRequestRTT( 0 ),
@@ -173,6 +174,11 @@ m_averageResponseRTT( 0 ),
 m_quality( 0 ),
 m_lastReceivedMessage(),
 m_errors( 0 ),
+m_smoothedRequestRTT( 0 ),
+m_requestRTTVariance( 0 ),
+m_smoothedResponseRTT( 0 ),
+m_responseRTTVariance( 0 ),
+m_retryBackoff( 0 ),
 m_lastnonce ( 0 )
 {
 	memset( m_neighbors, 0, sizeof(m_neighbors) );
@@ -2552,6 +2558,7 @@ void Node::ReadValueFromXML
 		if( Value* value = store->GetValue( id.GetValueStoreKey() ) )
 		{
 			value->ReadXML( m_homeId, m_nodeId, _commandClassId, _valueElement );
+			value->PublishSnapshot();
 			value->Release();
 		}
 		else
@@ -3286,12 +3293,17 @@ void Node::GetNodeStatistics
 	_data->m_receivedCnt = m_receivedCnt;
 	_data->m_receivedDups = m_receivedDups;
 	_data->m_receivedUnsolicited = m_receivedUnsolicited;
+	_data->m_suppressedPolls = m_suppressedPolls;
 	_data->m_lastRequestRTT = m_lastRequestRTT;
 	_data->m_lastResponseRTT = m_lastResponseRTT;
 	_data->m_sentTS = m_sentTS.GetAsString();
 	_data->m_receivedTS = m_receivedTS.GetAsString();
 	_data->m_averageRequestRTT = m_averageRequestRTT;
 	_data->m_averageResponseRTT = m_averageResponseRTT;
+	_data->m_smoothedRequestRTT = m_smoothedRequestRTT;
+	_data->m_requestRTTVariance = m_requestRTTVariance;
+	_data->m_smoothedResponseRTT = m_smoothedResponseRTT;
+	_data->m_responseRTTVariance = m_responseRTTVariance;
 	_data->m_quality = m_quality;
 	memcpy( _data->m_lastReceivedMessage, m_lastReceivedMessage, sizeof(m_lastReceivedMessage) );
 	for( map<uint8,CommandClass*>::const_iterator it = m_commandClassMap.begin(); it != m_commandClassMap.end(); ++it )
@@ -3304,6 +3316,72 @@ void Node::GetNodeStatistics
 	}
 }
 
+//-----------------------------------------------------------------------------
+// <Node::UpdateRTT>
+// Add a round trip time measurement to the smoothed estimate
+//-----------------------------------------------------------------------------
+void Node::UpdateRTT
+(
+		bool const _response,
+		int32 const _rtt
+)
+{
+	int32& smoothed = _response ? m_smoothedResponseRTT : m_smoothedRequestRTT;
+	int32& variance = _response ? m_responseRTTVariance : m_requestRTTVariance;
+	int32 rtt = ( _rtt > 0 ) ? _rtt : 1;
+
+	if( smoothed == 0 )
+	{
+		// First measurement
+		smoothed = rtt;
+		variance = rtt / 2;
+	}
+	else
+	{
+		int32 error = rtt - smoothed;
+		variance += ( ( error < 0 ? -error : error ) - variance ) / 4;
+		smoothed += error / 8;
+		if( smoothed <= 0 )
+		{
+			smoothed = 1;
+		}
+	}
+
+	// The node is answering again, so stop backing off
+	m_retryBackoff = 0;
+}
+
+//-----------------------------------------------------------------------------
+// <Node::GetRetryTimeout>
+// How long to wait for a message to this node to complete before resending
+// it.  Until a round trip has been measured, the longest timeout is used.
+//-----------------------------------------------------------------------------
+int32 Node::GetRetryTimeout
+(
+		bool const _response,
+		int32 const _min,
+		int32 const _max
+)const
+{
+	int32 smoothed = _response ? m_smoothedResponseRTT : m_smoothedRequestRTT;
+	int32 variance = _response ? m_responseRTTVariance : m_requestRTTVariance;
+	if( smoothed == 0 )
+	{
+		return _max;
+	}
+
+	int32 timeout = ( smoothed + 4 * variance ) << m_retryBackoff;
+	if( timeout < _min )
+	{
+		timeout = _min;
+	}
+	if( timeout > _max )
+	{
+		timeout = _max;
+	}
+	return timeout;
+}
+
 //-----------------------------------------------------------------------------
 // <DeviceClass::DeviceClass>
 // Constructor
@@ -581,12 +581,17 @@ namespace OpenZWave
 					uint32 m_receivedCnt;
 					uint32 m_receivedDups;
 					uint32 m_receivedUnsolicited;
+					uint32 m_suppressedPolls;				// Polls skipped because the value had already been refreshed
 					string m_sentTS;
 					string m_receivedTS;
 					uint32 m_lastRequestRTT;
 					uint32 m_averageRequestRTT;				// ms
 					uint32 m_lastResponseRTT;
 					uint32 m_averageResponseRTT;
+					uint32 m_smoothedRequestRTT;				// ms, as used for the adaptive retry timeout
+					uint32 m_requestRTTVariance;
+					uint32 m_smoothedResponseRTT;
+					uint32 m_responseRTTVariance;
 					uint8 m_quality;					// Node quality measure
 					uint8 m_lastReceivedMessage[254];
 					list<CommandClassData> m_ccData;
@@ -601,6 +606,7 @@ namespace OpenZWave
 			uint32 m_receivedCnt;				// Number of messages received from this node.
 			uint32 m_receivedDups;				// Number of duplicated messages received;
 			uint32 m_receivedUnsolicited;			// Number of messages received unsolicited
+			uint32 m_suppressedPolls;			// Number of polls skipped because the value had been refreshed since the last poll
 			uint32 m_lastRequestRTT;			// Last message request RTT
 			uint32 m_lastResponseRTT;			// Last message response RTT
 			TimeStamp m_sentTS;				// Last message sent time
@@ -611,6 +617,18 @@ namespace OpenZWave
 			uint8 m_lastReceivedMessage[254];		// Place to hold last received message
 			uint8 m_errors;					// Count errors for dead node detection
 
+			// Retry timeouts, estimated from the round trip times as TCP does (RFC 6298).  Requests are
+			// complete on the controller's callback, and responses when the node's report arrives.
+			void UpdateRTT( bool const _response, int32 const _rtt );	// Add a round trip time measurement to the estimate
+			int32 GetRetryTimeout( bool const _response, int32 const _min, int32 const _max )const;
+			void BackOffRetryTimeout(){ if( m_retryBackoff < 3 ) ++m_retryBackoff; }	// Double the timeout after a message timed out, up to three times (x8)
+
+			int32 m_smoothedRequestRTT;			// Smoothed request round trip time.  Zero until measured.
+			int32 m_requestRTTVariance;			// Mean deviation of the request round trip time
+			int32 m_smoothedResponseRTT;			// Smoothed response round trip time.  Zero until measured.
+			int32 m_responseRTTVariance;			// Mean deviation of the response round trip time
+			uint8 m_retryBackoff;				// Times the retry timeout has been doubled since the last measurement
+
 			//-----------------------------------------------------------------------------
 			//	Encryption Related
 			//-----------------------------------------------------------------------------
@@ -106,6 +106,8 @@ Options* Options::Create
 		s_instance->AddOptionInt(		"SaveLogLevel",				LogLevel_Detail );			// Save (to file) log messages equal to or above LogLevel_Detail
 		s_instance->AddOptionInt(		"QueueLogLevel",			LogLevel_Debug );			// Save (in RAM) log messages equal to or above LogLevel_Debug
 		s_instance->AddOptionInt(		"DumpTriggerLevel",			LogLevel_None );			// Default is to never dump RAM-stored log messages
+		s_instance->AddOptionInt(		"QueueLogDepth",			500 );						// Number of RAM-stored log messages kept for a dump
+		s_instance->AddOptionBool(		"AsyncLogging",			false );						// Format and write log messages on a background thread, so logging never waits for the disk
 
 		s_instance->AddOptionBool(		"Associate",				true );						// Enable automatic association of the controller with group one of every device.
 		s_instance->AddOptionString(	"Exclude",					string(""),		true );		// Remove support for the listed command classes.
@@ -118,17 +120,32 @@ Options* Options::Create
 		s_instance->AddOptionInt(		"PollInterval",				30000);						// 30 seconds (can easily poll 30 values in this time; ~120 values is the effective limit for 30 seconds)
 		s_instance->AddOptionBool(		"IntervalBetweenPolls",		false );					// if false, try to execute the entire poll list within the PollInterval time frame
 																								// if true, wait for PollInterval milliseconds between polls
+		s_instance->AddOptionBool(		"AdaptivePolling",		false );					// if true, values that stay the same between polls are polled less and less often
+		s_instance->AddOptionBool(		"SuppressRefreshedPolls",	false );					// if true, a polled value that the device reports by itself is not polled again until a poll interval after the report
 		s_instance->AddOptionBool(		"SuppressValueRefresh",		false );					// if true, notifications for refreshed (but unchanged) values will not be sent
 		s_instance->AddOptionBool(		"PerformReturnRoutes",		true );					// if true, return routes will be updated
+		s_instance->AddOptionBool(		"CoalesceRequests",		false );					// if true, a Get identical to one already waiting for the same node is not queued again
+		s_instance->AddOptionBool(		"FairScheduling",		false );					// if true, nodes take turns to send from each queue (see Manager::SetNodeSendWeight) rather than first come first served
+		s_instance->AddOptionBool(		"BatchRequests",		true );						// if true, consecutive Gets for a node that supports COMMAND_CLASS_MULTI_CMD are sent in one frame (see Manager::SetNodeBatchRequests)
 		s_instance->AddOptionString(	"NetworkKey", 				string(""), 			false);
 		s_instance->AddOptionBool(		"RefreshAllUserCodes",		false ); 					// if true, during startup, we refresh all the UserCodes the device reports it supports. If False, we stop after we get the first "Available" slot (Some devices have 250+ usercode slots! - That makes our Session Stage Very Long )
 		s_instance->AddOptionInt( 		"RetryTimeout", 			RETRY_TIMEOUT);				// How long do we wait to timeout messages sent
+		s_instance->AddOptionBool(		"AdaptiveRetryTimeout",	false );					// if true, each node's retry timeout follows its measured round trip times, between RetryTimeoutMin and RetryTimeout
+		s_instance->AddOptionInt( 		"RetryTimeoutMin", 		2000);						// Shortest adaptive retry timeout, in milliseconds
 		s_instance->AddOptionBool( 		"EnableSIS", 				true);						// Automatically become a SUC if there is no SUC on the network.
 		s_instance->AddOptionBool( 		"AssumeAwake", 				true);						// Assume Devices that Support the Wakeup CC are awake when we first query them....
+		s_instance->AddOptionInt( 		"WakeUpQueueLimit", 		64);						// Maximum number of messages held for a sleeping device before its state requests are dropped, or 0 for no limit.  Sets are never dropped.
+		s_instance->AddOptionBool( 		"SaveWakeUpQueue", 		false);						// Save value Sets still waiting for a sleeping device with the configuration, to be sent when it next wakes up
 		s_instance->AddOptionBool(		"NotifyOnDriverUnload",		false);						// Should we send the Node/Value Notifications on Driver Unloading - Read comments in Driver::~Driver() method about possible race conditions
 		s_instance->AddOptionString(	"SecurityStrategy", 		"SUPPORTED", 	false);		// Should we encrypt CC's that are available via both clear text and Security CC?
 		s_instance->AddOptionString(	"CustomSecuredCC", 			"0x62,0x4c,0x63", 	false);	// What List of Custom CC should we always encrypt if SecurityStrategy is CUSTOM
 		s_instance->AddOptionBool(		"EnforceSecureReception",	true);						// if we recieve a clear text message for a CC that is Secured, should we drop the message
+		s_instance->AddOptionInt(		"SimulatedNodes",			16);						// Number of nodes in the network of a simulated controller (up to 231)
+		s_instance->AddOptionInt(		"SimulatedLatency",			20);						// Time in ms for a simulated controller's radio to deliver a frame
+		s_instance->AddOptionInt(		"SimulatedLoss",			0);							// Percentage of frames that a simulated controller's nodes fail to acknowledge
+		s_instance->AddOptionInt(		"SimulatedCanRate",			0);							// Percentage of frames that a simulated controller rejects with a CAN
+		s_instance->AddOptionString(	"CaptureFile",				string(""),		false );	// Record all controller traffic to this file (in the user path) for later replay
+		s_instance->AddOptionBool(		"ReplayRealTime",			true );						// Replay captures with their original timing (false = as fast as possible)
 
 #if defined WINRT
 		s_instance->AddOptionInt(       "ThreadTerminateTimeout",   -1);						// Since threads cannot be terminated in WinRT, Thread::Terminate will simply wait for them to exit on there own
@@ -26,6 +26,7 @@
 //-----------------------------------------------------------------------------
 
 #include <cstring>
+#include <cstdlib>
 #include "Manager.h"
 #include "platform/Log.h"
 #include "value_classes/Value.h"
@@ -470,9 +471,56 @@ bool Scene::Activate
 )
 {
 	bool res = true;
-	for( vector<SceneStorage*>::iterator it = m_values.begin(); it != m_values.end(); ++it )
+	vector<bool> done( m_values.size(), false );
+	for( size_t i=0; i<m_values.size(); ++i )
 	{
-		if ( !Manager::Get()->SetValue( (*it)->m_id, (*it)->m_value ) )
+		if( done[i] )
+		{
+			continue;
+		}
+
+		// Gather the values that set the same thing to the same value on other
+		// nodes, so they can all be sent in a single multicast
+		ValueID const& id = m_values[i]->m_id;
+		vector<ValueID> ids;
+		ids.push_back( id );
+		if( ValueID::ValueType_Bool == id.GetType() || ValueID::ValueType_Byte == id.GetType() )
+		{
+			for( size_t j=i+1; j<m_values.size(); ++j )
+			{
+				ValueID const& other = m_values[j]->m_id;
+				if( !done[j] && other.GetHomeId() == id.GetHomeId() && other.GetCommandClassId() == id.GetCommandClassId()
+						&& other.GetIndex() == id.GetIndex() && other.GetType() == id.GetType() && m_values[j]->m_value == m_values[i]->m_value )
+				{
+					ids.push_back( other );
+					done[j] = true;
+				}
+			}
+		}
+
+		string const& value = m_values[i]->m_value;
+		bool set = false;
+		if( ids.size() > 1 && ValueID::ValueType_Bool == id.GetType() && ( !strcasecmp( "true", value.c_str() ) || !strcasecmp( "false", value.c_str() ) ) )
+		{
+			set = Manager::Get()->SetValues( ids, !strcasecmp( "true", value.c_str() ) );
+		}
+		else if( ids.size() > 1 && ValueID::ValueType_Byte == id.GetType() && (uint32)atoi( value.c_str() ) < 256 )
+		{
+			set = Manager::Get()->SetValues( ids, (uint8)atoi( value.c_str() ) );
+		}
+		else
+		{
+			set = true;
+			for( vector<ValueID>::iterator it = ids.begin(); it != ids.end(); ++it )
+			{
+				if( !Manager::Get()->SetValue( *it, value ) )
+				{
+					set = false;
+				}
+			}
+		}
+
+		if( !set )
 		{
 			res = false;
 		}
@@ -264,6 +264,28 @@ bool Basic::SetValue
 	return false;
 }
 
+//-----------------------------------------------------------------------------
+// <Basic::GetMulticastSet>
+// Build the command to set the level of several devices at once
+//-----------------------------------------------------------------------------
+uint8 Basic::GetMulticastSet
+(
+	uint8 const _index,
+	uint8 const _value,
+	uint8* _command
+)
+{
+	if( _index != 0 )
+	{
+		return 0;
+	}
+
+	_command[0] = GetCommandClassId();
+	_command[1] = BasicCmd_Set;
+	_command[2] = _value;
+	return 3;
+}
+
 //-----------------------------------------------------------------------------
 // <Basic::CreateVars>
 // Create the values managed by this command class
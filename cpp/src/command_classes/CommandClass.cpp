@@ -26,7 +26,6 @@
 //-----------------------------------------------------------------------------
 
 #include <math.h>
-#include <locale.h>
 #include "tinyxml.h"
 #include "command_classes/CommandClass.h"
 #include "command_classes/Basic.h"
@@ -419,7 +418,10 @@ bool CommandClass::CheckForRefreshValues (
 				for (uint32 j = 0; j < rcc->RefreshClasses.size(); j++)
 				{
 					RefreshValue *arcc = rcc->RefreshClasses.at(j);
-					Log::Write(LogLevel_Debug, GetNodeId(), "Requesting Refresh of Value: CommandClass: %s Genre %d, Instance %d, Index %d", CommandClasses::GetName(arcc->cc).c_str(), arcc->genre, arcc->instance, arcc->index);
+					if( Log::IsLevelEnabled( LogLevel_Debug ) )
+					{
+						Log::Write(LogLevel_Debug, GetNodeId(), "Requesting Refresh of Value: CommandClass: %s Genre %d, Instance %d, Index %d", CommandClasses::GetName(arcc->cc).c_str(), arcc->genre, arcc->instance, arcc->index);
+					}
 					if( CommandClass* cc = node->GetCommandClass( arcc->cc ) )
 					{
 						cc->RequestValue(arcc->genre, arcc->index, arcc->instance, Driver::MsgQueue_Send);
@@ -544,7 +546,7 @@ void CommandClass::WriteXML
 // <CommandClass::ExtractValue>
 // Read a value from a variable length sequence of bytes
 //-----------------------------------------------------------------------------
-string CommandClass::ExtractValue
+int32 CommandClass::ExtractValue
 (
 		uint8 const* _data,
 		uint8* _scale,
@@ -553,7 +555,6 @@ string CommandClass::ExtractValue
 )const
 {
 	uint8 const size = _data[0] & c_sizeMask;
-	uint8 const precision = (_data[0] & c_precisionMask) >> c_precisionShift;
 
 	if( _scale )
 	{
@@ -562,7 +563,7 @@ string CommandClass::ExtractValue
 
 	if( _precision )
 	{
-		*_precision = precision;
+		*_precision = (_data[0] & c_precisionMask) >> c_precisionShift;
 	}
 
 	uint32 value = 0;
@@ -574,11 +575,8 @@ string CommandClass::ExtractValue
 	}
 
 	// Deal with sign extension.  All values are signed
-	string res;
 	if( _data[_valueOffset] & 0x80 )
 	{
-		res = "-";
-
 		// MSB is signed
 		if( size == 1 )
 		{
@@ -590,54 +588,7 @@ string CommandClass::ExtractValue
 		}
 	}
 
-	// Convert the integer to a decimal string.  We avoid
-	// using floats to prevent accuracy issues.
-	char numBuf[12] = {0};
-
-	if( precision == 0 )
-	{
-		// The precision is zero, so we can just print the number directly into the string.
-		snprintf( numBuf, 12, "%d", (signed int)value );
-		res = numBuf;
-	}
-	else
-	{
-		// We'll need to insert a decimal point and include any necessary leading zeros.
-
-		// Fill the buffer with the value padded with leading zeros.
-		snprintf( numBuf, 12, "%011d", (signed int)value );
-
-		// Calculate the position of the decimal point in the buffer
-		int32 decimal = 10-precision;
-
-		// Shift the characters to make space for the decimal point.
-		// We don't worry about overwriting any minus sign since that is
-		// already written into the res string. While we're shifting, we
-		// also look for the real starting position of the number so we
-		// can copy it into the res string later.
-		int32 start = -1;
-		for( int32 i=0; i<decimal; ++i )
-		{
-			numBuf[i] = numBuf[i+1];
-			if( ( start<0 ) && ( numBuf[i] != '0' ) )
-			{
-				start = i;
-			}
-		}
-		if( start<0 )
-		{
-			start = decimal-1;
-		}
-
-		// Insert the decimal point
-		struct lconv const* locale = localeconv();
-		numBuf[decimal] = *(locale->decimal_point);
-
-		// Copy the buffer into res
-		res += &numBuf[start];
-	}
-
-	return res;
+	return (int32)value;
 }
 
 //-----------------------------------------------------------------------------
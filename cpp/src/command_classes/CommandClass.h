@@ -68,6 +68,7 @@ namespace OpenZWave
 		virtual bool HandleMsg( uint8 const* _data, uint32 const _length, uint32 const _instance = 1 ) = 0;
 		virtual bool SetValue( Value const& _value ){ return false; }
 		virtual void SetValueBasic( uint8 const _instance, uint8 const _level ){}		// Class specific handling of BASIC value mapping
+		virtual uint8 GetMulticastSet( uint8 const _index, uint8 const _value, uint8* _command ){ return 0; }	// Build the Set command for a bool or byte value (bools as 0 or 1) so it can be sent to several nodes at once.  Returns its length, or zero if the value cannot be set that way.
 		virtual void SetVersion( uint8 const _version ){ m_version = _version; }
 
 		bool RequestStateForAllInstances( uint32 const _requestFlags, Driver::MsgQueue const _queue );
@@ -118,7 +119,7 @@ namespace OpenZWave
 		bool IsInNIF() { return m_inNIF; }
 
 		// Helper methods
-		string ExtractValue( uint8 const* _data, uint8* _scale, uint8* _precision, uint8 _valueOffset = 1 )const;
+		int32 ExtractValue( uint8 const* _data, uint8* _scale, uint8* _precision, uint8 _valueOffset = 1 )const;	// Returns the value multiplied by ten to the power of *_precision
 
 		/**
 		 *  Append a floating-point value to a message.
@@ -134,7 +134,7 @@ bool EnergyProduction::HandleMsg
 	{
 		uint8 scale;
 		uint8 precision = 0;
-		string value = ExtractValue( &_data[2], &scale, &precision );
+		int32 reading = ExtractValue( &_data[2], &scale, &precision );
 		uint8 paramType = _data[1];
 		if (paramType > 4) /* size of  c_energyParameterNames minus Invalid Entry*/
 		{
@@ -142,14 +142,13 @@ bool EnergyProduction::HandleMsg
 			return false;
 		}
 
-		Log::Write( LogLevel_Info, GetNodeId(), "Received an Energy production report: %s = %s", c_energyParameterNames[_data[1]], value.c_str() );
+		if( Log::IsLevelEnabled( LogLevel_Info ) )
+		{
+			Log::Write( LogLevel_Info, GetNodeId(), "Received an Energy production report: %s = %s", c_energyParameterNames[_data[1]], ValueDecimal::FixedPoint( reading, precision ).ToString().c_str() );
+		}
 		if( ValueDecimal* decimalValue = static_cast<ValueDecimal*>( GetValue( _instance, _data[1] ) ) )
 		{
-			decimalValue->OnValueRefreshed( value );
-			if( decimalValue->GetPrecision() != precision )
-			{
-				decimalValue->SetPrecision( precision );
-			}
+			decimalValue->OnValueRefreshed( reading, precision );
 			decimalValue->Release();
 		}
 		return true;
@@ -380,7 +380,7 @@ bool Meter::HandleReport
 	// Get the value and scale
 	uint8 scale;
 	uint8 precision = 0;
-	string valueStr = ExtractValue( &_data[2], &scale, &precision );
+	int32 reading = ExtractValue( &_data[2], &scale, &precision );
 
 	if (scale > 7) /* size of c_electricityLabels, c_electricityUnits, c_gasUnits, c_waterUnits */
 	{
@@ -432,14 +432,13 @@ bool Meter::HandleReport
 
 		if( ValueDecimal* value = static_cast<ValueDecimal*>( GetValue( _instance, 0 ) ) )
 		{
-			Log::Write( LogLevel_Info, GetNodeId(), "Received Meter report from node %d: %s=%s%s", GetNodeId(), label.c_str(), valueStr.c_str(), units.c_str() );
-			value->SetLabel( label );
-			value->SetUnits( units );
-			value->OnValueRefreshed( valueStr );
-			if( value->GetPrecision() != precision )
+			if( Log::IsLevelEnabled( LogLevel_Info ) )
 			{
-				value->SetPrecision( precision );
+				Log::Write( LogLevel_Info, GetNodeId(), "Received Meter report from node %d: %s=%s%s", GetNodeId(), label.c_str(), ValueDecimal::FixedPoint( reading, precision ).ToString().c_str(), units.c_str() );
 			}
+			value->SetLabel( label );
+			value->SetUnits( units );
+			value->OnValueRefreshed( reading, precision );
 			value->Release();
 		}
 	}
@@ -456,12 +455,11 @@ bool Meter::HandleReport
 
 		if( ValueDecimal* value = static_cast<ValueDecimal*>( GetValue( _instance, baseIndex ) ) )
 		{
-			Log::Write( LogLevel_Info, GetNodeId(), "Received Meter report from node %d: %s%s=%s%s", GetNodeId(), exporting ? "Exporting ": "", value->GetLabel().c_str(), valueStr.c_str(), value->GetUnits().c_str() );
-			value->OnValueRefreshed( valueStr );
-			if( value->GetPrecision() != precision )
+			if( Log::IsLevelEnabled( LogLevel_Info ) )
 			{
-				value->SetPrecision( precision );
+				Log::Write( LogLevel_Info, GetNodeId(), "Received Meter report from node %d: %s%s=%s%s", GetNodeId(), exporting ? "Exporting ": "", value->GetLabel().c_str(), ValueDecimal::FixedPoint( reading, precision ).ToString().c_str(), value->GetUnits().c_str() );
 			}
+			value->OnValueRefreshed( reading, precision );
 			value->Release();
 
 			// Read any previous value and time delta
@@ -484,13 +482,12 @@ bool Meter::HandleReport
 				if( previous )
 				{
 					precision = 0;
-					valueStr = ExtractValue( &_data[2], &scale, &precision, 3+size );
-					Log::Write( LogLevel_Info, GetNodeId(), "    Previous value was %s%s, received %d seconds ago.", valueStr.c_str(), previous->GetUnits().c_str(), delta );
-					previous->OnValueRefreshed( valueStr );
-					if( previous->GetPrecision() != precision )
+					reading = ExtractValue( &_data[2], &scale, &precision, 3+size );
+					if( Log::IsLevelEnabled( LogLevel_Info ) )
 					{
-						previous->SetPrecision( precision );
+						Log::Write( LogLevel_Info, GetNodeId(), "    Previous value was %s%s, received %d seconds ago.", ValueDecimal::FixedPoint( reading, precision ).ToString().c_str(), previous->GetUnits().c_str(), delta );
 					}
+					previous->OnValueRefreshed( reading, precision );
 					previous->Release();
 				}
 
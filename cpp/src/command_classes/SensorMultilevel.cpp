@@ -307,7 +307,7 @@ bool SensorMultilevel::HandleMsg
 		uint8 scale;
 		uint8 precision = 0;
 		uint8 sensorType = _data[1];
-		string valueStr = ExtractValue( &_data[2], &scale, &precision );
+		int32 reading = ExtractValue( &_data[2], &scale, &precision );
 
 		Node* node = GetNodeUnsafe();
 		if( node != NULL )
@@ -431,12 +431,11 @@ bool SensorMultilevel::HandleMsg
 				value->SetUnits(units);
 			}
 
-			Log::Write( LogLevel_Info, GetNodeId(), "Received SensorMultiLevel report from node %d, instance %d, %s: value=%s%s", GetNodeId(), _instance, c_sensorTypeNames[sensorType], valueStr.c_str(), value->GetUnits().c_str() );
-			if( value->GetPrecision() != precision )
+			if( Log::IsLevelEnabled( LogLevel_Info ) )
 			{
-				value->SetPrecision( precision );
+				Log::Write( LogLevel_Info, GetNodeId(), "Received SensorMultiLevel report from node %d, instance %d, %s: value=%s%s", GetNodeId(), _instance, c_sensorTypeNames[sensorType], ValueDecimal::FixedPoint( reading, precision ).ToString().c_str(), value->GetUnits().c_str() );
 			}
-			value->OnValueRefreshed( valueStr );
+			value->OnValueRefreshed( reading, precision );
 			value->Release();
 			return true;
 		}
@@ -182,6 +182,21 @@ void SwitchAll::Off
 	_driver->SendMsg( msg, Driver::MsgQueue_Send );
 }
 
+//-----------------------------------------------------------------------------
+// <SwitchAll::Off>
+// Send a command to switch all devices on several nodes off
+//-----------------------------------------------------------------------------
+void SwitchAll::Off
+(
+	Driver* _driver,
+	vector<uint8> const& _nodeIds
+)
+{
+	Log::Write( LogLevel_Info, "SwitchAll::Off (%d nodes)", (int)_nodeIds.size() );
+	uint8 command[2] = { StaticGetCommandClassId(), SwitchAllCmd_Off };
+	_driver->SendMulticast( _nodeIds, vector<ValueID>(), 0, command, 2 );
+}
+
 //-----------------------------------------------------------------------------
 // <SwitchAll::On>
 // Send a command to switch all devices on
@@ -202,6 +217,21 @@ void SwitchAll::On
 	_driver->SendMsg( msg, Driver::MsgQueue_Send );
 }
 
+//-----------------------------------------------------------------------------
+// <SwitchAll::On>
+// Send a command to switch all devices on several nodes on
+//-----------------------------------------------------------------------------
+void SwitchAll::On
+(
+	Driver* _driver,
+	vector<uint8> const& _nodeIds
+)
+{
+	Log::Write( LogLevel_Info, "SwitchAll::On (%d nodes)", (int)_nodeIds.size() );
+	uint8 command[2] = { StaticGetCommandClassId(), SwitchAllCmd_On };
+	_driver->SendMulticast( _nodeIds, vector<ValueID>(), 0xff, command, 2 );
+}
+
 //-----------------------------------------------------------------------------
 // <SwitchAll::CreateVars>
 // Create the values managed by this command class
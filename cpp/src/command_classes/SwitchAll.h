@@ -47,6 +47,8 @@ namespace OpenZWave
 
 		static void On( Driver* _driver, uint8 const _nodeId );
 		static void Off( Driver* _driver, uint8 const _nodeId );
+		static void On( Driver* _driver, vector<uint8> const& _nodeIds );	// Multicast to several nodes at once
+		static void Off( Driver* _driver, vector<uint8> const& _nodeIds );
 
 		// From CommandClass
 		virtual bool RequestState( uint32 const _requestFlags, uint8 const _instance, Driver::MsgQueue const _queue );
@@ -148,6 +148,28 @@ bool SwitchBinary::SetValue
 	return false;
 }
 
+//-----------------------------------------------------------------------------
+// <SwitchBinary::GetMulticastSet>
+// Build the command to set the state of several switches at once
+//-----------------------------------------------------------------------------
+uint8 SwitchBinary::GetMulticastSet
+(
+	uint8 const _index,
+	uint8 const _value,
+	uint8* _command
+)
+{
+	if( _index != 0 )
+	{
+		return 0;
+	}
+
+	_command[0] = GetCommandClassId();
+	_command[1] = SwitchBinaryCmd_Set;
+	_command[2] = _value ? 0xff : 0x00;
+	return 3;
+}
+
 //-----------------------------------------------------------------------------
 // <SwitchBinary::SetValueBasic>
 // Update class values based in BASIC mapping
@@ -400,6 +400,29 @@ bool SwitchMultilevel::SetValue
 	return res;
 }
 
+//-----------------------------------------------------------------------------
+// <SwitchMultilevel::GetMulticastSet>
+// Build the command to set the level of several switches at once.  The
+// version 1 form is used, without a duration, since every version accepts it.
+//-----------------------------------------------------------------------------
+uint8 SwitchMultilevel::GetMulticastSet
+(
+	uint8 const _index,
+	uint8 const _value,
+	uint8* _command
+)
+{
+	if( _index != SwitchMultilevelIndex_Level )
+	{
+		return 0;
+	}
+
+	_command[0] = GetCommandClassId();
+	_command[1] = SwitchMultilevelCmd_Set;
+	_command[2] = _value;
+	return 3;
+}
+
 //-----------------------------------------------------------------------------
 // <SwitchMultilevel::SetValueBasic>
 // Update class values based in BASIC mapping
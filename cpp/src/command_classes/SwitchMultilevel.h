@@ -54,6 +54,7 @@ namespace OpenZWave
 		virtual string const GetCommandClassName()const{ return StaticGetCommandClassName(); }
 		virtual bool HandleMsg( uint8 const* _data, uint32 const _length, uint32 const _instance = 1 );
 		virtual bool SetValue( Value const& _value );
+		virtual uint8 GetMulticastSet( uint8 const _index, uint8 const _value, uint8* _command );
 		virtual void SetValueBasic( uint8 const _instance, uint8 const _value );
 		virtual void SetVersion( uint8 const _version );
 
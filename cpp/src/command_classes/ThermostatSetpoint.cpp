@@ -228,17 +228,16 @@ bool ThermostatSetpoint::HandleMsg
 		{
 			uint8 scale;
 			uint8 precision = 0;
-			string temperature = ExtractValue( &_data[2], &scale, &precision );
+			int32 temperature = ExtractValue( &_data[2], &scale, &precision );
 
 			value->SetUnits( scale ? "F" : "C" );
-			value->OnValueRefreshed( temperature );
-			if( value->GetPrecision() != precision )
-			{
-				value->SetPrecision( precision );
-			}
+			value->OnValueRefreshed( temperature, precision );
 			value->Release();
 
-			Log::Write( LogLevel_Info, GetNodeId(), "Received thermostat setpoint report: Setpoint %s = %s%s", value->GetLabel().c_str(), value->GetValue().c_str(), value->GetUnits().c_str() );
+			if( Log::IsLevelEnabled( LogLevel_Info ) )
+			{
+				Log::Write( LogLevel_Info, GetNodeId(), "Received thermostat setpoint report: Setpoint %s = %s%s", value->GetLabel().c_str(), value->GetValue().c_str(), value->GetUnits().c_str() );
+			}
 		}
 		return true;
 	}
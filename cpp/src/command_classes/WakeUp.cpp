@@ -25,6 +25,7 @@
 //
 //-----------------------------------------------------------------------------
 
+#include "tinyxml.h"
 #include "command_classes/CommandClasses.h"
 #include "command_classes/WakeUp.h"
 #include "command_classes/MultiCmd.h"
@@ -36,6 +37,7 @@
 #include "Options.h"
 #include "platform/Log.h"
 #include "platform/Mutex.h"
+#include "value_classes/Value.h"
 #include "value_classes/ValueInt.h"
 
 using namespace OpenZWave;
@@ -63,10 +65,13 @@ WakeUp::WakeUp
 ):
 CommandClass( _homeId, _nodeId ),
 m_mutex( new Mutex() ),
+m_pendingLimit( 0 ),
+m_sendingSets( false ),
 m_awake( true ),
 m_pollRequired( false )
 {
 	Options::Get()->GetOptionAsBool("AssumeAwake", &m_awake);
+	Options::Get()->GetOptionAsInt("WakeUpQueueLimit", &m_pendingLimit);
 
 	SetStaticRequest( StaticRequest_Values );
 }
@@ -95,6 +100,91 @@ WakeUp::~WakeUp
 	}
 }
 
+//-----------------------------------------------------------------------------
+// <WakeUp::ReadXML>
+// Read the value Sets that were waiting for the device to wake up
+//-----------------------------------------------------------------------------
+void WakeUp::ReadXML
+(
+	TiXmlElement const* _ccElement
+)
+{
+	CommandClass::ReadXML( _ccElement );
+
+	bool saveQueue = false;
+	Options::Get()->GetOptionAsBool( "SaveWakeUpQueue", &saveQueue );
+	if( !saveQueue )
+	{
+		return;
+	}
+
+	TiXmlElement const* child = _ccElement->FirstChildElement();
+	while( child )
+	{
+		char const* str = child->Value();
+		if( str && !strcmp( str, "PendingSet" ) )
+		{
+			int32 commandClassId, instance, index;
+			str = child->Attribute( "value" );
+			if( str != NULL
+				&& TIXML_SUCCESS == child->QueryIntAttribute( "commandclass", &commandClassId )
+				&& TIXML_SUCCESS == child->QueryIntAttribute( "instance", &instance )
+				&& TIXML_SUCCESS == child->QueryIntAttribute( "index", &index ) )
+			{
+				PendingSet set;
+				set.m_commandClassId = (uint8)commandClassId;
+				set.m_instance = (uint8)instance;
+				set.m_index = (uint8)index;
+				set.m_value = str;
+				m_pendingSets.push_back( set );
+			}
+		}
+
+		child = child->NextSiblingElement();
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <WakeUp::WriteXML>
+// Save the value Sets that are waiting for the device to wake up
+//-----------------------------------------------------------------------------
+void WakeUp::WriteXML
+(
+	TiXmlElement* _ccElement
+)
+{
+	CommandClass::WriteXML( _ccElement );
+
+	bool saveQueue = false;
+	Options::Get()->GetOptionAsBool( "SaveWakeUpQueue", &saveQueue );
+	if( !saveQueue )
+	{
+		return;
+	}
+
+	// Only Sets are worth keeping.  Requests for the device state are
+	// made again anyway when the device is next queried.
+	char str[16];
+	m_mutex->Lock();
+	for( list<PendingSet>::const_iterator it = m_pendingSets.begin(); it != m_pendingSets.end(); ++it )
+	{
+		TiXmlElement* setElement = new TiXmlElement( "PendingSet" );
+		_ccElement->LinkEndChild( setElement );
+
+		snprintf( str, sizeof(str), "%d", it->m_commandClassId );
+		setElement->SetAttribute( "commandclass", str );
+
+		snprintf( str, sizeof(str), "%d", it->m_instance );
+		setElement->SetAttribute( "instance", str );
+
+		snprintf( str, sizeof(str), "%d", it->m_index );
+		setElement->SetAttribute( "index", str );
+
+		setElement->SetAttribute( "value", it->m_value.c_str() );
+	}
+	m_mutex->Unlock();
+}
+
 //-----------------------------------------------------------------------------
 // <WakeUp::Init>
 // Starts the process of requesting node state from a sleeping device
@@ -412,9 +502,85 @@ void WakeUp::QueueMsg
 		_item.m_msg->SetSendAttempts(0);
 
 	m_pendingQueue.push_back( _item );
+
+	if( m_pendingLimit > 0 && m_pendingQueue.size() > (size_t)m_pendingLimit )
+	{
+		// Drop the oldest request for the device state.  It is made again
+		// when the device is next queried, whereas dropping a command such as
+		// a configuration or association Set would lose what the user asked
+		// for, so the queue is left over the limit if it holds no requests.
+		list<Driver::MsgQueueItem>::iterator victim = m_pendingQueue.end();
+		for( it = m_pendingQueue.begin(); it != m_pendingQueue.end(); ++it )
+		{
+			if( Driver::MsgQueueCmd_SendMsg == it->m_command && FUNC_ID_APPLICATION_COMMAND_HANDLER == it->m_msg->GetExpectedReply() )
+			{
+				victim = it;
+				break;
+			}
+		}
+
+		if( victim != m_pendingQueue.end() )
+		{
+			Log::Write( LogLevel_Warning, GetNodeId(), "Wake-up queue is full, dropping %s", victim->m_msg->GetAsString().c_str() );
+			delete victim->m_msg;
+			m_pendingQueue.erase( victim );
+		}
+		else
+		{
+			Log::Write( LogLevel_Warning, GetNodeId(), "Wake-up queue holds %d commands, more than the limit of %d", (int)m_pendingQueue.size(), m_pendingLimit );
+		}
+	}
 	m_mutex->Unlock();
 }
 
+//-----------------------------------------------------------------------------
+// <WakeUp::QueueSet>
+// Hold a value Set until the device wakes up, replacing any earlier Set of it
+//-----------------------------------------------------------------------------
+bool WakeUp::QueueSet
+(
+		Value const& _value
+)
+{
+	ValueID const& id = _value.GetID();
+	if( ValueID::ValueType_Button == id.GetType() || ValueID::ValueType_Schedule == id.GetType() )
+	{
+		// These cannot be repeated from a string, and a button press must not
+		// be replaced by its release, so their messages are queued as usual.
+		return false;
+	}
+
+	m_mutex->Lock();
+	if( m_awake )
+	{
+		m_mutex->Unlock();
+		return false;
+	}
+
+	for( list<PendingSet>::iterator it = m_pendingSets.begin(); it != m_pendingSets.end(); ++it )
+	{
+		if( it->m_commandClassId == id.GetCommandClassId() && it->m_instance == id.GetInstance() && it->m_index == id.GetIndex() )
+		{
+			m_pendingSets.erase( it );
+			break;
+		}
+	}
+
+	PendingSet set;
+	set.m_commandClassId = id.GetCommandClassId();
+	set.m_instance = id.GetInstance();
+	set.m_index = id.GetIndex();
+	set.m_value = _value.GetAsString();
+	m_pendingSets.push_back( set );
+	m_mutex->Unlock();
+
+	if( Log::IsLevelEnabled( LogLevel_Detail ) )
+	{
+		Log::Write( LogLevel_Detail, GetNodeId(), "Holding Set of %s to %s until the device wakes up", _value.GetLabel().c_str(), set.m_value.c_str() );
+	}
+	return true;
+}
+
 //-----------------------------------------------------------------------------
 // <WakeUp::SendPending>
 // The device is awake, so send all the pending messages
@@ -425,7 +591,39 @@ void WakeUp::SendPending
 {
 	m_awake = true;
 
+	// Repeat the value Sets first, in the order they were made, so that a
+	// device that does not stay awake for long still receives the changes.
+	// The messages they produce are held in the pending queue meanwhile, so
+	// that they are sent on the wake-up queue ahead of the older messages.
+	m_mutex->Lock();
+	list<PendingSet> sets;
+	sets.swap( m_pendingSets );
+	list<Driver::MsgQueueItem> older;
+	older.swap( m_pendingQueue );
+	m_sendingSets = true;
+	m_mutex->Unlock();
+
+	Node* node = GetNodeUnsafe();
+	for( list<PendingSet>::const_iterator sit = sets.begin(); sit != sets.end(); ++sit )
+	{
+		Value* value = ( node != NULL ) ? node->GetValue( sit->m_commandClassId, sit->m_instance, sit->m_index ) : NULL;
+		if( value == NULL )
+		{
+			Log::Write( LogLevel_Warning, GetNodeId(), "Dropping pending Set of unknown value %d/%d/%d", sit->m_commandClassId, sit->m_instance, sit->m_index );
+			continue;
+		}
+		Log::Write( LogLevel_Info, GetNodeId(), "Sending pending Set of %s to %s", value->GetLabel().c_str(), sit->m_value.c_str() );
+		if( !value->SetFromString( sit->m_value ) )
+		{
+			Log::Write( LogLevel_Warning, GetNodeId(), "Pending Set of %s to %s failed", value->GetLabel().c_str(), sit->m_value.c_str() );
+		}
+		value->Release();
+	}
+
 	m_mutex->Lock();
+	m_sendingSets = false;
+	m_pendingQueue.splice( m_pendingQueue.end(), older );
+
 	list<Driver::MsgQueueItem>::iterator it = m_pendingQueue.begin();
 	while( it != m_pendingQueue.end() )
 	{
@@ -448,7 +646,6 @@ void WakeUp::SendPending
 
 	// Send the device back to sleep, unless we have outstanding queries.
 	bool sendToSleep = m_awake;
-	Node* node = GetNodeUnsafe();
 	if( node != NULL )
 	{
 
@@ -35,6 +35,7 @@
 namespace OpenZWave
 {
 	class Msg;
+	class Value;
 	class ValueInt;
 	class Mutex;
 
@@ -51,12 +52,16 @@ namespace OpenZWave
 
 		void Init();	// Starts the process of requesting node state from a sleeping device.
 		void QueueMsg( Driver::MsgQueueItem const& _item );
+		bool QueueSet( Value const& _value );	// Holds a value Set until the device wakes up, replacing any earlier Set of the value but never dropped otherwise.  Returns false if the Set should be sent now instead.
 		void SendPending();
 		bool IsAwake()const{ return m_awake; }
+		bool IsHoldingMsgs()const{ return !m_awake || m_sendingSets; }	// True if messages for the device go to the pending queue
 		void SetAwake( bool _state );
 		void SetPollRequired(){ m_pollRequired = true; }
 
 		// From CommandClass
+		virtual void ReadXML( TiXmlElement const* _ccElement );
+		virtual void WriteXML( TiXmlElement* _ccElement );
 		virtual bool RequestState( uint32 const _requestFlags, uint8 const _instance, Driver::MsgQueue const _queue );
 		virtual bool RequestValue( uint32 const _requestFlags, uint8 const _index, uint8 const _instance, Driver::MsgQueue const _queue );
 		virtual uint8 const GetCommandClassId()const{ return StaticGetCommandClassId(); }
@@ -73,8 +78,19 @@ namespace OpenZWave
 	private:
 		WakeUp( uint32 const _homeId, uint8 const _nodeId );
 
-		Mutex*						m_mutex;			// Serialize access to the pending queue
+		struct PendingSet
+		{
+			uint8	m_commandClassId;
+			uint8	m_instance;
+			uint8	m_index;
+			string	m_value;	// The new value, as passed to Value::SetFromString
+		};
+
+		Mutex*						m_mutex;			// Serialize access to the pending queues
 		list<Driver::MsgQueueItem>	m_pendingQueue;		// Messages waiting to be sent when the device wakes up
+		int32						m_pendingLimit;		// Maximum number of messages in the pending queue, or zero for no limit
+		list<PendingSet>			m_pendingSets;		// Value Sets waiting for the device to wake up, one per value, oldest first
+		bool						m_sendingSets;		// SendPending is repeating the pending Sets
 		bool						m_awake;
 		bool						m_pollRequired;
 	};
@@ -0,0 +1,1176 @@
+//-----------------------------------------------------------------------------
+//
+//	AsyncLogImpl.cpp
+//
+//	Asynchronous log that formats and writes messages on a background thread
+//
+//	Copyright (c) 2016 The OpenZWave Project
+//	All rights reserved.
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+#include <iostream>
+#include "Defs.h"
+#include "platform/AsyncLogImpl.h"
+#include "platform/Thread.h"
+#include "platform/Event.h"
+#include "platform/Wait.h"
+
+#if defined WIN32 || defined WINRT
+#include <windows.h>
+#else
+#include <sys/time.h>
+#include <pthread.h>
+#endif
+
+using namespace OpenZWave;
+
+// Argument types, as determined from a printf conversion specification
+enum ArgType
+{
+	ArgType_Invalid = 0,
+	ArgType_Percent,
+	ArgType_Int,
+	ArgType_Long,
+	ArgType_LongLong,
+	ArgType_Size,
+	ArgType_Double,
+	ArgType_LongDouble,
+	ArgType_String,
+	ArgType_Pointer
+};
+
+//-----------------------------------------------------------------------------
+//	<AtomicCompareExchange>
+//	Set a value shared between threads to _new if it is still _old, with a
+//	full memory barrier.  Returns true if the value was changed.
+//-----------------------------------------------------------------------------
+static inline bool AtomicCompareExchange
+(
+	volatile uint32* _value,
+	uint32 _old,
+	uint32 _new
+)
+{
+#ifdef _MSC_VER
+	return( (uint32)InterlockedCompareExchange( (volatile LONG*)_value, (LONG)_new, (LONG)_old ) == _old );
+#else
+	return __sync_bool_compare_and_swap( _value, _old, _new );
+#endif
+}
+
+//-----------------------------------------------------------------------------
+//	<AtomicIncrement>
+//	Add one to a value shared between threads
+//-----------------------------------------------------------------------------
+static inline void AtomicIncrement
+(
+	volatile uint32* _value
+)
+{
+#ifdef _MSC_VER
+	InterlockedIncrement( (volatile LONG*)_value );
+#else
+	__sync_add_and_fetch( _value, 1 );
+#endif
+}
+
+//-----------------------------------------------------------------------------
+//	<MemoryFence>
+//	Full memory barrier
+//-----------------------------------------------------------------------------
+static inline void MemoryFence
+(
+)
+{
+#ifdef _MSC_VER
+	MemoryBarrier();
+#else
+	__sync_synchronize();
+#endif
+}
+
+//-----------------------------------------------------------------------------
+//	<GetWallClock>
+//	Read the time of day, without any formatting
+//-----------------------------------------------------------------------------
+static void GetWallClock
+(
+	uint32* _seconds,
+	uint32* _milliseconds
+)
+{
+#if defined WIN32 || defined WINRT
+	FILETIME ft;
+	GetSystemTimeAsFileTime( &ft );
+	uint64 t = ( ( (uint64)ft.dwHighDateTime ) << 32 ) | ft.dwLowDateTime;
+	t -= 116444736000000000ULL;		// 100ns intervals from 1601 to 1970
+	*_seconds = (uint32)( t / 10000000 );
+	*_milliseconds = (uint32)( ( t / 10000 ) % 1000 );
+#else
+	struct timeval tv;
+	gettimeofday( &tv, NULL );
+	*_seconds = (uint32)tv.tv_sec;
+	*_milliseconds = (uint32)( tv.tv_usec / 1000 );
+#endif
+}
+
+//-----------------------------------------------------------------------------
+//	<GetThreadId>
+//	Identify the calling thread
+//-----------------------------------------------------------------------------
+static uint64 GetThreadId
+(
+)
+{
+#if defined WIN32 || defined WINRT
+	return (uint64)GetCurrentThreadId();
+#else
+	return (uint64)pthread_self();
+#endif
+}
+
+#if !defined WIN32 && !defined WINRT
+//-----------------------------------------------------------------------------
+//	<GetEscapeCode>
+//	Console colour for a log level, as used by the unix LogImpl
+//-----------------------------------------------------------------------------
+static unsigned int GetEscapeCode
+(
+	LogLevel _level
+)
+{
+	switch( _level )
+	{
+		case LogLevel_Debug:	return 34;		// blue
+		case LogLevel_Detail:	return 34;
+		case LogLevel_Info:		return 39;		// default
+		case LogLevel_Alert:	return 33;		// orange
+		case LogLevel_Warning:	return 33;
+		case LogLevel_Error:	return 31;		// red
+		case LogLevel_Fatal:	return 95;		// magenta
+		case LogLevel_Always:	return 32;		// green
+		default:				return 39;
+	}
+}
+#endif
+
+//-----------------------------------------------------------------------------
+//	<ParseConversion>
+//	Work out the argument type of the printf conversion starting at _spec,
+//	which must point at a '%'.  Returns a pointer to the character after the
+//	conversion, and sets _numStars to the number of '*' widths and precisions,
+//	each of which takes an extra int argument.
+//-----------------------------------------------------------------------------
+static char const* ParseConversion
+(
+	char const* _spec,
+	ArgType* _type,
+	uint32* _numStars
+)
+{
+	char const* p = _spec + 1;
+	*_numStars = 0;
+	*_type = ArgType_Invalid;
+
+	if( *p == '%' )
+	{
+		*_type = ArgType_Percent;
+		return p + 1;
+	}
+
+	// Flags
+	while( *p && strchr( "-+ #0'", *p ) )
+	{
+		++p;
+	}
+
+	// Width
+	if( *p == '*' )
+	{
+		++(*_numStars);
+		++p;
+	}
+	while( *p >= '0' && *p <= '9' )
+	{
+		++p;
+	}
+
+	// Precision
+	if( *p == '.' )
+	{
+		++p;
+		if( *p == '*' )
+		{
+			++(*_numStars);
+			++p;
+		}
+		while( *p >= '0' && *p <= '9' )
+		{
+			++p;
+		}
+	}
+
+	// Length
+	ArgType intType = ArgType_Int;
+	bool bLongDouble = false;
+	switch( *p )
+	{
+		case 'h':
+		{
+			++p;
+			if( *p == 'h' )
+			{
+				++p;
+			}
+			break;
+		}
+		case 'l':
+		{
+			++p;
+			intType = ArgType_Long;
+			if( *p == 'l' )
+			{
+				++p;
+				intType = ArgType_LongLong;
+			}
+			break;
+		}
+		case 'q':
+		case 'j':
+		{
+			++p;
+			intType = ArgType_LongLong;
+			break;
+		}
+		case 'z':
+		case 't':
+		{
+			++p;
+			intType = ArgType_Size;
+			break;
+		}
+		case 'L':
+		{
+			++p;
+			bLongDouble = true;
+			break;
+		}
+	}
+
+	// Conversion
+	switch( *p )
+	{
+		case 'd':
+		case 'i':
+		case 'o':
+		case 'u':
+		case 'x':
+		case 'X':
+		case 'c':
+		{
+			*_type = intType;
+			break;
+		}
+		case 'e':
+		case 'E':
+		case 'f':
+		case 'F':
+		case 'g':
+		case 'G':
+		case 'a':
+		case 'A':
+		{
+			*_type = bLongDouble ? ArgType_LongDouble : ArgType_Double;
+			break;
+		}
+		case 's':
+		{
+			*_type = ArgType_String;
+			break;
+		}
+		case 'p':
+		{
+			*_type = ArgType_Pointer;
+			break;
+		}
+		default:
+		{
+			// Unsupported (including %n) or incomplete
+			return p;
+		}
+	}
+
+	return p + 1;
+}
+
+//-----------------------------------------------------------------------------
+//	<PackValue>
+//	Copy a value into a record's argument area, if there is room
+//-----------------------------------------------------------------------------
+template <class T>
+static bool PackValue
+(
+	T _value,
+	uint8* _buffer,
+	uint16 _bufferSize,
+	uint16* _length
+)
+{
+	if( *_length + sizeof(T) > _bufferSize )
+	{
+		return false;
+	}
+	memcpy( &_buffer[*_length], &_value, sizeof(T) );
+	*_length += sizeof(T);
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//	<UnpackValue>
+//	Read a value back out of a record's argument area
+//-----------------------------------------------------------------------------
+template <class T>
+static bool UnpackValue
+(
+	T* _value,
+	uint8 const* _buffer,
+	uint16 _bufferSize,
+	uint16* _position
+)
+{
+	if( *_position + sizeof(T) > _bufferSize )
+	{
+		return false;
+	}
+	memcpy( _value, &_buffer[*_position], sizeof(T) );
+	*_position += sizeof(T);
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//	<FormatValue>
+//	Format a single conversion with its width and precision arguments
+//-----------------------------------------------------------------------------
+template <class T>
+static int FormatValue
+(
+	char* _buffer,
+	uint32 _bufferSize,
+	char const* _spec,
+	uint32 _numStars,
+	int32 const* _stars,
+	T _value
+)
+{
+	switch( _numStars )
+	{
+		case 0:		return snprintf( _buffer, _bufferSize, _spec, _value );
+		case 1:		return snprintf( _buffer, _bufferSize, _spec, _stars[0], _value );
+		default:	return snprintf( _buffer, _bufferSize, _spec, _stars[0], _stars[1], _value );
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<AsyncLogImpl::AsyncLogImpl>
+//	Constructor
+//-----------------------------------------------------------------------------
+AsyncLogImpl::AsyncLogImpl
+(
+	string const& _filename,
+	bool const _bAppendLog,
+	bool const _bConsoleOutput,
+	LogLevel const _saveLevel,
+	LogLevel const _queueLevel,
+	LogLevel const _dumpTrigger
+):
+	m_filename( _filename ),
+	m_bConsoleOutput( _bConsoleOutput ),
+	m_bAppendLog( _bAppendLog ),
+	m_saveLevel( _saveLevel ),
+	m_queueLevel( _queueLevel ),
+	m_dumpTrigger( _dumpTrigger ),
+	pFile( NULL ),
+	m_records( new Record[c_numRecords] ),
+	m_enqueuePos( 0 ),
+	m_dequeuePos( 0 ),
+	m_dropped( 0 ),
+	m_bWriterWaiting( 0 ),
+	m_bQueueCleared( 0 ),
+	m_writerThread( new Thread( "LogWriter" ) ),
+	m_wakeEvent( new Event() ),
+	m_logQueue( 500 )
+{
+	for( uint32 i=0; i<c_numRecords; ++i )
+	{
+		m_records[i].m_sequence = i;
+	}
+
+	if( !m_filename.empty() )
+	{
+		pFile = fopen( m_filename.c_str(), m_bAppendLog ? "a" : "w" );
+		if( pFile == NULL )
+		{
+			std::cerr << "Could Not Open OZW Log File." << std::endl;
+		}
+	}
+
+	m_writerThread->Start( AsyncLogImpl::WriterThreadEntryPoint, this );
+}
+
+//-----------------------------------------------------------------------------
+//	<AsyncLogImpl::~AsyncLogImpl>
+//	Destructor
+//-----------------------------------------------------------------------------
+AsyncLogImpl::~AsyncLogImpl
+(
+)
+{
+	// The writer thread empties the queue before it exits
+	m_writerThread->Stop();
+	m_writerThread->Release();
+	m_wakeEvent->Release();
+
+	if( pFile )
+	{
+		fclose( pFile );
+	}
+	delete [] m_records;
+}
+
+//-----------------------------------------------------------------------------
+//	<AsyncLogImpl::Write>
+//	Queue a message for the writer thread
+//-----------------------------------------------------------------------------
+void AsyncLogImpl::Write
+(
+	LogLevel _logLevel,
+	uint8 const _nodeId,
+	char const* _format,
+	va_list _args
+)
+{
+	if( (_logLevel > m_queueLevel) && (_logLevel != LogLevel_Internal) )
+	{
+		// Nothing would be done with this message
+		return;
+	}
+
+	va_list args;
+	va_copy( args, _args );
+	Enqueue( RecordType_Message, _logLevel, _nodeId, _format, &args );
+	va_end( args );
+}
+
+//-----------------------------------------------------------------------------
+//	<AsyncLogImpl::QueueDump>
+//	Ask the writer thread to dump the queued messages
+//-----------------------------------------------------------------------------
+void AsyncLogImpl::QueueDump
+(
+)
+{
+	Enqueue( RecordType_QueueDump, LogLevel_Internal, 0, NULL, NULL );
+}
+
+//-----------------------------------------------------------------------------
+//	<AsyncLogImpl::QueueClear>
+//	Ask the writer thread to clear the queued messages
+//-----------------------------------------------------------------------------
+void AsyncLogImpl::QueueClear
+(
+)
+{
+	// The driver thread calls this every time round its loop, so only
+	// use up a record if something may have been queued since last time.
+	if( !m_bQueueCleared && Enqueue( RecordType_QueueClear, LogLevel_Internal, 0, NULL, NULL ) )
+	{
+		m_bQueueCleared = 1;
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<AsyncLogImpl::SetLoggingState>
+//	Sets the various log state variables
+//-----------------------------------------------------------------------------
+void AsyncLogImpl::SetLoggingState
+(
+	LogLevel _saveLevel,
+	LogLevel _queueLevel,
+	LogLevel _dumpTrigger
+)
+{
+	m_saveLevel = _saveLevel;
+	m_queueLevel = _queueLevel;
+	m_dumpTrigger = _dumpTrigger;
+}
+
+//-----------------------------------------------------------------------------
+//	<AsyncLogImpl::SetLogFileName>
+//	Switch to a new log file, once the messages already queued are written
+//-----------------------------------------------------------------------------
+void AsyncLogImpl::SetLogFileName
+(
+	const string &_filename
+)
+{
+	Enqueue( RecordType_FileName, LogLevel_Internal, 0, _filename.c_str(), NULL );
+}
+
+//-----------------------------------------------------------------------------
+//	<AsyncLogImpl::SetQueueDepth>
+//	Resize the dump queue, in order with the messages already queued
+//-----------------------------------------------------------------------------
+void AsyncLogImpl::SetQueueDepth
+(
+	uint32 _depth
+)
+{
+	char depth[16];
+	snprintf( depth, sizeof(depth), "%u", _depth );
+	Enqueue( RecordType_QueueDepth, LogLevel_Internal, 0, depth, NULL );
+}
+
+//-----------------------------------------------------------------------------
+//	<AsyncLogImpl::Enqueue>
+//	Claim a record, fill it in and pass it to the writer thread.  Returns
+//	false if the queue was full.
+//-----------------------------------------------------------------------------
+bool AsyncLogImpl::Enqueue
+(
+	RecordType _type,
+	LogLevel _level,
+	uint8 const _nodeId,
+	char const* _text,
+	va_list* _args
+)
+{
+	Record* record;
+	uint32 pos = m_enqueuePos;
+	while( true )
+	{
+		record = &m_records[pos & (c_numRecords-1)];
+		int32 diff = (int32)( record->m_sequence - pos );
+		if( diff == 0 )
+		{
+			// The record is free.  Try to claim it.
+			if( AtomicCompareExchange( &m_enqueuePos, pos, pos+1 ) )
+			{
+				break;
+			}
+		}
+		else if( diff < 0 )
+		{
+			// The writer thread has not caught up
+			AtomicIncrement( &m_dropped );
+			return false;
+		}
+		pos = m_enqueuePos;
+	}
+
+	record->m_type = (uint8)_type;
+	record->m_level = (uint8)_level;
+	record->m_nodeId = _nodeId;
+	record->m_bTruncated = 0;
+	GetWallClock( &record->m_seconds, &record->m_milliseconds );
+	record->m_threadId = GetThreadId();
+	record->m_formatLength = 0;
+	record->m_argsLength = 0;
+
+	if( _text )
+	{
+		size_t length = strlen( _text );
+		if( length > sizeof(record->m_data) - 1 )
+		{
+			length = sizeof(record->m_data) - 1;
+			record->m_bTruncated = 1;
+		}
+		memcpy( record->m_data, _text, length );
+		record->m_data[length] = 0;
+		record->m_formatLength = (uint16)length;
+
+		if( _args )
+		{
+			// Arguments are parsed against the copy, so that a format cut short
+			// above is packed and formatted consistently.
+			bool bTruncated = false;
+			record->m_argsLength = PackArgs( (char const*)record->m_data, _args, &record->m_data[length+1], (uint16)( sizeof(record->m_data) - length - 1 ), &bTruncated );
+			if( bTruncated )
+			{
+				record->m_bTruncated = 1;
+			}
+		}
+	}
+
+	// Publish the record
+	MemoryFence();
+	record->m_sequence = pos + 1;
+	MemoryFence();
+
+	if( _type == RecordType_Message && m_bQueueCleared )
+	{
+		m_bQueueCleared = 0;
+	}
+
+	// Wake the writer thread if it is waiting
+	if( m_bWriterWaiting && AtomicCompareExchange( &m_bWriterWaiting, 1, 0 ) )
+	{
+		m_wakeEvent->Set();
+	}
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//	<AsyncLogImpl::Dequeue>
+//	Get the oldest record from the queue, or NULL if it is empty.  Only
+//	called from the writer thread.
+//-----------------------------------------------------------------------------
+AsyncLogImpl::Record* AsyncLogImpl::Dequeue
+(
+)
+{
+	Record* record = &m_records[m_dequeuePos & (c_numRecords-1)];
+	int32 diff = (int32)( record->m_sequence - ( m_dequeuePos + 1 ) );
+	MemoryFence();
+	return( ( diff < 0 ) ? NULL : record );
+}
+
+//-----------------------------------------------------------------------------
+//	<AsyncLogImpl::Release>
+//	Hand a record returned by Dequeue back to the writing threads
+//-----------------------------------------------------------------------------
+void AsyncLogImpl::Release
+(
+	Record* _record
+)
+{
+	MemoryFence();
+	_record->m_sequence = m_dequeuePos + c_numRecords;
+	++m_dequeuePos;
+}
+
+//-----------------------------------------------------------------------------
+//	<AsyncLogImpl::PackArgs>
+//	Copy the arguments for a format into a buffer.  Returns the number of
+//	bytes used.
+//-----------------------------------------------------------------------------
+uint16 AsyncLogImpl::PackArgs
+(
+	char const* _format,
+	va_list* _args,
+	uint8* _buffer,
+	uint16 _bufferSize,
+	bool* _bTruncated
+)
+{
+	uint16 length = 0;
+	char const* p = _format;
+	while( *p )
+	{
+		if( *p != '%' )
+		{
+			++p;
+			continue;
+		}
+
+		ArgType type;
+		uint32 numStars;
+		p = ParseConversion( p, &type, &numStars );
+
+		bool bPacked = true;
+		for( uint32 i=0; bPacked && i<numStars; ++i )
+		{
+			bPacked = PackValue( (int32)va_arg( *_args, int ), _buffer, _bufferSize, &length );
+		}
+
+		if( bPacked )
+		{
+			switch( type )
+			{
+				case ArgType_Percent:		break;
+				case ArgType_Int:			bPacked = PackValue( va_arg( *_args, int ), _buffer, _bufferSize, &length );			break;
+				case ArgType_Long:			bPacked = PackValue( va_arg( *_args, long ), _buffer, _bufferSize, &length );			break;
+				case ArgType_LongLong:		bPacked = PackValue( va_arg( *_args, long long ), _buffer, _bufferSize, &length );		break;
+				case ArgType_Size:			bPacked = PackValue( va_arg( *_args, size_t ), _buffer, _bufferSize, &length );		break;
+				case ArgType_Double:		bPacked = PackValue( va_arg( *_args, double ), _buffer, _bufferSize, &length );			break;
+				case ArgType_LongDouble:	bPacked = PackValue( va_arg( *_args, long double ), _buffer, _bufferSize, &length );	break;
+				case ArgType_Pointer:		bPacked = PackValue( va_arg( *_args, void* ), _buffer, _bufferSize, &length );			break;
+				case ArgType_String:
+				{
+					char const* str = va_arg( *_args, char const* );
+					if( str == NULL )
+					{
+						str = "(null)";
+					}
+					size_t strLength = strlen( str );
+					if( length + strLength + 1 > _bufferSize )
+					{
+						if( length >= _bufferSize )
+						{
+							bPacked = false;
+							break;
+						}
+						// Keep as much of the string as will fit
+						strLength = _bufferSize - length - 1;
+						*_bTruncated = true;
+					}
+					memcpy( &_buffer[length], str, strLength );
+					_buffer[length+strLength] = 0;
+					length += (uint16)( strLength + 1 );
+					break;
+				}
+				default:
+				{
+					bPacked = false;
+					break;
+				}
+			}
+		}
+
+		if( !bPacked )
+		{
+			*_bTruncated = true;
+			break;
+		}
+	}
+
+	return length;
+}
+
+//-----------------------------------------------------------------------------
+//	<AsyncLogImpl::FormatRecord>
+//	Turn a record's format and packed arguments back into text
+//-----------------------------------------------------------------------------
+void AsyncLogImpl::FormatRecord
+(
+	Record const* _record,
+	char* _buffer,
+	uint32 _bufferSize
+)
+{
+	char const* format = (char const*)_record->m_data;
+	uint8 const* args = &_record->m_data[_record->m_formatLength+1];
+	uint16 argsLength = _record->m_argsLength;
+	uint16 position = 0;
+	uint32 length = 0;
+
+	char const* p = format;
+	while( *p && length < _bufferSize-1 )
+	{
+		if( *p != '%' )
+		{
+			_buffer[length++] = *p++;
+			continue;
+		}
+
+		ArgType type;
+		uint32 numStars;
+		char const* end = ParseConversion( p, &type, &numStars );
+		if( type == ArgType_Percent )
+		{
+			_buffer[length++] = '%';
+			p = end;
+			continue;
+		}
+
+		// Copy the conversion so it can be passed to snprintf on its own
+		char spec[32];
+		size_t specLength = end - p;
+		if( specLength >= sizeof(spec) )
+		{
+			break;
+		}
+		memcpy( spec, p, specLength );
+		spec[specLength] = 0;
+
+		bool bUnpacked = true;
+		int32 stars[2] = { 0, 0 };
+		for( uint32 i=0; bUnpacked && i<numStars; ++i )
+		{
+			bUnpacked = UnpackValue( &stars[i&1], args, argsLength, &position );
+		}
+
+		int written = 0;
+		char* out = &_buffer[length];
+		uint32 outSize = _bufferSize - length;
+		if( bUnpacked )
+		{
+			switch( type )
+			{
+				case ArgType_Int:
+				{
+					int value;
+					if( (bUnpacked = UnpackValue( &value, args, argsLength, &position )) )
+					{
+						written = FormatValue( out, outSize, spec, numStars, stars, value );
+					}
+					break;
+				}
+				case ArgType_Long:
+				{
+					long value;
+					if( (bUnpacked = UnpackValue( &value, args, argsLength, &position )) )
+					{
+						written = FormatValue( out, outSize, spec, numStars, stars, value );
+					}
+					break;
+				}
+				case ArgType_LongLong:
+				{
+					long long value;
+					if( (bUnpacked = UnpackValue( &value, args, argsLength, &position )) )
+					{
+						written = FormatValue( out, outSize, spec, numStars, stars, value );
+					}
+					break;
+				}
+				case ArgType_Size:
+				{
+					size_t value;
+					if( (bUnpacked = UnpackValue( &value, args, argsLength, &position )) )
+					{
+						written = FormatValue( out, outSize, spec, numStars, stars, value );
+					}
+					break;
+				}
+				case ArgType_Double:
+				{
+					double value;
+					if( (bUnpacked = UnpackValue( &value, args, argsLength, &position )) )
+					{
+						written = FormatValue( out, outSize, spec, numStars, stars, value );
+					}
+					break;
+				}
+				case ArgType_LongDouble:
+				{
+					long double value;
+					if( (bUnpacked = UnpackValue( &value, args, argsLength, &position )) )
+					{
+						written = FormatValue( out, outSize, spec, numStars, stars, value );
+					}
+					break;
+				}
+				case ArgType_Pointer:
+				{
+					void* value;
+					if( (bUnpacked = UnpackValue( &value, args, argsLength, &position )) )
+					{
+						written = FormatValue( out, outSize, spec, numStars, stars, value );
+					}
+					break;
+				}
+				case ArgType_String:
+				{
+					if( (bUnpacked = ( position < argsLength )) )
+					{
+						char const* value = (char const*)&args[position];
+						position += (uint16)( strlen( value ) + 1 );
+						written = FormatValue( out, outSize, spec, numStars, stars, value );
+					}
+					break;
+				}
+				default:
+				{
+					bUnpacked = false;
+					break;
+				}
+			}
+		}
+
+		if( !bUnpacked )
+		{
+			break;
+		}
+
+		if( written > 0 )
+		{
+			length += ( (uint32)written < outSize ) ? (uint32)written : outSize-1;
+		}
+		p = end;
+	}
+
+	if( _record->m_bTruncated && length + 4 < _bufferSize )
+	{
+		memcpy( &_buffer[length], "...", 3 );
+		length += 3;
+	}
+	_buffer[length] = 0;
+}
+
+//-----------------------------------------------------------------------------
+//	<AsyncLogImpl::WriterThreadEntryPoint>
+//	Entry point of the thread that writes the log
+//-----------------------------------------------------------------------------
+void AsyncLogImpl::WriterThreadEntryPoint
+(
+	Event* _exitEvent,
+	void* _context
+)
+{
+	AsyncLogImpl* impl = (AsyncLogImpl*)_context;
+	if( impl )
+	{
+		impl->WriterThreadProc( _exitEvent );
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<AsyncLogImpl::WriterThreadProc>
+//	Write out records as they are queued
+//-----------------------------------------------------------------------------
+void AsyncLogImpl::WriterThreadProc
+(
+	Event* _exitEvent
+)
+{
+	Wait* waitObjects[2];
+	waitObjects[0] = _exitEvent;
+	waitObjects[1] = m_wakeEvent;
+
+	uint32 reportedDrops = 0;
+	bool bExit = false;
+	while( true )
+	{
+		Record* record;
+		while( (record = Dequeue()) != NULL )
+		{
+			Output( record );
+			Release( record );
+		}
+
+		uint32 dropped = m_dropped;
+		if( dropped != reportedDrops )
+		{
+			char buffer[100];
+			snprintf( buffer, sizeof(buffer), "Log queue full, %u messages were not logged", dropped - reportedDrops );
+			reportedDrops = dropped;
+			Record warning;
+			warning.m_type = RecordType_Message;
+			warning.m_level = LogLevel_Warning;
+			warning.m_nodeId = 0;
+			warning.m_bTruncated = 0;
+			GetWallClock( &warning.m_seconds, &warning.m_milliseconds );
+			warning.m_threadId = GetThreadId();
+			warning.m_formatLength = (uint16)strlen( buffer );
+			warning.m_argsLength = 0;
+			memcpy( warning.m_data, buffer, warning.m_formatLength+1 );
+			Output( &warning );
+		}
+
+		// Output is buffered, and only flushed once the queue is empty
+		if( pFile )
+		{
+			fflush( pFile );
+		}
+		if( m_bConsoleOutput )
+		{
+			fflush( stdout );
+		}
+
+		if( bExit )
+		{
+			break;
+		}
+
+		// Tell the writing threads to wake us, then check once more that
+		// nothing arrived before they could see the flag.
+		m_bWriterWaiting = 1;
+		MemoryFence();
+		if( Dequeue() != NULL )
+		{
+			m_bWriterWaiting = 0;
+			continue;
+		}
+
+		int32 res = Wait::Multiple( waitObjects, 2 );
+		m_bWriterWaiting = 0;
+		m_wakeEvent->Reset();
+		if( res == 0 )
+		{
+			// Exit once the queue has been emptied
+			bExit = true;
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<AsyncLogImpl::Output>
+//	Act on a record taken from the queue
+//-----------------------------------------------------------------------------
+void AsyncLogImpl::Output
+(
+	Record const* _record
+)
+{
+	switch( _record->m_type )
+	{
+		case RecordType_QueueDump:
+		{
+			Dump();
+			return;
+		}
+		case RecordType_QueueClear:
+		{
+			m_logQueue.Clear();
+			return;
+		}
+		case RecordType_QueueDepth:
+		{
+			m_logQueue.SetDepth( (uint32)strtoul( (char const*)_record->m_data, NULL, 10 ) );
+			return;
+		}
+		case RecordType_FileName:
+		{
+			m_filename = (char const*)_record->m_data;
+			if( pFile )
+			{
+				fclose( pFile );
+			}
+			pFile = fopen( m_filename.c_str(), "a" );
+			return;
+		}
+		default:
+		{
+			break;
+		}
+	}
+
+	LogLevel logLevel = (LogLevel)_record->m_level;
+	if( (logLevel > m_queueLevel) && (logLevel != LogLevel_Internal) )
+	{
+		return;
+	}
+
+	char lineBuf[1024];
+	FormatRecord( _record, lineBuf, sizeof(lineBuf) );
+
+	char timeBuf[32];
+	time_t seconds = (time_t)_record->m_seconds;
+	struct tm *tm = localtime( &seconds );
+	snprintf( timeBuf, sizeof(timeBuf), "%04d-%02d-%02d %02d:%02d:%02d.%03d ",
+			tm->tm_year + 1900, tm->tm_mon + 1, tm->tm_mday,
+			tm->tm_hour, tm->tm_min, tm->tm_sec, (int)_record->m_milliseconds );
+
+	// should this message be saved to file (and possibly written to console?)
+	if( (logLevel <= m_saveLevel) || (logLevel == LogLevel_Internal) )
+	{
+		char nodeBuf[20] = "";
+		if( _record->m_nodeId == 255 )
+		{
+			snprintf( nodeBuf, sizeof(nodeBuf), "contrlr, " );
+		}
+		else if( _record->m_nodeId != 0 )
+		{
+			snprintf( nodeBuf, sizeof(nodeBuf), "Node%03d, ", _record->m_nodeId );
+		}
+
+		char outBuf[1200];
+		if( logLevel != LogLevel_Internal )
+		{
+			snprintf( outBuf, sizeof(outBuf), "%s%s, %s%s\n", timeBuf, LogLevelString[logLevel], nodeBuf, lineBuf );
+		}
+		else
+		{
+			snprintf( outBuf, sizeof(outBuf), "%s\n", lineBuf );
+		}
+
+		if( pFile != NULL )
+		{
+			fputs( outBuf, pFile );
+		}
+		if( m_bConsoleOutput )
+		{
+#if defined WIN32 || defined WINRT
+			fputs( outBuf, stdout );
+#else
+			fprintf( stdout, "\x1B[%02um", GetEscapeCode( logLevel ) );
+			fputs( outBuf, stdout );
+			fprintf( stdout, "\x1b[39m" );
+#endif
+		}
+	}
+
+	if( logLevel != LogLevel_Internal )
+	{
+		char queueBuf[1200];
+		snprintf( queueBuf, sizeof(queueBuf), "%s%08llx %s", timeBuf, (unsigned long long)_record->m_threadId, lineBuf );
+		Queue( queueBuf );
+	}
+
+	// now check to see if the _dumpTrigger has been hit
+	if( (logLevel <= m_dumpTrigger) && (logLevel != LogLevel_Internal) && (logLevel != LogLevel_Always) )
+	{
+		Dump();
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<AsyncLogImpl::Queue>
+//	Write to the log queue
+//-----------------------------------------------------------------------------
+void AsyncLogImpl::Queue
+(
+	char const* _buffer
+)
+{
+	m_logQueue.Push( _buffer );
+}
+
+//-----------------------------------------------------------------------------
+//	<AsyncLogImpl::Dump>
+//	Write out the queued messages, and empty the queue
+//-----------------------------------------------------------------------------
+void AsyncLogImpl::Dump
+(
+)
+{
+	uint32 size = m_logQueue.GetSize();
+	for( uint32 i=0; i<size+2; ++i )
+	{
+		char const* line;
+		if( i == 0 )
+		{
+			line = "\nDumping queued log messages\n";
+		}
+		else if( i == size+1 )
+		{
+			line = "\nEnd of queued log message dump\n";
+		}
+		else
+		{
+			line = m_logQueue.Get( i-1 );
+		}
+
+		if( pFile != NULL )
+		{
+			fputs( line, pFile );
+			fputs( "\n", pFile );
+		}
+		if( m_bConsoleOutput )
+		{
+			fputs( line, stdout );
+			fputs( "\n", stdout );
+		}
+	}
+	m_logQueue.Clear();
+}
@@ -0,0 +1,136 @@
+//-----------------------------------------------------------------------------
+//
+//	AsyncLogImpl.h
+//
+//	Asynchronous log that formats and writes messages on a background thread
+//
+//	Copyright (c) 2016 The OpenZWave Project
+//	All rights reserved.
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+#ifndef _AsyncLogImpl_H
+#define _AsyncLogImpl_H
+
+#include <stdio.h>
+#include <stdarg.h>
+#include "platform/Log.h"
+#include "platform/LogQueue.h"
+
+namespace OpenZWave
+{
+	class Thread;
+	class Event;
+
+	/** \brief Log implementation that keeps formatting and file output off the calling threads.
+	 *
+	 * Write copies the format string and its arguments into a fixed-size binary record,
+	 * which is added to a lock-free queue that any number of threads may write to.  A
+	 * background thread takes records off the queue, formats them and writes them to the
+	 * file and console.  The caller never waits for the disk, and never takes a lock
+	 * unless the writer thread is asleep and has to be woken.
+	 *
+	 * Arguments are captured according to the printf conversions in the format, with
+	 * strings copied into the record.  A message whose arguments do not fit in a record
+	 * is cut short, and messages written while the queue is full are dropped and
+	 * counted, so that a stalled disk can never stall the driver.
+	 */
+	class AsyncLogImpl : public i_LogImpl
+	{
+	private:
+		friend class Log;
+
+		AsyncLogImpl( string const& _filename, bool const _bAppendLog, bool const _bConsoleOutput, LogLevel const _saveLevel, LogLevel const _queueLevel, LogLevel const _dumpTrigger );
+		~AsyncLogImpl();
+
+		void Write( LogLevel _level, uint8 const _nodeId, char const* _format, va_list _args );
+		void QueueDump();
+		void QueueClear();
+		void SetLoggingState( LogLevel _saveLevel, LogLevel _queueLevel, LogLevel _dumpTrigger );
+		void SetLogFileName( const string &_filename );
+		void SetQueueDepth( uint32 _depth );
+		bool IsLockFree(){ return true; }
+
+		enum RecordType
+		{
+			RecordType_Message = 0,
+			RecordType_QueueDump,
+			RecordType_QueueClear,
+			RecordType_FileName,
+			RecordType_QueueDepth
+		};
+
+		enum
+		{
+			c_recordSize	= 512,					// Size of each record, including the header
+			c_numRecords	= 1024					// Number of records in the queue.  Must be a power of two.
+		};
+
+		struct Record
+		{
+			volatile uint32	m_sequence;				// Position in the queue this slot is ready to be written (or read) at
+			uint8			m_type;
+			uint8			m_level;
+			uint8			m_nodeId;
+			uint8			m_bTruncated;			// Arguments did not fit and were cut short
+			uint32			m_seconds;				// Wall clock time the record was written
+			uint32			m_milliseconds;
+			uint64			m_threadId;
+			uint16			m_formatLength;			// Length of the format string at the start of m_data, excluding the terminator
+			uint16			m_argsLength;			// Length of the packed arguments following the format string
+			uint8			m_data[c_recordSize - 32];
+		};
+
+		bool Enqueue( RecordType _type, LogLevel _level, uint8 const _nodeId, char const* _text, va_list* _args );
+		Record* Dequeue();
+		void Release( Record* _record );
+
+		static uint16 PackArgs( char const* _format, va_list* _args, uint8* _buffer, uint16 _bufferSize, bool* _bTruncated );
+		static void FormatRecord( Record const* _record, char* _buffer, uint32 _bufferSize );
+
+		static void WriterThreadEntryPoint( Event* _exitEvent, void* _context );
+		void WriterThreadProc( Event* _exitEvent );
+		void Output( Record const* _record );
+		void Queue( char const* _buffer );
+		void Dump();
+
+		string m_filename;						/**< filename specified by user (default is ozw_log.txt) */
+		bool m_bConsoleOutput;					/**< if true, send log output to console as well as to the file */
+		bool m_bAppendLog;						/**< if true, the log file should be appended to any with the same name */
+		volatile LogLevel m_saveLevel;
+		volatile LogLevel m_queueLevel;
+		volatile LogLevel m_dumpTrigger;
+		FILE* pFile;
+
+		Record* m_records;						/**< ring of c_numRecords preallocated records */
+		volatile uint32 m_enqueuePos;			/**< next position to be claimed by a writing thread */
+		uint32 m_dequeuePos;					/**< next position to be read by the writer thread (writer thread only) */
+		volatile uint32 m_dropped;				/**< messages dropped because the queue was full */
+		volatile uint32 m_bWriterWaiting;		/**< non-zero while the writer thread is waiting for more records */
+		volatile uint32 m_bQueueCleared;		/**< non-zero if nothing has been queued since the last QueueClear */
+
+		Thread* m_writerThread;
+		Event* m_wakeEvent;						/**< set to wake the writer thread when records are added */
+
+		LogQueue m_logQueue;					/**< ring of queued log messages (writer thread only) */
+	};
+
+} // namespace OpenZWave
+
+#endif //_AsyncLogImpl_H
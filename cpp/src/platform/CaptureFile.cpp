@@ -0,0 +1,260 @@
+//-----------------------------------------------------------------------------
+//
+//	CaptureFile.cpp
+//
+//	Cross-platform capture of the data exchanged with a controller
+//
+//	Copyright (c) 2016 The OpenZWave Project
+//	All rights reserved.
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+#include <string.h>
+#include "Defs.h"
+#include "Utils.h"
+#include "platform/CaptureFile.h"
+#include "platform/Mutex.h"
+#include "platform/Log.h"
+
+#ifdef WIN32
+#include "platform/windows/CaptureFileImpl.h"	// Platform-specific implementation of a capture file
+#elif defined WINRT
+#include "platform/winRT/CaptureFileImpl.h"	// Platform-specific implementation of a capture file
+#else
+#include "platform/unix/CaptureFileImpl.h"	// Platform-specific implementation of a capture file
+#endif
+
+using namespace OpenZWave;
+
+static uint8 const c_captureHeader[] = { 'O', 'Z', 'W', 'C', 0x01, 0x00, 0x00, 0x00 };
+
+//-----------------------------------------------------------------------------
+//	<CaptureFile::CaptureFile>
+//	Constructor
+//-----------------------------------------------------------------------------
+CaptureFile::CaptureFile
+(
+):
+	m_pImpl( new CaptureFileImpl() ),
+	m_mutex( new Mutex() ),
+	m_bWriting( false ),
+	m_lastTime( 0 ),
+	m_data( NULL ),
+	m_size( 0 ),
+	m_position( 0 )
+{
+}
+
+//-----------------------------------------------------------------------------
+//	<CaptureFile::~CaptureFile>
+//	Destructor
+//-----------------------------------------------------------------------------
+CaptureFile::~CaptureFile
+(
+)
+{
+	Close();
+	m_mutex->Release();
+	delete m_pImpl;
+}
+
+//-----------------------------------------------------------------------------
+//	<CaptureFile::Create>
+//	Create a new capture file
+//-----------------------------------------------------------------------------
+bool CaptureFile::Create
+(
+	string const& _filename
+)
+{
+	Close();
+
+	LockGuard LG( m_mutex );
+	if( !m_pImpl->Create( _filename ) )
+	{
+		Log::Write( LogLevel_Warning, "Unable to create capture file %s", _filename.c_str() );
+		return false;
+	}
+
+	m_pImpl->Write( c_captureHeader, sizeof(c_captureHeader) );
+	m_lastTime = m_pImpl->GetTime();
+	m_bWriting = true;
+	Log::Write( LogLevel_Info, "Capturing controller traffic to %s", _filename.c_str() );
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//	<CaptureFile::Record>
+//	Append a time-stamped block of data to the capture
+//-----------------------------------------------------------------------------
+void CaptureFile::Record
+(
+	Direction _direction,
+	uint8 const* _data,
+	uint32 _length
+)
+{
+	LockGuard LG( m_mutex );
+	if( !m_bWriting )
+	{
+		return;
+	}
+
+	uint64 now = m_pImpl->GetTime();
+	uint64 values[2];
+	values[0] = now - m_lastTime;
+	values[1] = ( ( (uint64)_length ) << 1 ) | (uint64)_direction;
+	m_lastTime = now;
+
+	// Two varints take at most 20 bytes
+	uint8 header[20];
+	uint32 headerLength = 0;
+	for( int32 i=0; i<2; ++i )
+	{
+		uint64 value = values[i];
+		while( value >= 0x80 )
+		{
+			header[headerLength++] = (uint8)( value | 0x80 );
+			value >>= 7;
+		}
+		header[headerLength++] = (uint8)value;
+	}
+
+	m_pImpl->Write( header, headerLength );
+	m_pImpl->Write( _data, _length );
+}
+
+//-----------------------------------------------------------------------------
+//	<CaptureFile::Load>
+//	Map an existing capture file for reading
+//-----------------------------------------------------------------------------
+bool CaptureFile::Load
+(
+	string const& _filename
+)
+{
+	Close();
+
+	m_data = m_pImpl->Map( _filename, &m_size );
+	if( !m_data )
+	{
+		Log::Write( LogLevel_Warning, "Unable to open capture file %s", _filename.c_str() );
+		return false;
+	}
+
+	if( ( m_size < sizeof(c_captureHeader) ) || memcmp( m_data, c_captureHeader, 4 ) || ( m_data[4] != c_captureHeader[4] ) )
+	{
+		Log::Write( LogLevel_Warning, "%s is not a capture file, or was written by a different version of OpenZWave", _filename.c_str() );
+		Close();
+		return false;
+	}
+
+	m_position = sizeof(c_captureHeader);
+	m_lastTime = 0;
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//	<CaptureFile::ReadRecord>
+//	Read the next record of a mapped capture
+//-----------------------------------------------------------------------------
+bool CaptureFile::ReadRecord
+(
+	uint64* _time,
+	Direction* _direction,
+	uint8 const** _data,
+	uint32* _length
+)
+{
+	if( !m_data )
+	{
+		return false;
+	}
+
+	uint32 start = m_position;
+	uint64 delta;
+	uint64 tag;
+	if( !ReadVarint( &delta ) || !ReadVarint( &tag ) || ( ( tag >> 1 ) > (uint64)( m_size - m_position ) ) )
+	{
+		if( start != m_size )
+		{
+			Log::Write( LogLevel_Warning, "Capture file is truncated or damaged at offset %d", start );
+		}
+		m_position = m_size;
+		return false;
+	}
+
+	m_lastTime += delta;
+	*_time = m_lastTime;
+	*_direction = ( tag & 0x01 ) ? Direction_Out : Direction_In;
+	*_length = (uint32)( tag >> 1 );
+	*_data = &m_data[m_position];
+	m_position += *_length;
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//	<CaptureFile::Close>
+//	Close the file
+//-----------------------------------------------------------------------------
+void CaptureFile::Close
+(
+)
+{
+	LockGuard LG( m_mutex );
+	if( m_bWriting )
+	{
+		m_pImpl->Close();
+		m_bWriting = false;
+	}
+	if( m_data )
+	{
+		m_pImpl->Unmap();
+		m_data = NULL;
+		m_size = 0;
+		m_position = 0;
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<CaptureFile::ReadVarint>
+//	Decode a varint from the mapped capture
+//-----------------------------------------------------------------------------
+bool CaptureFile::ReadVarint
+(
+	uint64* _value
+)
+{
+	uint64 value = 0;
+	for( uint32 shift=0; shift<64; shift+=7 )
+	{
+		if( m_position >= m_size )
+		{
+			return false;
+		}
+		uint8 byte = m_data[m_position++];
+		value |= ( (uint64)( byte & 0x7f ) ) << shift;
+		if( !( byte & 0x80 ) )
+		{
+			*_value = value;
+			return true;
+		}
+	}
+	return false;
+}
@@ -0,0 +1,133 @@
+//-----------------------------------------------------------------------------
+//
+//	CaptureFile.h
+//
+//	Cross-platform capture of the data exchanged with a controller
+//
+//	Copyright (c) 2016 The OpenZWave Project
+//	All rights reserved.
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+#ifndef _CaptureFile_H
+#define _CaptureFile_H
+
+#include <string>
+#include "Defs.h"
+
+namespace OpenZWave
+{
+	class CaptureFileImpl;
+	class Mutex;
+
+	/** \brief Records the bytes exchanged with a controller, or reads them back for replay.
+	 *
+	 * A capture file starts with an eight byte header ('O', 'Z', 'W', 'C', the format
+	 * version and three reserved bytes) followed by one record per read or write:
+	 * - the time since the previous record in microseconds, as a varint,
+	 * - the length of the data shifted left by one, ORed with the direction, as a varint,
+	 * - the data.
+	 * Varints are stored seven bits at a time, least significant group first, with the
+	 * top bit of each byte set if more bytes follow.  Times come from a monotonic clock.
+	 *
+	 * Captures are read through a memory mapping, so large files are never loaded into memory.
+	 */
+	class CaptureFile
+	{
+	public:
+		enum Direction
+		{
+			Direction_In = 0,								/**< Data received from the controller */
+			Direction_Out									/**< Data sent to the controller */
+		};
+
+		/**
+		 * Constructor.
+		 * Creates a capture object that is not yet attached to a file.
+		 */
+		CaptureFile();
+
+		/**
+		 * Destructor.
+		 * Closes the file, if there is one.
+		 */
+		~CaptureFile();
+
+		/**
+		 * Create a new capture file, ready for Record to be called.
+		 * \param _filename Name of the file.  Any existing file is replaced.
+		 * \return True if the file was created.
+		 * \see Record, Close
+		 */
+		bool Create( string const& _filename );
+
+		/**
+		 * Append a block of data to the capture, time-stamped with the current time.
+		 * May be called from any thread.
+		 * \param _direction Whether the data was sent to or received from the controller.
+		 * \param _data Pointer to the data.
+		 * \param _length Length of the data in bytes.
+		 * \see Create
+		 */
+		void Record( Direction _direction, uint8 const* _data, uint32 _length );
+
+		/**
+		 * Open an existing capture file for reading.
+		 * \param _filename Name of the file.
+		 * \return True if the file was mapped and has a valid header.
+		 * \see ReadRecord, Close
+		 */
+		bool Load( string const& _filename );
+
+		/**
+		 * Read the next record from a capture opened with Load.
+		 * \param _time Set to the time of the record, in microseconds since the start of the capture.
+		 * \param _direction Set to the direction of the data.
+		 * \param _data Set to point at the data, which stays valid until the file is closed.
+		 * \param _length Set to the length of the data in bytes.
+		 * \return False at the end of the capture, or if the rest of the file is damaged.
+		 * \see Load
+		 */
+		bool ReadRecord( uint64* _time, Direction* _direction, uint8 const** _data, uint32* _length );
+
+		/**
+		 * Close the file, whether it was opened by Create or Load.
+		 */
+		void Close();
+
+	private:
+		CaptureFile( CaptureFile const& );					// prevent copy
+		CaptureFile& operator = ( CaptureFile const& );		// prevent assignment
+
+		bool ReadVarint( uint64* _value );
+
+		CaptureFileImpl*	m_pImpl;				// Pointer to an object that encapsulates the platform-specific file handling and clock.
+		Mutex*				m_mutex;				// Serializes records from the read and write threads
+		bool				m_bWriting;
+		uint64				m_lastTime;				// Time of the last record written, or read
+
+		uint8 const*		m_data;					// The mapped capture, when reading
+		uint32				m_size;
+		uint32				m_position;
+	};
+
+} // namespace OpenZWave
+
+#endif //_CaptureFile_H
+
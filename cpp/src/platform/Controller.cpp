@@ -27,6 +27,7 @@
 #include "Defs.h"
 #include "Driver.h"
 #include "platform/Controller.h"
+#include "platform/CaptureFile.h"
 
 using namespace OpenZWave;
 
@@ -66,3 +67,72 @@ uint32 Controller::Read
 	return 0;
 }
 
+//-----------------------------------------------------------------------------
+//	<Controller::Put>
+//	Add data from the controller to the stream, and to the capture if there is one
+//-----------------------------------------------------------------------------
+bool Controller::Put
+(
+	uint8* _buffer,
+	uint32 _size
+)
+{
+	if( m_capture )
+	{
+		m_capture->Record( CaptureFile::Direction_In, _buffer, _size );
+	}
+	return Stream::Put( _buffer, _size );
+}
+
+//-----------------------------------------------------------------------------
+//	<Controller::StartCapture>
+//	Start recording the controller's data
+//-----------------------------------------------------------------------------
+bool Controller::StartCapture
+(
+	string const& _filename
+)
+{
+	StopCapture();
+
+	CaptureFile* capture = new CaptureFile();
+	if( !capture->Create( _filename ) )
+	{
+		delete capture;
+		return false;
+	}
+
+	m_capture = capture;
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//	<Controller::StopCapture>
+//	Stop recording the controller's data
+//-----------------------------------------------------------------------------
+void Controller::StopCapture
+(
+)
+{
+	if( m_capture )
+	{
+		delete m_capture;
+		m_capture = NULL;
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<Controller::CaptureWrite>
+//	Record data sent to the controller
+//-----------------------------------------------------------------------------
+void Controller::CaptureWrite
+(
+	uint8 const* _buffer,
+	uint32 _length
+)
+{
+	if( m_capture )
+	{
+		m_capture->Record( CaptureFile::Direction_Out, _buffer, _length );
+	}
+}
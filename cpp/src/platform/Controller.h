@@ -37,25 +37,28 @@
 namespace OpenZWave
 {
 	class Driver;
+	class CaptureFile;
 
 	class Controller: public Stream
 	{
 		// Controller is derived from Stream rather than containing one, so that
 		// we can use its Wait abilities without having to duplicate them here.
 		// The stream is used for input.  Buffering of output is handled by the OS. 
+		// Only the controller's read thread puts data into the stream, and only the
+		// driver thread takes it out, so the stream runs in its lock-free mode.
 
 	public:
 		/**
 		 * Consructor.
 		 * Creates the controller object.
 		 */
-		Controller():Stream( 2048 ){}
+		Controller():Stream( 2048, true ), m_capture( NULL ){}
 
 		/**
 		 * Destructor.
 		 * Destroys the controller object.
 		 */
-		virtual ~Controller(){}
+		virtual ~Controller(){ StopCapture(); }
 
 		/**
 		 * Queues a set of Z-Wave messages in the correct order needed to initialize the Controller implementation.
@@ -99,6 +102,42 @@ namespace OpenZWave
 		 * @see Write, Open, Close
 		 */
 		uint32 Read( uint8* _buffer, uint32 _length );
+
+		/**
+		 * Put data received from the controller into the stream.
+		 * Hides Stream::Put, so that the data is recorded if a capture is running,
+		 * whichever kind of controller it came from.
+		 * @param _buffer Pointer to a block of memory containing the data.
+		 * @param _size Length in bytes of the data.
+		 * @return True if the data was added to the stream.
+		 */
+		bool Put( uint8* _buffer, uint32 _size );
+
+		/**
+		 * Start recording all data sent to and received from the controller.
+		 * @param _filename Name of the capture file to create.
+		 * @return True if the capture file was created.
+		 * @see StopCapture, CaptureFile
+		 */
+		bool StartCapture( string const& _filename );
+
+		/**
+		 * Stop recording the controller's data, and close the capture file.
+		 * @see StartCapture
+		 */
+		void StopCapture();
+
+	protected:
+		/**
+		 * Record data sent to the controller, if a capture is running.
+		 * Must be called by the Write method of each kind of controller.
+		 * @param _buffer Pointer to a block of memory containing the data.
+		 * @param _length Length in bytes of the data.
+		 */
+		void CaptureWrite( uint8 const* _buffer, uint32 _length );
+
+	private:
+		CaptureFile*	m_capture;			// Capture file, if the controller's data is being recorded
 	};
 
 } // namespace OpenZWave
@@ -485,6 +485,7 @@ uint32 HidController::Write
 
 	Log::Write( LogLevel_Debug, "      HidController::Write (sent to controller)" );
 	LogData(_buffer, _length, "      Write: ");
+	CaptureWrite( _buffer, _length );
 
 	int bytesSent = SendFeatureReport(FEATURE_REPORT_LENGTH, hidBuffer);
 	if (bytesSent < 2)
@@ -28,8 +28,10 @@
 #include <stdarg.h>
 
 #include "Defs.h"
+#include "Options.h"
 #include "platform/Mutex.h"
 #include "platform/Log.h"
+#include "platform/AsyncLogImpl.h"
 
 #ifdef WIN32
 #include "platform/windows/LogImpl.h"	// Platform-specific implementation of a log
@@ -63,8 +65,30 @@ char const *OpenZWave::LogLevelString[] =
 
 Log* Log::s_instance = NULL;
 i_LogImpl* Log::m_pImpl = NULL;
+LogLevel Log::s_maxLevel = LogLevel_None;
+LogLevel Log::s_enabledLevel = LogLevel_None;
 static bool s_dologging;
 
+//-----------------------------------------------------------------------------
+//	<LeastSevereLevel>
+//	The least severe of the levels at which messages are saved, queued or
+//	trigger a dump.  Messages below this level are never acted upon.
+//-----------------------------------------------------------------------------
+static LogLevel LeastSevereLevel
+(
+	LogLevel _saveLevel,
+	LogLevel _queueLevel,
+	LogLevel _dumpTrigger
+)
+{
+	LogLevel level = _saveLevel;
+	if( _queueLevel > level )
+		level = _queueLevel;
+	if( _dumpTrigger > level )
+		level = _dumpTrigger;
+	return level;
+}
+
 //-----------------------------------------------------------------------------
 //	<Log::Create>
 //	Static creation of the singleton
@@ -79,16 +103,28 @@ Log* Log::Create
 	LogLevel const _dumpTrigger
 )
 {
+	// Asynchronous logging is an option rather than a parameter, so that existing
+	// applications calling Create do not need to change.  A log created while the
+	// Options are still being set up is always synchronous.
+	bool bAsync = false;
+	if( Options* options = Options::Get() )
+	{
+		options->GetOptionAsBool( "AsyncLogging", &bAsync );
+	}
+
 	if( NULL == s_instance )
 	{
-		s_instance = new Log( _filename, _bAppend, _bConsoleOutput, _saveLevel, _queueLevel, _dumpTrigger );
+		s_instance = new Log( _filename, _bAppend, _bConsoleOutput, _saveLevel, _queueLevel, _dumpTrigger, bAsync );
 		s_dologging = true; // default logging to true so no change to what people experience now
 	} else {
 		Log::Destroy();
-		s_instance = new Log( _filename, _bAppend, _bConsoleOutput, _saveLevel, _queueLevel, _dumpTrigger );
+		s_instance = new Log( _filename, _bAppend, _bConsoleOutput, _saveLevel, _queueLevel, _dumpTrigger, bAsync );
 		s_dologging = true; // default logging to true so no change to what people experience now
 	}
 
+	s_enabledLevel = LeastSevereLevel( _saveLevel, _queueLevel, _dumpTrigger );
+	s_maxLevel = s_enabledLevel;
+
 	return s_instance;
 }
 
@@ -121,6 +157,7 @@ void Log::Destroy
 (
 )
 {
+	s_maxLevel = LogLevel_None;
 	delete s_instance;
 	s_instance = NULL;
 }
@@ -156,6 +193,7 @@ void Log::SetLoggingState
 {
 	bool prevLogging = s_dologging;
 	s_dologging = _dologging;
+	s_maxLevel = ( s_instance && s_dologging ) ? s_enabledLevel : LogLevel_None;
 
 	if (!prevLogging && s_dologging) Log::Write(LogLevel_Always, "Logging started\n\n");
 }
@@ -196,7 +234,10 @@ void Log::SetLoggingState
 		s_instance->m_logMutex->Lock();
 		s_instance->m_pImpl->SetLoggingState( _saveLevel, _queueLevel, _dumpTrigger );
 		s_instance->m_logMutex->Unlock();
+
+		s_enabledLevel = LeastSevereLevel( _saveLevel, _queueLevel, _dumpTrigger );
 	}
+	s_maxLevel = ( s_instance && s_dologging ) ? s_enabledLevel : LogLevel_None;
 
 	if (!prevLogging && s_dologging) Log::Write(LogLevel_Always, "Logging started\n\n");
 }
@@ -223,14 +264,22 @@ void Log::Write
 	...
 )
 {
+	if( !IsLevelEnabled( _level ) && ( _level != LogLevel_Internal ) )
+	{
+		return;
+	}
+
 	if( s_instance && s_dologging && s_instance->m_pImpl )
 	{
-		s_instance->m_logMutex->Lock(); // double locks if recursive
+		bool bLock = !s_instance->m_pImpl->IsLockFree();
+		if( bLock )
+			s_instance->m_logMutex->Lock(); // double locks if recursive
 		va_list args;
 		va_start( args, _format );
 		s_instance->m_pImpl->Write( _level, 0, _format, args );
 		va_end( args );
-		s_instance->m_logMutex->Unlock();
+		if( bLock )
+			s_instance->m_logMutex->Unlock();
 	}
 }
 
@@ -246,15 +295,21 @@ void Log::Write
 	...
 )
 {
+	if( !IsLevelEnabled( _level ) && ( _level != LogLevel_Internal ) )
+	{
+		return;
+	}
+
 	if( s_instance && s_dologging && s_instance->m_pImpl )
 	{
-		if( _level != LogLevel_Internal )
+		bool bLock = ( _level != LogLevel_Internal ) && !s_instance->m_pImpl->IsLockFree();
+		if( bLock )
 			s_instance->m_logMutex->Lock();
 		va_list args;
 		va_start( args, _format );
 		s_instance->m_pImpl->Write( _level, _nodeId, _format, args );
 		va_end( args );
-		if( _level != LogLevel_Internal )
+		if( bLock )
 			s_instance->m_logMutex->Unlock();
 	}
 }
@@ -269,6 +324,11 @@ void Log::QueueDump
 {
 	if( s_instance && s_dologging && s_instance->m_pImpl )
 	{
+		if( s_instance->m_pImpl->IsLockFree() )
+		{
+			s_instance->m_pImpl->QueueDump();
+			return;
+		}
 		s_instance->m_logMutex->Lock();
 		s_instance->m_pImpl->QueueDump();
 		s_instance->m_logMutex->Unlock();
@@ -285,6 +345,11 @@ void Log::QueueClear
 {
 	if( s_instance && s_dologging && s_instance->m_pImpl )
 	{
+		if( s_instance->m_pImpl->IsLockFree() )
+		{
+			s_instance->m_pImpl->QueueClear();
+			return;
+		}
 		s_instance->m_logMutex->Lock();
 		s_instance->m_pImpl->QueueClear();
 		s_instance->m_logMutex->Unlock();
@@ -308,6 +373,23 @@ void Log::SetLogFileName
 	}
 }
 
+//-----------------------------------------------------------------------------
+//	<Log::SetQueueDepth>
+//	Change the number of messages kept for a queue dump
+//-----------------------------------------------------------------------------
+void Log::SetQueueDepth
+(
+	uint32 _depth
+)
+{
+	if( s_instance && s_instance->m_pImpl )
+	{
+		s_instance->m_logMutex->Lock();
+		s_instance->m_pImpl->SetQueueDepth( _depth );
+		s_instance->m_logMutex->Unlock();
+	}
+}
+
 //-----------------------------------------------------------------------------
 //	<Log::Log>
 //	Constructor
@@ -319,12 +401,18 @@ Log::Log
 	bool const _bConsoleOutput,
 	LogLevel const _saveLevel,
 	LogLevel const _queueLevel,
-	LogLevel const _dumpTrigger
+	LogLevel const _dumpTrigger,
+	bool const _bAsync
 ):
 	m_logMutex( new Mutex() )
 {
 		if (NULL == m_pImpl)
-			m_pImpl = new LogImpl( _filename, _bAppend, _bConsoleOutput, _saveLevel, _queueLevel, _dumpTrigger );
+		{
+			if( _bAsync )
+				m_pImpl = new AsyncLogImpl( _filename, _bAppend, _bConsoleOutput, _saveLevel, _queueLevel, _dumpTrigger );
+			else
+				m_pImpl = new LogImpl( _filename, _bAppend, _bConsoleOutput, _saveLevel, _queueLevel, _dumpTrigger );
+		}
 }
 
 //-----------------------------------------------------------------------------
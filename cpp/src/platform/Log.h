@@ -65,6 +65,10 @@ namespace OpenZWave
 		virtual void QueueClear() = 0;
 		virtual void SetLoggingState( LogLevel _saveLevel, LogLevel _queueLevel, LogLevel _dumpTrigger ) = 0;
 		virtual void SetLogFileName( const string &_filename ) = 0;
+		/** Return true if Write, QueueDump and QueueClear may be called from several threads at once, without the Log mutex. */
+		virtual bool IsLockFree() { return false; };
+		/** Change the number of messages kept for QueueDump. */
+		virtual void SetQueueDepth( uint32 _depth ) { };
 	};
 
 	/** \brief Implements a platform-independent log...written to the console and, optionally, a file.
@@ -76,6 +80,8 @@ namespace OpenZWave
 		 * Create a log.
 		 * Creates the cross-platform logging singleton.
 		 * Any previous log will be cleared.
+		 * If the AsyncLogging option is set, messages are formatted and written on a background
+		 * thread, so that writing to the log never waits for the disk.
 		 * \return a pointer to the logging object.
 		 * \see Destroy, Write
 		 */
@@ -136,6 +142,15 @@ namespace OpenZWave
 		*/
 		static void GetLoggingState( LogLevel* _saveLevel, LogLevel* _queueLevel, LogLevel* _dumpTrigger );
 
+		/**
+		 * \brief Determine whether a message at the given level would be saved or queued.
+		 * Callers can use this to avoid building text for a message that will be thrown away.
+		 * It takes no locks, and is cheap enough to call anywhere.
+		 * \param _level	LogLevel of the message
+		 * \return True if a message at this level would be logged.
+		*/
+		static bool IsLevelEnabled( LogLevel _level ){ return( _level <= s_maxLevel ); }
+
 		/**
 		 * \brief Change the log file name.  This will start a new log file (or potentially start appending
 		 * information to an existing one.  Developers might want to use this function, together with a timer
@@ -144,6 +159,14 @@ namespace OpenZWave
 		*/
 		static void SetLogFileName( const string &_filename );
 
+		/**
+		 * \brief Change the number of messages kept in memory to be dumped in case of an error.
+		 * The space for them is allocated once, here, rather than as messages are queued.
+		 * Any messages already queued are discarded.
+		 * \param _depth Number of messages to keep.
+		*/
+		static void SetQueueDepth( uint32 _depth );
+
 		/**
 		 * Write an entry to the log.
 		 * Writes a formatted string to the log.
@@ -176,11 +199,13 @@ namespace OpenZWave
 		static void QueueClear();
 
 	private:
-		Log( string const& _filename, bool const _bAppend, bool const _bConsoleOutput, LogLevel _saveLevel, LogLevel _queueLevel, LogLevel _dumpTrigger );
+		Log( string const& _filename, bool const _bAppend, bool const _bConsoleOutput, LogLevel _saveLevel, LogLevel _queueLevel, LogLevel _dumpTrigger, bool const _bAsync );
 		~Log();
 
 		static i_LogImpl*	m_pImpl;		/**< Pointer to an object that encapsulates the platform-specific logging implementation. */
 		static Log*	s_instance;
+		static LogLevel	s_maxLevel;			/**< Least severe level that is currently logged, or LogLevel_None */
+		static LogLevel	s_enabledLevel;		/**< Least severe level that is logged while logging is enabled */
 		Mutex*		m_logMutex;
 	};
 } // namespace OpenZWave
@@ -0,0 +1,188 @@
+//-----------------------------------------------------------------------------
+//
+//	LogQueue.cpp
+//
+//	Fixed-size ring of recent log lines, kept for dumping after an error
+//
+//	Copyright (c) 2016 The OpenZWave Project
+//	All rights reserved.
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+#include <string.h>
+#include "Defs.h"
+#include "platform/LogQueue.h"
+
+using namespace OpenZWave;
+
+//-----------------------------------------------------------------------------
+//	<LogQueue::LogQueue>
+//	Constructor
+//-----------------------------------------------------------------------------
+LogQueue::LogQueue
+(
+	uint32 _depth
+):
+	m_buffer( NULL ),
+	m_bufferSize( 0 ),
+	m_offsets( NULL ),
+	m_depth( 0 ),
+	m_head( 0 ),
+	m_size( 0 ),
+	m_writePos( 0 )
+{
+	SetDepth( _depth );
+}
+
+//-----------------------------------------------------------------------------
+//	<LogQueue::~LogQueue>
+//	Destructor
+//-----------------------------------------------------------------------------
+LogQueue::~LogQueue
+(
+)
+{
+	delete [] m_buffer;
+	delete [] m_offsets;
+}
+
+//-----------------------------------------------------------------------------
+//	<LogQueue::SetDepth>
+//	Allocate space for the requested number of lines
+//-----------------------------------------------------------------------------
+void LogQueue::SetDepth
+(
+	uint32 _depth
+)
+{
+	if( _depth != m_depth )
+	{
+		delete [] m_buffer;
+		delete [] m_offsets;
+		m_buffer = NULL;
+		m_offsets = NULL;
+		m_bufferSize = 0;
+		if( _depth )
+		{
+			// Always leave room for one line of the maximum length
+			m_bufferSize = _depth * c_averageLineSize;
+			if( m_bufferSize < c_maxLineSize )
+			{
+				m_bufferSize = c_maxLineSize;
+			}
+			m_buffer = new char[m_bufferSize];
+			m_offsets = new uint32[_depth];
+		}
+		m_depth = _depth;
+	}
+	m_head = 0;
+	m_size = 0;
+	m_writePos = 0;
+}
+
+//-----------------------------------------------------------------------------
+//	<LogQueue::Push>
+//	Copy a line in after the newest one
+//-----------------------------------------------------------------------------
+void LogQueue::Push
+(
+	char const* _line
+)
+{
+	if( !m_depth )
+	{
+		return;
+	}
+
+	size_t length = strlen( _line );
+	if( length > c_maxLineSize - 1 )
+	{
+		length = c_maxLineSize - 1;
+	}
+	uint32 needed = (uint32)length + 1;
+
+	if( m_size == m_depth )
+	{
+		DiscardOldest();
+	}
+
+	// A line is never split.  If it does not fit before the end of the buffer, it goes
+	// at the start, and the lines left in the rest of the buffer, which are the oldest,
+	// are discarded.
+	uint32 pos = m_writePos;
+	if( pos + needed > m_bufferSize )
+	{
+		while( m_size && ( m_offsets[Slot( 0 )] >= pos ) )
+		{
+			DiscardOldest();
+		}
+		pos = 0;
+	}
+
+	// Discard the oldest lines until there is room
+	while( m_size && ( m_offsets[Slot( 0 )] >= pos ) && ( m_offsets[Slot( 0 )] < pos + needed ) )
+	{
+		DiscardOldest();
+	}
+
+	memcpy( &m_buffer[pos], _line, length );
+	m_buffer[pos + length] = 0;
+	m_offsets[m_head] = pos;
+	m_writePos = pos + needed;
+
+	if( ++m_head == m_depth )
+	{
+		m_head = 0;
+	}
+	++m_size;
+}
+
+//-----------------------------------------------------------------------------
+//	<LogQueue::Get>
+//	Get a line, counting from the oldest
+//-----------------------------------------------------------------------------
+char const* LogQueue::Get
+(
+	uint32 _index
+)const
+{
+	if( _index >= m_size )
+	{
+		return "";
+	}
+
+	return &m_buffer[m_offsets[Slot( _index )]];
+}
+
+//-----------------------------------------------------------------------------
+//	<LogQueue::Slot>
+//	Offset slot of a line, counting from the oldest
+//-----------------------------------------------------------------------------
+uint32 LogQueue::Slot
+(
+	uint32 _index
+)const
+{
+	uint32 slot = m_head + m_depth - m_size + _index;
+	if( slot >= m_depth )
+	{
+		slot -= m_depth;
+	}
+	return slot;
+}
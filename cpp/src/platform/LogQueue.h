@@ -0,0 +1,117 @@
+//-----------------------------------------------------------------------------
+//
+//	LogQueue.h
+//
+//	Fixed-size ring of recent log lines, kept for dumping after an error
+//
+//	Copyright (c) 2016 The OpenZWave Project
+//	All rights reserved.
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+#ifndef _LogQueue_H
+#define _LogQueue_H
+
+#include "Defs.h"
+
+namespace OpenZWave
+{
+	/** \brief A ring of the most recent log lines, for the log implementations to dump when an error occurs.
+	 *
+	 * All the memory is allocated up front: a byte ring that holds the lines end to end, each
+	 * taking only its own length, and a ring of the offsets where they start.  Adding a line
+	 * copies it in after the newest one, discarding the oldest lines to make room.  Nothing is
+	 * allocated or freed after the ring is created, so queueing every message at a verbose
+	 * level costs no more than a copy.
+	 *
+	 * The byte ring allows c_averageLineSize bytes per line of depth, so a run of long lines
+	 * can leave fewer than depth lines queued.  A depth of 500 takes about 66 KB, and a depth
+	 * of 10000 about 1.3 MB.
+	 *
+	 * Not thread safe.  Each log implementation serializes its own access.
+	 */
+	class LogQueue
+	{
+	public:
+		enum
+		{
+			c_maxLineSize = 1200,					/**< Longest line kept, including the terminator.  Matches the longest line the log implementations queue. */
+			c_averageLineSize = 128					/**< Bytes allowed for each line of depth.  Queued lines average about 80. */
+		};
+
+		/**
+		 * Constructor.
+		 * \param _depth Maximum number of lines to keep.  Zero disables the queue.
+		 */
+		LogQueue( uint32 _depth );
+
+		/**
+		 * Destructor.
+		 */
+		~LogQueue();
+
+		/**
+		 * Change the number of lines kept.  Any lines already queued are discarded.
+		 * \param _depth Maximum number of lines to keep.  Zero disables the queue.
+		 */
+		void SetDepth( uint32 _depth );
+
+		/**
+		 * Add a line, discarding the oldest ones if there is no room for it.  A line
+		 * longer than c_maxLineSize is cut short.
+		 * \param _line The text to add.
+		 */
+		void Push( char const* _line );
+
+		/**
+		 * Number of lines currently queued.
+		 */
+		uint32 GetSize()const{ return m_size; }
+
+		/**
+		 * Get a queued line.
+		 * \param _index Index of the line, where zero is the oldest.
+		 * \return Pointer to the text, which stays valid until the line is overwritten.
+		 */
+		char const* Get( uint32 _index )const;
+
+		/**
+		 * Discard all the queued lines.
+		 */
+		void Clear(){ m_size = 0; }
+
+	private:
+		LogQueue( LogQueue const& );					// prevent copy
+		LogQueue& operator = ( LogQueue const& );		// prevent assignment
+
+		uint32 Slot( uint32 _index )const;				// Offset slot of a line, where zero is the oldest
+		void DiscardOldest(){ --m_size; }
+
+		char*	m_buffer;							// The text of the lines, end to end
+		uint32	m_bufferSize;
+		uint32*	m_offsets;							// m_depth offsets into m_buffer, one for each line
+		uint32	m_depth;
+		uint32	m_head;								// Offset slot for the next line
+		uint32	m_size;								// Number of lines in the ring
+		uint32	m_writePos;							// Position in m_buffer after the newest line
+	};
+
+} // namespace OpenZWave
+
+#endif //_LogQueue_H
@@ -0,0 +1,260 @@
+//-----------------------------------------------------------------------------
+//
+//	ReplayController.cpp
+//
+//	Controller that plays back a capture of a real controller's traffic
+//
+//	Copyright (c) 2016 The OpenZWave Project
+//	All rights reserved.
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+#include "Defs.h"
+#include "Options.h"
+#include "platform/ReplayController.h"
+#include "platform/CaptureFile.h"
+#include "platform/Thread.h"
+#include "platform/Event.h"
+#include "platform/Mutex.h"
+#include "platform/TimeStamp.h"
+#include "platform/Log.h"
+
+using namespace OpenZWave;
+
+//-----------------------------------------------------------------------------
+//	<ReplayController::ReplayController>
+//	Constructor
+//-----------------------------------------------------------------------------
+ReplayController::ReplayController
+(
+):
+	m_bOpen( false ),
+	m_bRealTime( true ),
+	m_bInStep( true ),
+	m_replay( new CaptureFile() ),
+	m_thread( NULL ),
+	m_writeEvent( new Event() ),
+	m_writeMutex( new Mutex() ),
+	m_bytesWritten( 0 )
+{
+}
+
+//-----------------------------------------------------------------------------
+//	<ReplayController::~ReplayController>
+//	Destructor
+//-----------------------------------------------------------------------------
+ReplayController::~ReplayController
+(
+)
+{
+	Close();
+	delete m_replay;
+	m_writeEvent->Release();
+	m_writeMutex->Release();
+}
+
+//-----------------------------------------------------------------------------
+//	<ReplayController::Open>
+//	Open the capture file and start the replay thread
+//-----------------------------------------------------------------------------
+bool ReplayController::Open
+(
+	string const& _controllerName
+)
+{
+	if( m_bOpen )
+	{
+		return false;
+	}
+
+	m_filename = _controllerName;
+	if( !m_replay->Load( m_filename ) )
+	{
+		return false;
+	}
+
+	Options::Get()->GetOptionAsBool( "ReplayRealTime", &m_bRealTime );
+	Log::Write( LogLevel_Info, "Replaying capture %s %s", m_filename.c_str(), m_bRealTime ? "in real time" : "as fast as possible" );
+
+	m_bInStep = true;
+	m_bytesWritten = 0;
+	m_writeEvent->Reset();
+
+	m_thread = new Thread( "ReplayController" );
+	m_thread->Start( ReplayThreadEntryPoint, this );
+
+	m_bOpen = true;
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//	<ReplayController::Close>
+//	Stop the replay thread and close the capture file
+//-----------------------------------------------------------------------------
+bool ReplayController::Close
+(
+)
+{
+	if( !m_bOpen )
+	{
+		return false;
+	}
+
+	m_thread->Stop();
+	m_thread->Release();
+	m_thread = NULL;
+	m_replay->Close();
+
+	m_bOpen = false;
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//	<ReplayController::Write>
+//	Count the bytes written by the driver
+//-----------------------------------------------------------------------------
+uint32 ReplayController::Write
+(
+	uint8* _buffer,
+	uint32 _length
+)
+{
+	if( !m_bOpen )
+	{
+		return 0;
+	}
+
+	Log::Write( LogLevel_StreamDetail, "      ReplayController::Write (sent to controller)" );
+	LogData(_buffer, _length, "      Write: ");
+	CaptureWrite( _buffer, _length );
+
+	m_writeMutex->Lock();
+	m_bytesWritten += _length;
+	m_writeMutex->Unlock();
+	m_writeEvent->Set();
+	return _length;
+}
+
+//-----------------------------------------------------------------------------
+//	<ReplayController::ReplayThreadEntryPoint>
+//	Entry point of the replay thread
+//-----------------------------------------------------------------------------
+void ReplayController::ReplayThreadEntryPoint
+(
+	Event* _exitEvent,
+	void* _context
+)
+{
+	ReplayController* controller = (ReplayController*)_context;
+	if( controller )
+	{
+		controller->ReplayThreadProc( _exitEvent );
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<ReplayController::ReplayThreadProc>
+//	Deliver the received data in the capture to the driver
+//-----------------------------------------------------------------------------
+void ReplayController::ReplayThreadProc
+(
+	Event* _exitEvent
+)
+{
+	TimeStamp start;
+	uint64 time;
+	CaptureFile::Direction direction;
+	uint8 const* data;
+	uint32 length;
+	uint64 bytesWritten = 0;
+	uint32 records = 0;
+
+	while( m_replay->ReadRecord( &time, &direction, &data, &length ) )
+	{
+		if( CaptureFile::Direction_Out == direction )
+		{
+			bytesWritten += length;
+			continue;
+		}
+
+		// Don't answer the driver before it has asked
+		if( !WaitForDriver( _exitEvent, bytesWritten ) )
+		{
+			return;
+		}
+
+		if( m_bRealTime )
+		{
+			int32 delay = (int32)( time / 1000 ) + start.TimeRemaining();
+			if( ( delay > 0 ) && ( Wait::Single( _exitEvent, delay ) >= 0 ) )
+			{
+				return;
+			}
+		}
+
+		Put( (uint8*)data, length );
+		++records;
+	}
+
+	Log::Write( LogLevel_Info, "Replay of %s complete (%d blocks received in %dms)", m_filename.c_str(), records, -start.TimeRemaining() );
+	Wait::Single( _exitEvent );
+}
+
+//-----------------------------------------------------------------------------
+//	<ReplayController::WaitForDriver>
+//	Wait until the driver has written the given number of bytes.
+//	Returns false if the thread must exit.
+//-----------------------------------------------------------------------------
+bool ReplayController::WaitForDriver
+(
+	Event* _exitEvent,
+	uint64 _bytesWritten
+)
+{
+	Wait* waitObjects[2];
+	waitObjects[0] = _exitEvent;			// Thread must exit.
+	waitObjects[1] = m_writeEvent;			// The driver has written something.
+
+	while( m_bInStep )
+	{
+		m_writeEvent->Reset();
+
+		m_writeMutex->Lock();
+		bool caughtUp = ( m_bytesWritten >= _bytesWritten );
+		m_writeMutex->Unlock();
+		if( caughtUp )
+		{
+			break;
+		}
+
+		int32 res = Wait::Multiple( waitObjects, 2, RETRY_TIMEOUT );
+		if( res == 0 )
+		{
+			return false;
+		}
+		if( res < 0 )
+		{
+			// The driver has not sent what it sent during the capture, so stop
+			// trying to keep in step and deliver the rest as it comes.
+			Log::Write( LogLevel_Warning, "Replay of %s is out of step with the driver, which has written %d bytes rather than %d", m_filename.c_str(), (uint32)m_bytesWritten, (uint32)_bytesWritten );
+			m_bInStep = false;
+		}
+	}
+	return true;
+}
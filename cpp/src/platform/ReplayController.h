@@ -0,0 +1,117 @@
+//-----------------------------------------------------------------------------
+//
+//	ReplayController.h
+//
+//	Controller that plays back a capture of a real controller's traffic
+//
+//	Copyright (c) 2016 The OpenZWave Project
+//	All rights reserved.
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+#ifndef _ReplayController_H
+#define _ReplayController_H
+
+#include <string>
+#include "Defs.h"
+#include "platform/Controller.h"
+
+namespace OpenZWave
+{
+	class Driver;
+	class Thread;
+	class Event;
+	class Mutex;
+	class CaptureFile;
+
+	/** \brief A controller that feeds a capture file back to the driver.
+	 *
+	 * The controller path is the name of a file written with the CaptureFile option.
+	 * Data that the controller sent is put into the stream, as if it had just arrived,
+	 * and data that the driver sent is used to keep the replay in step: a block of
+	 * received data is only delivered once the driver has written at least as many
+	 * bytes as it had at that point in the capture.
+	 * This only works if the driver starts from the same state as it did when the
+	 * capture was made, so the replay should be run without a zwcfg file that was
+	 * written after the capture.
+	 *
+	 * If the ReplayRealTime option is set (the default), each block is also held back
+	 * until the same time has passed as in the capture.  Otherwise the capture is
+	 * replayed as fast as the driver can take it.
+	 */
+	class ReplayController: public Controller
+	{
+	public:
+		/**
+		 * Constructor.
+		 * Creates an object that replays a capture file.
+		 */
+		ReplayController();
+
+		/**
+		 * Destructor.
+		 * Destroys the replay controller object.
+		 */
+		virtual ~ReplayController();
+
+		/**
+		 * Open a capture file and start replaying it.
+		 * @param _controllerName Name of the capture file.
+		 * @return True if the file was opened.
+		 * @see Close, Write
+		 */
+		bool Open( string const& _controllerName );
+
+		/**
+		 * Stop the replay and close the capture file.
+		 * @return True if the replay was stopped, or false if it was not running.
+		 * @see Open
+		 */
+		bool Close();
+
+		/**
+		 * Accept data from the driver.
+		 * The data itself is discarded.  Only the number of bytes is used, to pace the replay.
+		 * @param _buffer Pointer to a block of memory containing the data to be written.
+		 * @param _length Length in bytes of the data.
+		 * @return The number of bytes written.
+		 * @see Open, Close
+		 */
+		uint32 Write( uint8* _buffer, uint32 _length );
+
+	private:
+		static void ReplayThreadEntryPoint( Event* _exitEvent, void* _context );
+		void ReplayThreadProc( Event* _exitEvent );
+		bool WaitForDriver( Event* _exitEvent, uint64 _bytesWritten );
+
+		string			m_filename;
+		bool			m_bOpen;
+		bool			m_bRealTime;				// Replay with the timing of the capture
+		bool			m_bInStep;					// False once the driver has stopped following the capture
+		CaptureFile*	m_replay;
+		Thread*			m_thread;
+		Event*			m_writeEvent;				// Set whenever the driver writes
+		Mutex*			m_writeMutex;
+		uint64			m_bytesWritten;				// Number of bytes the driver has written
+	};
+
+} // namespace OpenZWave
+
+#endif //_ReplayController_H
+
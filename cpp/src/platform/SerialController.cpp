@@ -179,6 +179,7 @@ uint32 SerialController::Write
 
 	Log::Write( LogLevel_StreamDetail, "      SerialController::Write (sent to controller)" );
 	LogData(_buffer, _length, "      Write: ");
+	CaptureWrite( _buffer, _length );
 
 	return( m_pImpl->Write( _buffer, _length ) );
 }
@@ -0,0 +1,996 @@
+//-----------------------------------------------------------------------------
+//
+//	SimulatedController.cpp
+//
+//	Emulation of a Z-Wave controller and its network, for running without hardware
+//
+//	Copyright (c) 2016 The OpenZWave Project
+//	All rights reserved.
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+#include <string.h>
+#include "Defs.h"
+#include "Options.h"
+#include "platform/SimulatedController.h"
+#include "platform/Thread.h"
+#include "platform/Event.h"
+#include "platform/TimeStamp.h"
+#include "platform/Log.h"
+
+#include "command_classes/Basic.h"
+#include "command_classes/SwitchAll.h"
+#include "command_classes/SwitchBinary.h"
+#include "command_classes/SwitchMultilevel.h"
+#include "command_classes/SensorMultilevel.h"
+#include "command_classes/ManufacturerSpecific.h"
+#include "command_classes/Version.h"
+#include "command_classes/MultiCmd.h"
+
+using namespace OpenZWave;
+
+static uint32 const c_homeId = 0xc0de0001;
+static uint8 const c_controllerNodeId = 1;
+
+// Serial API functions that the simulated controller answers.
+// They are reported to the driver in FUNC_ID_SERIAL_API_GET_CAPABILITIES.
+static uint8 const c_supportedFunctions[] =
+{
+	FUNC_ID_SERIAL_API_GET_INIT_DATA,
+	FUNC_ID_SERIAL_API_APPL_NODE_INFORMATION,
+	FUNC_ID_ZW_GET_CONTROLLER_CAPABILITIES,
+	FUNC_ID_SERIAL_API_SET_TIMEOUTS,
+	FUNC_ID_SERIAL_API_GET_CAPABILITIES,
+	FUNC_ID_ZW_SEND_DATA,
+	FUNC_ID_ZW_SEND_DATA_MULTI,
+	FUNC_ID_ZW_GET_VERSION,
+	FUNC_ID_ZW_MEMORY_GET_ID,
+	FUNC_ID_ZW_GET_NODE_PROTOCOL_INFO,
+	FUNC_ID_ZW_GET_SUC_NODE_ID,
+	FUNC_ID_ZW_REQUEST_NODE_INFO,
+	FUNC_ID_ZW_IS_FAILED_NODE_ID,
+	FUNC_ID_ZW_GET_ROUTING_INFO
+};
+
+// Commands understood by the simulated nodes
+enum
+{
+	BasicCmd_Set							= 0x01,
+	BasicCmd_Get							= 0x02,
+	BasicCmd_Report							= 0x03,
+	SwitchCmd_Set							= 0x01,
+	SwitchCmd_Get							= 0x02,
+	SwitchCmd_Report						= 0x03,
+	SwitchAllCmd_Get						= 0x02,
+	SwitchAllCmd_Report						= 0x03,
+	SensorMultilevelCmd_Get					= 0x04,
+	SensorMultilevelCmd_Report				= 0x05,
+	ManufacturerSpecificCmd_Get				= 0x04,
+	ManufacturerSpecificCmd_Report			= 0x05,
+	VersionCmd_Get							= 0x11,
+	VersionCmd_Report						= 0x12,
+	VersionCmd_CommandClassGet				= 0x13,
+	VersionCmd_CommandClassReport			= 0x14,
+	MultiCmdCmd_Encap						= 0x01
+};
+
+//-----------------------------------------------------------------------------
+//	<SimulatedController::SimulatedController>
+//	Constructor
+//-----------------------------------------------------------------------------
+SimulatedController::SimulatedController
+(
+):
+	m_bOpen( false ),
+	m_thread( NULL ),
+	m_hostStream( new Stream( 2048, true ) ),
+	m_epoch( new TimeStamp() ),
+	m_rxLength( 0 ),
+	m_radioFree( 0 ),
+	m_numNodes( 0 ),
+	m_latency( 0 ),
+	m_loss( 0 ),
+	m_canRate( 0 ),
+	m_random( 1 )
+{
+	m_hostStream->SetSignalThreshold( 1 );
+	memset( m_nodes, 0, sizeof(m_nodes) );
+}
+
+//-----------------------------------------------------------------------------
+//	<SimulatedController::~SimulatedController>
+//	Destructor
+//-----------------------------------------------------------------------------
+SimulatedController::~SimulatedController
+(
+)
+{
+	Close();
+	m_hostStream->Release();
+	delete m_epoch;
+}
+
+//-----------------------------------------------------------------------------
+//	<SimulatedController::Open>
+//	Build the simulated network and start the simulator thread
+//-----------------------------------------------------------------------------
+bool SimulatedController::Open
+(
+	string const& _controllerName
+)
+{
+	if( m_bOpen )
+	{
+		return false;
+	}
+
+	m_controllerName = _controllerName;
+
+	Options::Get()->GetOptionAsInt( "SimulatedNodes", &m_numNodes );
+	Options::Get()->GetOptionAsInt( "SimulatedLatency", &m_latency );
+	Options::Get()->GetOptionAsInt( "SimulatedLoss", &m_loss );
+	Options::Get()->GetOptionAsInt( "SimulatedCanRate", &m_canRate );
+
+	int32 maxNodes = NUM_NODE_BITFIELD_BYTES*8 - c_controllerNodeId;
+	if( m_numNodes > maxNodes )
+	{
+		m_numNodes = maxNodes;
+	}
+	if( m_numNodes < 0 )
+	{
+		m_numNodes = 0;
+	}
+	if( m_latency < 0 )
+	{
+		m_latency = 0;
+	}
+
+	memset( m_nodes, 0, sizeof(m_nodes) );
+
+	// Static PC controller
+	m_nodes[c_controllerNodeId].m_generic = 0x02;
+	m_nodes[c_controllerNodeId].m_specific = 0x01;
+
+	for( int32 i=0; i<m_numNodes; ++i )
+	{
+		SimulatedNode& node = m_nodes[c_controllerNodeId+1+i];
+		switch( i % 3 )
+		{
+			case 0:
+			{
+				// Binary power switch
+				node.m_generic = 0x10;
+				node.m_specific = 0x01;
+				node.m_commandClassId = SwitchBinary::StaticGetCommandClassId();
+				break;
+			}
+			case 1:
+			{
+				// Multilevel power switch
+				node.m_generic = 0x11;
+				node.m_specific = 0x01;
+				node.m_commandClassId = SwitchMultilevel::StaticGetCommandClassId();
+				break;
+			}
+			default:
+			{
+				// Routing multilevel sensor
+				node.m_generic = 0x21;
+				node.m_specific = 0x01;
+				node.m_commandClassId = SensorMultilevel::StaticGetCommandClassId();
+				node.m_sensorValue = 200 + i;
+				node.m_multiCmd = true;
+				break;
+			}
+		}
+	}
+
+	Log::Write( LogLevel_Info, "Opening simulated controller %s with %d nodes (latency %dms, loss %d%%, CAN rate %d%%)", m_controllerName.c_str(), m_numNodes, m_latency, m_loss, m_canRate );
+
+	m_epoch->SetTime();
+	m_radioFree = 0;
+	m_schedule.clear();
+	m_rxLength = 0;
+	m_hostStream->Purge();
+
+	m_thread = new Thread( "SimulatedController" );
+	m_thread->Start( SimulatorThreadEntryPoint, this );
+
+	m_bOpen = true;
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//	<SimulatedController::Close>
+//	Stop the simulator thread
+//-----------------------------------------------------------------------------
+bool SimulatedController::Close
+(
+)
+{
+	if( !m_bOpen )
+	{
+		return false;
+	}
+
+	m_thread->Stop();
+	m_thread->Release();
+	m_thread = NULL;
+
+	m_bOpen = false;
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//	<SimulatedController::Write>
+//	Pass data from the driver to the simulator thread
+//-----------------------------------------------------------------------------
+uint32 SimulatedController::Write
+(
+	uint8* _buffer,
+	uint32 _length
+)
+{
+	if( !m_bOpen )
+	{
+		return 0;
+	}
+
+	Log::Write( LogLevel_StreamDetail, "      SimulatedController::Write (sent to controller)" );
+	LogData(_buffer, _length, "      Write: ");
+	CaptureWrite( _buffer, _length );
+
+	if( !m_hostStream->Put( _buffer, _length ) )
+	{
+		return 0;
+	}
+	return _length;
+}
+
+//-----------------------------------------------------------------------------
+//	<SimulatedController::SimulatorThreadEntryPoint>
+//	Entry point of the simulator thread
+//-----------------------------------------------------------------------------
+void SimulatedController::SimulatorThreadEntryPoint
+(
+	Event* _exitEvent,
+	void* _context
+)
+{
+	SimulatedController* controller = (SimulatedController*)_context;
+	if( controller )
+	{
+		controller->SimulatorThreadProc( _exitEvent );
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<SimulatedController::SimulatorThreadProc>
+//	Answer the driver and send the frames from the radio when they are due
+//-----------------------------------------------------------------------------
+void SimulatedController::SimulatorThreadProc
+(
+	Event* _exitEvent
+)
+{
+	Wait* waitObjects[2];
+	waitObjects[0] = _exitEvent;			// Thread must exit.
+	waitObjects[1] = m_hostStream;			// Data from the driver.
+
+	while( true )
+	{
+		int32 timeout = Wait::Timeout_Infinite;
+		if( !m_schedule.empty() )
+		{
+			timeout = (int32)( m_schedule.front().m_due - Now() );
+			if( timeout < 0 )
+			{
+				timeout = 0;
+			}
+		}
+
+		int32 res = Wait::Multiple( waitObjects, 2, timeout );
+		if( res == 0 )
+		{
+			// Exit has been signalled
+			break;
+		}
+
+		if( res == 1 )
+		{
+			ProcessHostData();
+		}
+
+		uint32 now = Now();
+		while( !m_schedule.empty() && (int32)( m_schedule.front().m_due - now ) <= 0 )
+		{
+			SendFrame( m_schedule.front().m_data, m_schedule.front().m_length );
+			m_schedule.pop_front();
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<SimulatedController::ProcessHostData>
+//	Split the data from the driver into frames and answer them
+//-----------------------------------------------------------------------------
+void SimulatedController::ProcessHostData
+(
+)
+{
+	uint32 size = m_hostStream->GetDataSize();
+	if( size > sizeof(m_rxBuffer) - m_rxLength )
+	{
+		size = sizeof(m_rxBuffer) - m_rxLength;
+	}
+	m_hostStream->Get( &m_rxBuffer[m_rxLength], size );
+	m_rxLength += size;
+
+	uint32 pos = 0;
+	while( pos < m_rxLength )
+	{
+		if( SOF != m_rxBuffer[pos] )
+		{
+			// The simulator does not wait for the driver to acknowledge its
+			// frames, so ACKs are dropped.  Anything else is noted and skipped.
+			if( ACK != m_rxBuffer[pos] )
+			{
+				Log::Write( LogLevel_Detail, "SimulatedController: received 0x%.2x from the driver", m_rxBuffer[pos] );
+			}
+			++pos;
+			continue;
+		}
+
+		if( m_rxLength - pos < 2 )
+		{
+			// Wait for the length byte
+			break;
+		}
+
+		uint8 length = m_rxBuffer[pos+1];
+		if( length < 3 )
+		{
+			// Too short to be a frame.  Reject it and look for the next SOF.
+			SendByte( NAK );
+			++pos;
+			continue;
+		}
+
+		if( m_rxLength - pos < (uint32)length + 2 )
+		{
+			// Wait for the rest of the frame
+			break;
+		}
+
+		uint8 checksum = 0xff;
+		for( uint32 i=1; i<=length; ++i )
+		{
+			checksum ^= m_rxBuffer[pos+i];
+		}
+
+		if( checksum != m_rxBuffer[pos+length+1] )
+		{
+			Log::Write( LogLevel_Warning, "SimulatedController: checksum error in frame from the driver" );
+			SendByte( NAK );
+		}
+		else if( Chance( m_canRate ) )
+		{
+			// Pretend the frame collided with one of ours
+			SendByte( CAN );
+		}
+		else
+		{
+			SendByte( ACK );
+			ProcessHostFrame( &m_rxBuffer[pos+2], length-1 );
+		}
+		pos += length + 2;
+	}
+
+	m_rxLength -= pos;
+	memmove( m_rxBuffer, &m_rxBuffer[pos], m_rxLength );
+}
+
+//-----------------------------------------------------------------------------
+//	<SimulatedController::ProcessHostFrame>
+//	Answer a Serial API request from the driver
+//-----------------------------------------------------------------------------
+void SimulatedController::ProcessHostFrame
+(
+	uint8 const* _data,
+	uint8 _length
+)
+{
+	if( ( _length < 2 ) || ( REQUEST != _data[0] ) )
+	{
+		return;
+	}
+
+	uint8 response[256];
+	uint8 length = 0;
+	response[length++] = RESPONSE;
+	response[length++] = _data[1];
+
+	switch( _data[1] )
+	{
+		case FUNC_ID_ZW_GET_VERSION:
+		{
+			char const* version = "Z-Wave 4.05";
+			strcpy( (char*)&response[length], version );
+			length += (uint8)strlen( version ) + 1;
+			response[length++] = 0x01;					// Static controller library
+			break;
+		}
+		case FUNC_ID_ZW_MEMORY_GET_ID:
+		{
+			response[length++] = (uint8)( c_homeId >> 24 );
+			response[length++] = (uint8)( c_homeId >> 16 );
+			response[length++] = (uint8)( c_homeId >> 8 );
+			response[length++] = (uint8)( c_homeId );
+			response[length++] = c_controllerNodeId;
+			break;
+		}
+		case FUNC_ID_ZW_GET_CONTROLLER_CAPABILITIES:
+		{
+			response[length++] = 0x00;					// Primary controller
+			break;
+		}
+		case FUNC_ID_SERIAL_API_GET_CAPABILITIES:
+		{
+			response[length++] = 0x01;					// Serial API version
+			response[length++] = 0x00;
+			for( int32 i=0; i<6; ++i )
+			{
+				response[length++] = 0x00;				// Manufacturer, product type and product ID
+			}
+			memset( &response[length], 0, 32 );
+			for( uint32 i=0; i<sizeof(c_supportedFunctions); ++i )
+			{
+				uint8 bit = c_supportedFunctions[i] - 1;
+				response[length+(bit>>3)] |= 0x01 << ( bit & 0x07 );
+			}
+			length += 32;
+			break;
+		}
+		case FUNC_ID_ZW_GET_SUC_NODE_ID:
+		{
+			response[length++] = c_controllerNodeId;
+			break;
+		}
+		case FUNC_ID_SERIAL_API_GET_INIT_DATA:
+		{
+			response[length++] = 0x05;					// Serial API version
+			response[length++] = 0x08;					// Static update controller
+			response[length++] = NUM_NODE_BITFIELD_BYTES;
+			memset( &response[length], 0, NUM_NODE_BITFIELD_BYTES );
+			for( int32 nodeId=1; nodeId<=NUM_NODE_BITFIELD_BYTES*8; ++nodeId )
+			{
+				if( m_nodes[nodeId].m_generic )
+				{
+					response[length+((nodeId-1)>>3)] |= 0x01 << ( (nodeId-1) & 0x07 );
+				}
+			}
+			length += NUM_NODE_BITFIELD_BYTES;
+			response[length++] = 0x05;					// Chip type
+			response[length++] = 0x00;					// Chip version
+			break;
+		}
+		case FUNC_ID_SERIAL_API_SET_TIMEOUTS:
+		{
+			response[length++] = ACK_TIMEOUT / 10;		// Previous timeouts
+			response[length++] = BYTE_TIMEOUT / 10;
+			break;
+		}
+		case FUNC_ID_SERIAL_API_APPL_NODE_INFORMATION:
+		{
+			// No response
+			return;
+		}
+		case FUNC_ID_ZW_GET_NODE_PROTOCOL_INFO:
+		{
+			SimulatedNode const& node = m_nodes[_data[2]];
+			if( node.m_generic )
+			{
+				response[length++] = 0xd3;				// Listening, routing, 40kbps, version 4
+				response[length++] = 0x16;				// Optional functionality, beaming, specific device class
+				response[length++] = 0x00;
+				response[length++] = ( _data[2] == c_controllerNodeId ) ? 0x02 : 0x04;	// Static controller or routing slave
+				response[length++] = node.m_generic;
+				response[length++] = node.m_specific;
+			}
+			else
+			{
+				memset( &response[length], 0, 6 );
+				length += 6;
+			}
+			break;
+		}
+		case FUNC_ID_ZW_GET_ROUTING_INFO:
+		{
+			// Every node can reach the controller and the nodes either side of it
+			memset( &response[length], 0, NUM_NODE_BITFIELD_BYTES );
+			uint8 nodeId = _data[2];
+			if( m_nodes[nodeId].m_generic )
+			{
+				for( int32 neighbor=nodeId-1; neighbor<=nodeId+1; ++neighbor )
+				{
+					if( ( neighbor > 0 ) && ( neighbor != nodeId ) && ( neighbor <= NUM_NODE_BITFIELD_BYTES*8 ) && m_nodes[neighbor].m_generic )
+					{
+						response[length+((neighbor-1)>>3)] |= 0x01 << ( (neighbor-1) & 0x07 );
+					}
+				}
+				if( nodeId != c_controllerNodeId )
+				{
+					response[length] |= 0x01 << ( c_controllerNodeId - 1 );
+				}
+			}
+			length += NUM_NODE_BITFIELD_BYTES;
+			break;
+		}
+		case FUNC_ID_ZW_IS_FAILED_NODE_ID:
+		{
+			response[length++] = m_nodes[_data[2]].m_generic ? 0x00 : 0x01;
+			break;
+		}
+		case FUNC_ID_ZW_REQUEST_NODE_INFO:
+		{
+			response[length++] = 0x01;					// Request queued
+
+			uint8 nodeId = _data[2];
+			SimulatedNode const& node = m_nodes[nodeId];
+			uint32 due = Now();
+			if( (int32)( m_radioFree - due ) > 0 )
+			{
+				due = m_radioFree;
+			}
+			due += m_latency;
+			m_radioFree = due;
+
+			uint8 update[32];
+			uint8 updateLength = 0;
+			update[updateLength++] = REQUEST;
+			update[updateLength++] = FUNC_ID_ZW_APPLICATION_UPDATE;
+			if( node.m_generic && ( nodeId != c_controllerNodeId ) && !Chance( m_loss ) )
+			{
+				update[updateLength++] = UPDATE_STATE_NODE_INFO_RECEIVED;
+				update[updateLength++] = nodeId;
+				update[updateLength++] = node.m_multiCmd ? 7 : 6;
+				update[updateLength++] = 0x04;			// Routing slave
+				update[updateLength++] = node.m_generic;
+				update[updateLength++] = node.m_specific;
+				update[updateLength++] = node.m_commandClassId;
+				update[updateLength++] = ManufacturerSpecific::StaticGetCommandClassId();
+				update[updateLength++] = Version::StaticGetCommandClassId();
+				if( node.m_multiCmd )
+				{
+					update[updateLength++] = MultiCmd::StaticGetCommandClassId();
+				}
+			}
+			else
+			{
+				update[updateLength++] = UPDATE_STATE_NODE_INFO_REQ_FAILED;
+				update[updateLength++] = 0;
+				update[updateLength++] = 0;
+			}
+			SendFrame( response, length );
+			ScheduleFrame( due, update, updateLength );
+			return;
+		}
+		case FUNC_ID_ZW_SEND_DATA:
+		{
+			HandleSendData( _data, _length );
+			return;
+		}
+		case FUNC_ID_ZW_SEND_DATA_MULTI:
+		{
+			HandleSendDataMulti( _data, _length );
+			return;
+		}
+		default:
+		{
+			Log::Write( LogLevel_Warning, "SimulatedController: function 0x%.2x is not supported", _data[1] );
+			return;
+		}
+	}
+
+	SendFrame( response, length );
+}
+
+//-----------------------------------------------------------------------------
+//	<SimulatedController::HandleSendData>
+//	Pass a ZW_SEND_DATA request to the simulated radio
+//-----------------------------------------------------------------------------
+void SimulatedController::HandleSendData
+(
+	uint8 const* _data,
+	uint8 _length
+)
+{
+	// REQUEST, FUNC_ID_ZW_SEND_DATA, node, length, data..., transmit options[, callback ID]
+	if( ( _length < 5 ) || ( _length < _data[3] + 5 ) )
+	{
+		Log::Write( LogLevel_Warning, "SimulatedController: malformed ZW_SEND_DATA request" );
+		return;
+	}
+
+	uint8 nodeId = _data[2];
+	uint8 commandLength = _data[3];
+	bool callback = ( _length > commandLength + 5 );
+
+	uint8 response[3];
+	response[0] = RESPONSE;
+	response[1] = FUNC_ID_ZW_SEND_DATA;
+	response[2] = 0x01;							// Request queued
+	SendFrame( response, 3 );
+
+	uint32 due = Now();
+	if( (int32)( m_radioFree - due ) > 0 )
+	{
+		due = m_radioFree;
+	}
+	due += m_latency;
+	m_radioFree = due;
+
+	bool delivered = ( nodeId > 0 ) && ( nodeId <= NUM_NODE_BITFIELD_BYTES*8 ) && m_nodes[nodeId].m_generic && !Chance( m_loss );
+
+	if( callback )
+	{
+		uint8 status[4];
+		status[0] = REQUEST;
+		status[1] = FUNC_ID_ZW_SEND_DATA;
+		status[2] = _data[_length-1];
+		status[3] = delivered ? TRANSMIT_COMPLETE_OK : TRANSMIT_COMPLETE_NO_ACK;
+		ScheduleFrame( due, status, 4 );
+	}
+
+	if( delivered )
+	{
+		uint8 report[256];
+		uint8 reportLength = HandleCommand( nodeId, &_data[4], commandLength, &report[5] );
+		if( reportLength )
+		{
+			report[0] = REQUEST;
+			report[1] = FUNC_ID_APPLICATION_COMMAND_HANDLER;
+			report[2] = 0x00;						// Receive status
+			report[3] = nodeId;
+			report[4] = reportLength;
+
+			// The report is a transmission of its own, from the node
+			due += m_latency;
+			m_radioFree = due;
+			ScheduleFrame( due, report, reportLength+5 );
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<SimulatedController::HandleSendDataMulti>
+//	Pass a ZW_SEND_DATA_MULTI request to the simulated radio.  Multicast frames
+//	are not acknowledged, so each node may miss the command without the callback
+//	saying so, and the nodes send no reports.
+//-----------------------------------------------------------------------------
+void SimulatedController::HandleSendDataMulti
+(
+	uint8 const* _data,
+	uint8 _length
+)
+{
+	// REQUEST, FUNC_ID_ZW_SEND_DATA_MULTI, node count, nodes..., length, data..., transmit options[, callback ID]
+	if( ( _length < 3 ) || ( _length < _data[2] + 5 ) || ( _length < _data[2] + _data[_data[2]+3] + 5 ) )
+	{
+		Log::Write( LogLevel_Warning, "SimulatedController: malformed ZW_SEND_DATA_MULTI request" );
+		return;
+	}
+
+	uint8 numNodes = _data[2];
+	uint8 const* command = &_data[numNodes+4];
+	uint8 commandLength = _data[numNodes+3];
+	bool callback = ( _length > numNodes + commandLength + 5 );
+
+	uint8 response[3];
+	response[0] = RESPONSE;
+	response[1] = FUNC_ID_ZW_SEND_DATA_MULTI;
+	response[2] = 0x01;							// Request queued
+	SendFrame( response, 3 );
+
+	uint32 due = Now();
+	if( (int32)( m_radioFree - due ) > 0 )
+	{
+		due = m_radioFree;
+	}
+	due += m_latency;
+	m_radioFree = due;
+
+	for( uint8 i=0; i<numNodes; ++i )
+	{
+		uint8 nodeId = _data[i+3];
+		if( ( nodeId > 0 ) && ( nodeId <= NUM_NODE_BITFIELD_BYTES*8 ) && m_nodes[nodeId].m_generic && !Chance( m_loss ) )
+		{
+			uint8 report[256];
+			HandleCommand( nodeId, command, commandLength, report );
+		}
+	}
+
+	if( callback )
+	{
+		uint8 status[4];
+		status[0] = REQUEST;
+		status[1] = FUNC_ID_ZW_SEND_DATA_MULTI;
+		status[2] = _data[_length-1];
+		status[3] = TRANSMIT_COMPLETE_OK;
+		ScheduleFrame( due, status, 4 );
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<SimulatedController::HandleCommand>
+//	Apply a command to a simulated node, and build the node's reply if it has one
+//-----------------------------------------------------------------------------
+uint8 SimulatedController::HandleCommand
+(
+	uint8 _nodeId,
+	uint8 const* _command,
+	uint8 _length,
+	uint8* _report
+)
+{
+	if( _length < 2 )
+	{
+		// NoOperation, or nothing we can act on
+		return 0;
+	}
+
+	SimulatedNode& node = m_nodes[_nodeId];
+	uint8 commandClassId = _command[0];
+	uint8 length = 0;
+
+	if( Basic::StaticGetCommandClassId() == commandClassId )
+	{
+		if( ( BasicCmd_Set == _command[1] ) && ( _length >= 3 ) )
+		{
+			node.m_level = _command[2];
+		}
+		else if( BasicCmd_Get == _command[1] )
+		{
+			_report[length++] = commandClassId;
+			_report[length++] = BasicCmd_Report;
+			_report[length++] = node.m_level;
+		}
+	}
+	else if( ( commandClassId == node.m_commandClassId ) &&
+			( ( SwitchBinary::StaticGetCommandClassId() == commandClassId ) || ( SwitchMultilevel::StaticGetCommandClassId() == commandClassId ) ) )
+	{
+		if( ( SwitchCmd_Set == _command[1] ) && ( _length >= 3 ) )
+		{
+			if( SwitchBinary::StaticGetCommandClassId() == commandClassId )
+			{
+				node.m_level = _command[2] ? 0xff : 0x00;
+			}
+			else
+			{
+				// 0xff means "on at the last level", which we treat as full on
+				node.m_level = ( _command[2] > 99 ) ? 99 : _command[2];
+			}
+		}
+		else if( SwitchCmd_Get == _command[1] )
+		{
+			_report[length++] = commandClassId;
+			_report[length++] = SwitchCmd_Report;
+			_report[length++] = node.m_level;
+		}
+	}
+	else if( ( SwitchAll::StaticGetCommandClassId() == commandClassId ) && ( SensorMultilevel::StaticGetCommandClassId() != node.m_commandClassId ) )
+	{
+		if( SwitchAllCmd_Get == _command[1] )
+		{
+			_report[length++] = commandClassId;
+			_report[length++] = SwitchAllCmd_Report;
+			_report[length++] = 0xff;				// Included in both all on and all off
+		}
+	}
+	else if( ( commandClassId == node.m_commandClassId ) && ( SensorMultilevel::StaticGetCommandClassId() == commandClassId ) )
+	{
+		if( SensorMultilevelCmd_Get == _command[1] )
+		{
+			// Let the reading wander a little, so that some polls see a change
+			node.m_sensorValue += Chance( 50 ) ? 1 : -1;
+
+			_report[length++] = commandClassId;
+			_report[length++] = SensorMultilevelCmd_Report;
+			_report[length++] = 0x01;				// Temperature
+			_report[length++] = 0x22;				// Precision 1, Celsius, 2 bytes
+			_report[length++] = (uint8)( node.m_sensorValue >> 8 );
+			_report[length++] = (uint8)( node.m_sensorValue );
+		}
+	}
+	else if( ( MultiCmd::StaticGetCommandClassId() == commandClassId ) && node.m_multiCmd )
+	{
+		if( ( MultiCmdCmd_Encap == _command[1] ) && ( _length >= 3 ) )
+		{
+			// Carry out each command in turn, and send the replies back together
+			_report[length++] = commandClassId;
+			_report[length++] = MultiCmdCmd_Encap;
+			_report[length++] = 0;
+			uint8 base = 3;
+			for( uint8 i=0; ( i<_command[2] ) && ( base < _length ) && ( base + _command[base] < _length ); ++i )
+			{
+				uint8 reply[256];
+				uint8 replyLength = HandleCommand( _nodeId, &_command[base+1], _command[base], reply );
+				if( replyLength )
+				{
+					_report[length++] = replyLength;
+					memcpy( &_report[length], reply, replyLength );
+					length += replyLength;
+					++_report[2];
+				}
+				base += _command[base] + 1;
+			}
+			if( _report[2] == 0 )
+			{
+				length = 0;
+			}
+		}
+	}
+	else if( ManufacturerSpecific::StaticGetCommandClassId() == commandClassId )
+	{
+		if( ManufacturerSpecificCmd_Get == _command[1] )
+		{
+			_report[length++] = commandClassId;
+			_report[length++] = ManufacturerSpecificCmd_Report;
+			_report[length++] = 0x00;				// Manufacturer ID
+			_report[length++] = 0x00;
+			_report[length++] = 0x00;				// Product type
+			_report[length++] = node.m_generic;
+			_report[length++] = 0x00;				// Product ID
+			_report[length++] = _nodeId;
+		}
+	}
+	else if( Version::StaticGetCommandClassId() == commandClassId )
+	{
+		if( VersionCmd_Get == _command[1] )
+		{
+			_report[length++] = commandClassId;
+			_report[length++] = VersionCmd_Report;
+			_report[length++] = 0x03;				// Library type
+			_report[length++] = 0x04;				// Protocol version
+			_report[length++] = 0x05;
+			_report[length++] = 0x01;				// Application version
+			_report[length++] = 0x00;
+		}
+		else if( ( VersionCmd_CommandClassGet == _command[1] ) && ( _length >= 3 ) )
+		{
+			uint8 requested = _command[2];
+			bool supported = ( requested == node.m_commandClassId ) ||
+							 ( ( requested == SwitchAll::StaticGetCommandClassId() ) && ( SensorMultilevel::StaticGetCommandClassId() != node.m_commandClassId ) ) ||
+							 ( requested == Basic::StaticGetCommandClassId() ) ||
+							 ( requested == ManufacturerSpecific::StaticGetCommandClassId() ) ||
+							 ( requested == Version::StaticGetCommandClassId() ) ||
+							 ( ( requested == MultiCmd::StaticGetCommandClassId() ) && node.m_multiCmd );
+
+			_report[length++] = commandClassId;
+			_report[length++] = VersionCmd_CommandClassReport;
+			_report[length++] = requested;
+			_report[length++] = supported ? 0x01 : 0x00;
+		}
+	}
+
+	return length;
+}
+
+//-----------------------------------------------------------------------------
+//	<SimulatedController::SendByte>
+//	Send a single byte (ACK, NAK or CAN) to the driver
+//-----------------------------------------------------------------------------
+void SimulatedController::SendByte
+(
+	uint8 _byte
+)
+{
+	if( !Put( &_byte, 1 ) )
+	{
+		Log::Write( LogLevel_Error, "SimulatedController: stream full, dropped 0x%.2x", _byte );
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<SimulatedController::SendFrame>
+//	Wrap data in a frame and send it to the driver
+//-----------------------------------------------------------------------------
+void SimulatedController::SendFrame
+(
+	uint8 const* _data,
+	uint8 _length
+)
+{
+	uint8 buffer[260];
+	buffer[0] = SOF;
+	buffer[1] = _length + 1;
+	memcpy( &buffer[2], _data, _length );
+
+	uint8 checksum = 0xff;
+	for( uint32 i=1; i<(uint32)_length+2; ++i )
+	{
+		checksum ^= buffer[i];
+	}
+	buffer[_length+2] = checksum;
+
+	if( !Put( buffer, _length+3 ) )
+	{
+		Log::Write( LogLevel_Error, "SimulatedController: stream full, dropped a frame of %d bytes", _length+3 );
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<SimulatedController::ScheduleFrame>
+//	Queue a frame from the radio, to be sent to the driver at the given time
+//-----------------------------------------------------------------------------
+void SimulatedController::ScheduleFrame
+(
+	uint32 _due,
+	uint8 const* _data,
+	uint8 _length
+)
+{
+	SimulatedFrame frame;
+	frame.m_due = _due;
+	frame.m_length = _length;
+	memcpy( frame.m_data, _data, _length );
+
+	// Frames are nearly always due after the ones already queued,
+	// so search for the insertion point from the back.
+	list<SimulatedFrame>::iterator it = m_schedule.end();
+	while( it != m_schedule.begin() )
+	{
+		--it;
+		if( (int32)( it->m_due - _due ) <= 0 )
+		{
+			++it;
+			break;
+		}
+	}
+	m_schedule.insert( it, frame );
+}
+
+//-----------------------------------------------------------------------------
+//	<SimulatedController::Now>
+//	Milliseconds since the controller was opened
+//-----------------------------------------------------------------------------
+uint32 SimulatedController::Now
+(
+)
+{
+	return (uint32)( -m_epoch->TimeRemaining() );
+}
+
+//-----------------------------------------------------------------------------
+//	<SimulatedController::Chance>
+//	Returns true with the given percentage probability
+//-----------------------------------------------------------------------------
+bool SimulatedController::Chance
+(
+	int32 _percent
+)
+{
+	if( _percent <= 0 )
+	{
+		return false;
+	}
+
+	m_random = m_random * 1103515245 + 12345;
+	return( (int32)( ( m_random >> 16 ) % 100 ) < _percent );
+}
@@ -0,0 +1,160 @@
+//-----------------------------------------------------------------------------
+//
+//	SimulatedController.h
+//
+//	Emulation of a Z-Wave controller and its network, for running without hardware
+//
+//	Copyright (c) 2016 The OpenZWave Project
+//	All rights reserved.
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+#ifndef _SimulatedController_H
+#define _SimulatedController_H
+
+#include <string>
+#include <list>
+#include "Defs.h"
+#include "platform/Controller.h"
+
+namespace OpenZWave
+{
+	class Driver;
+	class Thread;
+	class Event;
+	class TimeStamp;
+
+	/** \brief A controller that emulates the Serial API of a Z-Wave stick and a network of nodes.
+	 *
+	 * Frames written by the driver are handed to a simulator thread, which answers
+	 * them as a static controller would: each frame is ACKed (or NAKed if the
+	 * checksum is wrong), and the Serial API calls needed to start the driver and
+	 * query the nodes get their responses.  ZW_SEND_DATA is passed on to a simulated
+	 * radio, which reports the transmit status after the configured latency and then,
+	 * for the common command classes, the report the node would have sent back.
+	 *
+	 * The network is set up from the options below when the controller is opened:
+	 * - SimulatedNodes: number of nodes in the network, not counting the controller (up to 231).
+	 * - SimulatedLatency: time in milliseconds for a frame to reach a node and be acknowledged.
+	 * - SimulatedLoss: percentage of frames that a node fails to acknowledge.
+	 * - SimulatedCanRate: percentage of frames from the driver that are answered with a CAN,
+	 *   as if they had collided with a frame from the controller.
+	 *
+	 * The nodes are always listening binary switches, multilevel switches and
+	 * multilevel sensors, in turn.
+	 */
+	class SimulatedController: public Controller
+	{
+	public:
+		/**
+		 * Constructor.
+		 * Creates an object that represents a simulated controller.
+		 */
+		SimulatedController();
+
+		/**
+		 * Destructor.
+		 * Destroys the simulated controller object.
+		 */
+		virtual ~SimulatedController();
+
+		/**
+		 * Open the simulated controller.
+		 * Builds the simulated network from the options and starts the simulator thread.
+		 * @param _controllerName Name of the controller.  It is only used for logging.
+		 * @return True if the controller was opened.
+		 * @see Close, Write
+		 */
+		bool Open( string const& _controllerName );
+
+		/**
+		 * Close the simulated controller.
+		 * Stops the simulator thread.
+		 * @return True if the controller was closed, or false if it was already closed.
+		 * @see Open
+		 */
+		bool Close();
+
+		/**
+		 * Write to the simulated controller.
+		 * The data is passed to the simulator thread, which replies through the controller's stream.
+		 * @param _buffer Pointer to a block of memory containing the data to be written.
+		 * @param _length Length in bytes of the data.
+		 * @return The number of bytes written.
+		 * @see Open, Close
+		 */
+		uint32 Write( uint8* _buffer, uint32 _length );
+
+	private:
+		struct SimulatedNode
+		{
+			uint8	m_generic;						// Generic device class.  Zero if the node does not exist.
+			uint8	m_specific;						// Specific device class
+			uint8	m_commandClassId;				// The command class that the node's device class is built around
+			uint8	m_level;						// Current switch level
+			int16	m_sensorValue;					// Current sensor reading, in tenths of a degree
+			bool	m_multiCmd;						// Supports COMMAND_CLASS_MULTI_CMD
+		};
+
+		struct SimulatedFrame
+		{
+			uint32	m_due;							// Time at which the frame is sent, in milliseconds since the controller was opened
+			uint8	m_length;						// Length of the frame, from the type byte to the last data byte
+			uint8	m_data[256];
+		};
+
+		static void SimulatorThreadEntryPoint( Event* _exitEvent, void* _context );
+		void SimulatorThreadProc( Event* _exitEvent );
+
+		void ProcessHostData();
+		void ProcessHostFrame( uint8 const* _data, uint8 _length );
+		void HandleSendData( uint8 const* _data, uint8 _length );
+		void HandleSendDataMulti( uint8 const* _data, uint8 _length );
+		uint8 HandleCommand( uint8 _nodeId, uint8 const* _command, uint8 _length, uint8* _report );
+
+		void SendByte( uint8 _byte );
+		void SendFrame( uint8 const* _data, uint8 _length );
+		void ScheduleFrame( uint32 _due, uint8 const* _data, uint8 _length );
+		uint32 Now();
+		bool Chance( int32 _percent );
+
+		string					m_controllerName;
+		bool					m_bOpen;
+		Thread*					m_thread;					// Simulator thread.  The only thread that puts data into the controller's stream.
+		Stream*					m_hostStream;				// Data written by the driver, waiting for the simulator thread
+		TimeStamp*				m_epoch;					// Time at which the controller was opened
+
+		uint8					m_rxBuffer[1024];			// Data from the driver that has not yet formed a complete frame
+		uint32					m_rxLength;
+
+		SimulatedNode			m_nodes[256];				// Indexed by node ID
+		list<SimulatedFrame>	m_schedule;					// Frames from the radio, in the order they are due
+		uint32					m_radioFree;				// Time at which the radio finishes its current transmission
+
+		int32					m_numNodes;
+		int32					m_latency;
+		int32					m_loss;
+		int32					m_canRate;
+		uint32					m_random;					// State of the random number generator, so runs are repeatable
+	};
+
+} // namespace OpenZWave
+
+#endif //_SimulatedController_H
+
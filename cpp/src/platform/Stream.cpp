@@ -33,22 +33,60 @@
 
 #include <cstdio>
 
+#ifdef _MSC_VER
+#include <windows.h>
+#endif
+
 using namespace OpenZWave;
 
+//-----------------------------------------------------------------------------
+//	<AtomicAdd>
+//	Add to a value shared between the producer and consumer threads, with a
+//	full memory barrier.  Returns the new value.
+//-----------------------------------------------------------------------------
+static inline uint32 AtomicAdd
+(
+	volatile uint32* _value,
+	int32 _delta
+)
+{
+#ifdef _MSC_VER
+	return (uint32)InterlockedExchangeAdd( (volatile LONG*)_value, (LONG)_delta ) + _delta;
+#else
+	return __sync_add_and_fetch( _value, _delta );
+#endif
+}
+
+//-----------------------------------------------------------------------------
+//	<MemoryFence>
+//	Full memory barrier
+//-----------------------------------------------------------------------------
+static inline void MemoryFence
+(
+)
+{
+#ifdef _MSC_VER
+	MemoryBarrier();
+#else
+	__sync_synchronize();
+#endif
+}
+
 //-----------------------------------------------------------------------------
 //	<Stream::Stream>
 //	Constructor
 //-----------------------------------------------------------------------------
 Stream::Stream
 (
-	uint32 _bufferSize
+	uint32 _bufferSize,
+	bool _singleProducer	// = false
 ):
 	m_bufferSize( _bufferSize ),
 	m_signalSize(1),
 	m_dataSize(0),
 	m_head(0),
 	m_tail(0),
-	m_mutex( new Mutex() )
+	m_mutex( _singleProducer ? NULL : new Mutex() )
 {
 	m_buffer = new uint8[m_bufferSize];
 	memset(m_buffer, 0x00, m_bufferSize);
@@ -62,7 +100,10 @@ Stream::~Stream
 (
 )
 {
-	m_mutex->Release();
+	if( m_mutex )
+	{
+		m_mutex->Release();
+	}
 	delete [] m_buffer;
 }
 
@@ -76,6 +117,10 @@ void Stream::SetSignalThreshold
 )
 {
 	m_signalSize = _size;
+
+	// Make the new threshold visible to the producer before checking the data size,
+	// so that one of us is guaranteed to see the other's change.
+	MemoryFence();
 	if( IsSignalled() )
 	{
 		// We have more data than we are waiting for, so notify the watchers
@@ -93,14 +138,22 @@ bool Stream::Get
 	uint32 _size
 )
 {
-	if( m_dataSize < _size )
+	if( m_mutex )
+	{
+		m_mutex->Lock();
+	}
+
+	if( AtomicAdd( &m_dataSize, 0 ) < _size )
 	{
 		// There is not enough data in the buffer to fulfill the request
 		Log::Write( LogLevel_Error, "ERROR: Not enough data in stream buffer");
+		if( m_mutex )
+		{
+			m_mutex->Unlock();
+		}
 		return false;
 	}
 
-	m_mutex->Lock();
 	if( (m_tail + _size) > m_bufferSize )
 	{
 		// We will have to wrap around
@@ -116,12 +169,21 @@ bool Stream::Get
 		// Requested data is in a contiguous block
 		memcpy( _buffer, &m_buffer[m_tail], _size );
 		m_tail += _size;
+		if( m_tail == m_bufferSize )
+		{
+			m_tail = 0;
+		}
 	}
 
 	LogData( _buffer, _size, "      Read (buffer->application): ");
 
-	m_dataSize -= _size;
-	m_mutex->Unlock();
+	// Hand the space back to the producer
+	AtomicAdd( &m_dataSize, -(int32)_size );
+
+	if( m_mutex )
+	{
+		m_mutex->Unlock();
+	}
 	return true;
 }
 
@@ -135,14 +197,22 @@ bool Stream::Put
 	uint32 _size
 )
 {
-	if( (m_bufferSize-m_dataSize) < _size )
+	if( m_mutex )
+	{
+		m_mutex->Lock();
+	}
+
+	if( (m_bufferSize - AtomicAdd( &m_dataSize, 0 )) < _size )
 	{
 		// There is not enough space left in the buffer for the data
 		Log::Write( LogLevel_Error, "ERROR: Not enough space in stream buffer");
+		if( m_mutex )
+		{
+			m_mutex->Unlock();
+		}
 		return false;
 	}
 
-	m_mutex->Lock();
 	if( (m_head + _size) > m_bufferSize )
 	{
 		// We will have to wrap around
@@ -162,17 +232,28 @@ bool Stream::Put
 		memcpy( &m_buffer[m_head], _buffer, _size );
 		m_head += _size;
 		LogData(m_buffer+m_head-_size, _size, "      Read (controller->buffer):  ");
+		if( m_head == m_bufferSize )
+		{
+			m_head = 0;
+		}
 	}
 
-	m_dataSize += _size;
+	// Publish the data to the consumer
+	uint32 dataSize = AtomicAdd( &m_dataSize, _size );
 
-	if( IsSignalled() )
+	// Only wake the watchers if this data has taken us over the threshold.  If we
+	// were already over it, they have been notified, or will see it when they start
+	// waiting.
+	uint32 signalSize = m_signalSize;
+	if( ( dataSize >= signalSize ) && ( ( dataSize - _size ) < signalSize ) )
 	{
-		// We now have more data than we are waiting for, so notify the watchers
 		Notify();
 	}
 
-	m_mutex->Unlock();
+	if( m_mutex )
+	{
+		m_mutex->Unlock();
+	}
 	return true;
 }
 
@@ -184,9 +265,21 @@ void Stream::Purge
 (
 )
 {
-	m_tail = 0;
-	m_head = 0;
-	m_dataSize = 0;
+	if( m_mutex )
+	{
+		m_mutex->Lock();
+	}
+
+	// Discard the data by moving the tail past it.  The head belongs to the producer,
+	// so it is left alone.
+	uint32 dataSize = AtomicAdd( &m_dataSize, 0 );
+	m_tail = ( m_tail + dataSize ) % m_bufferSize;
+	AtomicAdd( &m_dataSize, -(int32)dataSize );
+
+	if( m_mutex )
+	{
+		m_mutex->Unlock();
+	}
 }
 
 //-----------------------------------------------------------------------------
@@ -208,10 +301,10 @@ void Stream::LogData
 (
 	uint8* _buffer,
 	uint32 _length,
-	const string &_function
+	char const* _function
 )
 {
-	if( !_length ) return;
+	if( !_length || !Log::IsLevelEnabled( LogLevel_StreamDetail ) ) return;
 
 	string str = "";
 	for( uint32 i=0; i<_length; ++i ) 
@@ -225,5 +318,5 @@ void Stream::LogData
 		snprintf( byteStr, sizeof(byteStr), "0x%.2x", _buffer[i] );
 		str += byteStr;
 	}
-	Log::Write( LogLevel_StreamDetail, "%s%s", _function.c_str(), str.c_str() );
+	Log::Write( LogLevel_StreamDetail, "%s%s", _function, str.c_str() );
 }
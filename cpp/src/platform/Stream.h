@@ -47,13 +47,18 @@ namespace OpenZWave
 		/**
 		 * Constructor.
 		 * Creates a cross-platform ring buffer object
+		 * \param _bufferSize the capacity of the ring buffer in bytes.
+		 * \param _singleProducer if true, the stream is lock-free.  Exactly one thread may
+		 * call Put, and exactly one other thread may call Get, Purge and SetSignalThreshold.
+		 * If false, every operation is serialized by a mutex.
 		 */
-		Stream( uint32 _bufferSize );
+		Stream( uint32 _bufferSize, bool _singleProducer = false );
 
 		/**
 		 * Set the number of bytes the buffer must contain before it becomes signalled.
 		 * Once the threshold is set, the application can use Wait::Single or Wait::Multiple
 		 * to wait until the buffer has been filled with the desired amount of data.
+		 * Watchers are only notified when the amount of data crosses the threshold.
 		 * \param _size the amount of data in bytes that the buffer must contain for it to become signalled.
 		 * \see Wait::Single, Wait::Multiple
 		 */
@@ -92,7 +97,7 @@ namespace OpenZWave
  		/**
 		 * Empties the stream bytes held in the buffer.  
 		 * This is called when the library gets out of sync with the controller and sends a "NAK" 
-		 * to the controller.
+		 * to the controller.  In single producer mode, it must be called from the consumer thread.
 		 */
 		void Purge();
 
@@ -103,7 +108,7 @@ namespace OpenZWave
 		 * \param _size number of valid bytes currently in the buffer
 		 * \param _function string containing text to display before the data
 		 */
-		void LogData( uint8* _buffer, uint32 _size, const string &_function );
+		void LogData( uint8* _buffer, uint32 _size, char const* _function );
 
 		/**
 		 * Used by the Wait class to test whether the buffer contains sufficient data.
@@ -120,13 +125,13 @@ namespace OpenZWave
 		Stream( Stream const&	);					// prevent copy
 		Stream& operator = ( Stream const& );		// prevent assignment
 
-		uint8*	m_buffer;
-		uint32	m_bufferSize;
-		uint32	m_signalSize;
-		uint32	m_dataSize;
-		uint32	m_head;
-		uint32	m_tail;
- 		Mutex*	m_mutex;
+		uint8*			m_buffer;
+		uint32			m_bufferSize;
+		volatile uint32	m_signalSize;
+		volatile uint32	m_dataSize;		// Only changed atomically, so the producer and consumer can share it without a lock
+		uint32			m_head;			// Only changed by the producer
+		uint32			m_tail;			// Only changed by the consumer
+ 		Mutex*			m_mutex;		// NULL in single producer mode
 	};
 
 } // namespace OpenZWave
@@ -30,6 +30,7 @@
 #include "platform/Wait.h"
 #include "platform/Event.h"
 #include "platform/Log.h"
+#include "platform/TimeStamp.h"
 
 #ifdef WIN32
 #include "platform/windows/WaitImpl.h"	// Platform-specific implementation of a Wait object
@@ -137,10 +138,21 @@ int32 Wait::Multiple
 		_objects[i]->AddWatcher( WaitMultipleCallback, waitEvent );
 	}
 
+	TimeStamp timeoutTimeStamp;
+	if( _timeout > 0 )
+	{
+		timeoutTimeStamp.SetTime( _timeout );
+	}
+
 	int32 res = -1;	// Default to timeout result
 	string str = "";
-	if( waitEvent->Wait( _timeout ) )
+	int32 timeout = _timeout;
+	while( waitEvent->Wait( timeout ) )
 	{
+		// Reset the event before looking at the objects, so that any
+		// object signalled from now on will set it again.
+		waitEvent->Reset();
+
 		// An object was signalled.  Run through the list
 		// and see which one it was.
 		for( i=0; i<_numObjects; ++i )
@@ -154,6 +166,23 @@ int32 Wait::Multiple
 				str += buf;
 			}
 		}
+		if( res != -1 )
+		{
+			break;
+		}
+
+		// None of the objects is signalled.  Event::Set notifies the watchers after
+		// it sets the event, so a notification can arrive after the object has been
+		// seen and reset by a previous wait.  That is not a timeout, so wait again
+		// for the rest of the time.
+		if( _timeout > 0 )
+		{
+			timeout = timeoutTimeStamp.TimeRemaining();
+			if( timeout <= 0 )
+			{
+				break;
+			}
+		}
 	}
 	//Log::Write( LogLevel_Debug, "Wait::Multiple res=%d num=%d >%s", res, _numObjects, str.c_str() );
 
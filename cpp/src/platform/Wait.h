@@ -42,6 +42,7 @@ namespace OpenZWave
 	{
 		friend class WaitImpl;
 		friend class ThreadImpl;
+		friend class WaitSet;
 
 	public:
 		enum
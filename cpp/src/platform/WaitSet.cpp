@@ -0,0 +1,141 @@
+//-----------------------------------------------------------------------------
+//
+//	WaitSet.cpp
+//
+//	Cross-platform set of objects that can be waited on repeatedly
+//
+//	Copyright (c) 2016 The OpenZWave Project
+//	All rights reserved.
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+#include "Defs.h"
+#include "platform/WaitSet.h"
+
+#ifdef WIN32
+#include "platform/windows/WaitSetImpl.h"	// Platform-specific implementation of a wait set
+#elif defined WINRT
+#include "platform/winRT/WaitSetImpl.h"	// Platform-specific implementation of a wait set
+#else
+#include "platform/unix/WaitSetImpl.h"	// Platform-specific implementation of a wait set
+#endif
+
+using namespace OpenZWave;
+
+//-----------------------------------------------------------------------------
+//	<WaitSet::WaitSet>
+//	Constructor
+//-----------------------------------------------------------------------------
+WaitSet::WaitSet
+(
+	Wait** _objects,
+	uint32 _numObjects
+):
+	m_objects( new Wait*[_numObjects] ),
+	m_numObjects( _numObjects ),
+	m_pImpl( new WaitSetImpl() )
+{
+	for( uint32 i=0; i<m_numObjects; ++i )
+	{
+		m_objects[i] = _objects[i];
+		m_objects[i]->AddWatcher( WaitSetCallback, m_pImpl );
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<WaitSet::~WaitSet>
+//	Destructor
+//-----------------------------------------------------------------------------
+WaitSet::~WaitSet
+(
+)
+{
+	for( uint32 i=0; i<m_numObjects; ++i )
+	{
+		m_objects[i]->RemoveWatcher( WaitSetCallback, m_pImpl );
+	}
+	delete [] m_objects;
+	delete m_pImpl;
+}
+
+//-----------------------------------------------------------------------------
+//	<WaitSet::Multiple>
+//	Wait for one of the first _numObjects objects to become signalled
+//-----------------------------------------------------------------------------
+int32 WaitSet::Multiple
+(
+	uint32 _numObjects,
+	int32 _timeout // = -1
+)
+{
+	if( _numObjects > m_numObjects )
+	{
+		_numObjects = m_numObjects;
+	}
+
+	// The deadline is kept on a monotonic clock.  A TimeStamp follows the time of day,
+	// so setting the clock would end the wait early or stretch it out.
+	uint32 deadline = WaitSetImpl::Ticks() + (uint32)_timeout;
+
+	while( true )
+	{
+		// Check the objects in priority order
+		for( uint32 i=0; i<_numObjects; ++i )
+		{
+			if( m_objects[i]->IsSignalled() )
+			{
+				return (int32)i;
+			}
+		}
+
+		int32 timeout = _timeout;
+		if( _timeout > 0 )
+		{
+			timeout = (int32)( deadline - WaitSetImpl::Ticks() );
+			if( timeout < 0 )
+			{
+				timeout = 0;
+			}
+		}
+
+		if( timeout == 0 )
+		{
+			return -1;
+		}
+
+		// Sleep until one of the watched objects notifies us.  A wake-up that arrived
+		// since the check above is not lost, because the primitive stays signalled
+		// until the wait consumes it.  It may have come from an object we are not
+		// interested in at the moment, so the objects are always checked again.
+		m_pImpl->Wait( timeout );
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<WaitSet::WaitSetCallback>
+//	Callback handler for the watchers added to the objects in the set
+//-----------------------------------------------------------------------------
+void WaitSet::WaitSetCallback
+(
+	void* _context
+)
+{
+	WaitSetImpl* impl = (WaitSetImpl*)_context;
+	impl->Signal();
+}
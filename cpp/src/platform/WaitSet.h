@@ -0,0 +1,86 @@
+//-----------------------------------------------------------------------------
+//
+//	WaitSet.h
+//
+//	Cross-platform set of objects that can be waited on repeatedly
+//
+//	Copyright (c) 2016 The OpenZWave Project
+//	All rights reserved.
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+#ifndef _WaitSet_H
+#define _WaitSet_H
+
+#include "Defs.h"
+#include "platform/Wait.h"
+
+namespace OpenZWave
+{
+	class WaitSetImpl;
+
+	/** \brief A fixed set of Wait objects that a thread waits on over and over again.
+	 *
+	 * Wait::Multiple creates an event and adds and removes a watcher on every object each
+	 * time it is called.  A WaitSet adds its watchers once, when it is created, and keeps
+	 * them until it is destroyed, so each wait only has to test the objects and block on a
+	 * single platform wake-up primitive (an eventfd in an epoll set on Linux).
+	 */
+	class WaitSet
+	{
+	public:
+		/**
+		 * Constructor.
+		 * Adds a watcher to each of the objects.  The objects must outlive the set.
+		 * \param _objects array of pointers to the objects to wait on, highest priority first.
+		 * \param _numObjects number of objects in the array.
+		 */
+		WaitSet( Wait** _objects, uint32 _numObjects );
+
+		/**
+		 * Destructor.
+		 * Removes the watchers from the objects.
+		 */
+		~WaitSet();
+
+		/**
+		 * Wait for one of the first _numObjects objects in the set to become signalled.
+		 * If more than one of them is signalled, the lowest index is returned, as with
+		 * Wait::Multiple.
+		 * \param _numObjects number of objects, counted from the start of the set, to wait on.
+		 * \param _timeout optional maximum time to wait.  Defaults to -1, which means wait forever.
+		 * \return index of the object that was signalled, -1 if the wait timed out.
+		 */
+		int32 Multiple( uint32 _numObjects, int32 _timeout = -1 );
+
+	private:
+		WaitSet( WaitSet const& );					// prevent copy
+		WaitSet& operator = ( WaitSet const& );		// prevent assignment
+
+		static void WaitSetCallback( void* _context );
+
+		Wait**			m_objects;
+		uint32			m_numObjects;
+		WaitSetImpl*	m_pImpl;					// Pointer to an object that encapsulates the platform-specific wake-up primitive.
+	};
+
+} // namespace OpenZWave
+
+#endif //_WaitSet_H
+
@@ -0,0 +1,189 @@
+//-----------------------------------------------------------------------------
+//
+//	CaptureFileImpl.cpp
+//
+//	POSIX implementation of capture file handling
+//
+//	Copyright (c) 2016 The OpenZWave Project
+//	All rights reserved.
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+#include <unistd.h>
+#include <fcntl.h>
+#include <time.h>
+#include <sys/time.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+
+#include "Defs.h"
+#include "CaptureFileImpl.h"
+
+using namespace OpenZWave;
+
+//-----------------------------------------------------------------------------
+//	<CaptureFileImpl::CaptureFileImpl>
+//	Constructor
+//-----------------------------------------------------------------------------
+CaptureFileImpl::CaptureFileImpl
+(
+):
+	m_file( NULL ),
+	m_fd( -1 ),
+	m_map( NULL ),
+	m_mapSize( 0 )
+{
+}
+
+//-----------------------------------------------------------------------------
+//	<CaptureFileImpl::~CaptureFileImpl>
+//	Destructor
+//-----------------------------------------------------------------------------
+CaptureFileImpl::~CaptureFileImpl
+(
+)
+{
+	Close();
+	Unmap();
+}
+
+//-----------------------------------------------------------------------------
+//	<CaptureFileImpl::Create>
+//	Create a file to write a capture to
+//-----------------------------------------------------------------------------
+bool CaptureFileImpl::Create
+(
+	string const& _filename
+)
+{
+	m_file = fopen( _filename.c_str(), "wb" );
+	return( m_file != NULL );
+}
+
+//-----------------------------------------------------------------------------
+//	<CaptureFileImpl::Write>
+//	Append data to the capture file
+//-----------------------------------------------------------------------------
+void CaptureFileImpl::Write
+(
+	uint8 const* _data,
+	uint32 _length
+)
+{
+	if( m_file )
+	{
+		fwrite( _data, 1, _length, m_file );
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<CaptureFileImpl::Close>
+//	Close the capture file
+//-----------------------------------------------------------------------------
+void CaptureFileImpl::Close
+(
+)
+{
+	if( m_file )
+	{
+		fclose( m_file );
+		m_file = NULL;
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<CaptureFileImpl::Map>
+//	Map a capture file into memory for reading
+//-----------------------------------------------------------------------------
+uint8 const* CaptureFileImpl::Map
+(
+	string const& _filename,
+	uint32* _size
+)
+{
+	m_fd = open( _filename.c_str(), O_RDONLY );
+	if( m_fd < 0 )
+	{
+		return NULL;
+	}
+
+	struct stat st;
+	if( ( fstat( m_fd, &st ) != 0 ) || ( st.st_size == 0 ) || ( (uint64)st.st_size > 0xffffffff ) )
+	{
+		Unmap();
+		return NULL;
+	}
+
+	m_mapSize = (size_t)st.st_size;
+	m_map = mmap( NULL, m_mapSize, PROT_READ, MAP_PRIVATE, m_fd, 0 );
+	if( m_map == MAP_FAILED )
+	{
+		m_map = NULL;
+		Unmap();
+		return NULL;
+	}
+
+#ifdef MADV_SEQUENTIAL
+	// Captures are read from start to end, so let the kernel read ahead
+	madvise( m_map, m_mapSize, MADV_SEQUENTIAL );
+#endif
+
+	*_size = (uint32)m_mapSize;
+	return (uint8 const*)m_map;
+}
+
+//-----------------------------------------------------------------------------
+//	<CaptureFileImpl::Unmap>
+//	Release the mapping of a capture file
+//-----------------------------------------------------------------------------
+void CaptureFileImpl::Unmap
+(
+)
+{
+	if( m_map )
+	{
+		munmap( m_map, m_mapSize );
+		m_map = NULL;
+		m_mapSize = 0;
+	}
+	if( m_fd >= 0 )
+	{
+		close( m_fd );
+		m_fd = -1;
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<CaptureFileImpl::GetTime>
+//	Monotonic time in microseconds
+//-----------------------------------------------------------------------------
+uint64 CaptureFileImpl::GetTime
+(
+)
+{
+#ifdef CLOCK_MONOTONIC
+	struct timespec now;
+	clock_gettime( CLOCK_MONOTONIC, &now );
+	return( ( (uint64)now.tv_sec ) * 1000000 + (uint64)( now.tv_nsec / 1000 ) );
+#else
+	struct timeval now;
+	gettimeofday( &now, NULL );
+	return( ( (uint64)now.tv_sec ) * 1000000 + (uint64)now.tv_usec );
+#endif
+}
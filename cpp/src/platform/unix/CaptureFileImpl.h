@@ -0,0 +1,65 @@
+//-----------------------------------------------------------------------------
+//
+//	CaptureFileImpl.h
+//
+//	POSIX implementation of capture file handling
+//
+//	Copyright (c) 2016 The OpenZWave Project
+//	All rights reserved.
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+#ifndef _CaptureFileImpl_H
+#define _CaptureFileImpl_H
+
+#include <stdio.h>
+#include <string>
+#include "Defs.h"
+
+namespace OpenZWave
+{
+	/** \brief POSIX specific implementation of the capture file and its clock.
+	 */
+	class CaptureFileImpl
+	{
+	private:
+		friend class CaptureFile;
+
+		CaptureFileImpl();
+		~CaptureFileImpl();
+
+		bool Create( string const& _filename );
+		void Write( uint8 const* _data, uint32 _length );
+		void Close();
+
+		uint8 const* Map( string const& _filename, uint32* _size );
+		void Unmap();
+
+		uint64 GetTime();				// Monotonic time in microseconds
+
+		FILE*	m_file;					// File being written
+		int		m_fd;					// File being read
+		void*	m_map;
+		size_t	m_mapSize;
+	};
+
+} // namespace OpenZWave
+
+#endif //_CaptureFileImpl_H
+
@@ -50,6 +50,7 @@ LogImpl::LogImpl
 m_filename( _filename ),					// name of log file
 m_bConsoleOutput( _bConsoleOutput ),		// true to provide a copy of output to console
 m_bAppendLog( _bAppendLog ),				// true to append (and not overwrite) any existing log
+m_logQueue( 500 ),						// ring of recent messages, resized by SetQueueDepth
 m_saveLevel( _saveLevel ),					// level of messages to log to file
 m_queueLevel( _queueLevel ),				// level of messages to log to queue
 m_dumpTrigger( _dumpTrigger ),				// dump queued messages when this level is seen
@@ -116,14 +117,12 @@ void LogImpl::Write
 		va_list _args
 )
 {
-	// create a timestamp string
-	string timeStr = GetTimeStampString();
-	string nodeStr = GetNodeString( _nodeId );
-	string loglevelStr = GetLogLevelString(_logLevel);
-
 	// handle this message
 	if( (_logLevel <= m_queueLevel) || (_logLevel == LogLevel_Internal) )	// we're going to do something with this message...
 	{
+		// create a timestamp string
+		string timeStr = GetTimeStampString();
+
 		char lineBuf[1024] = {0};
 		//int lineLen = 0;
 		if( _format != NULL && _format[0] != '\0' )
@@ -138,6 +137,9 @@ void LogImpl::Write
 		// should this message be saved to file (and possibly written to console?)
 		if( (_logLevel <= m_saveLevel) || (_logLevel == LogLevel_Internal) )
 		{
+			string nodeStr = GetNodeString( _nodeId );
+			string loglevelStr = GetLogLevelString(_logLevel);
+
 			std::string outBuf;
 
 			if ( this->pFile != NULL || m_bConsoleOutput )
@@ -189,14 +191,7 @@ void LogImpl::Queue
 		char const* _buffer
 )
 {
-	string bufStr = _buffer;
-	m_logQueue.push_back( bufStr );
-
-	// rudimentary queue size management
-	if( m_logQueue.size() > 500 )
-	{
-		m_logQueue.pop_front();
-	}
+	m_logQueue.Push( _buffer );
 }
 
 //-----------------------------------------------------------------------------
@@ -210,14 +205,11 @@ void LogImpl::QueueDump
 	Log::Write( LogLevel_Always, "" );
 	Log::Write( LogLevel_Always, "Dumping queued log messages");
 	Log::Write( LogLevel_Always, "" );
-	list<string>::iterator it = m_logQueue.begin();
-	while( it != m_logQueue.end() )
+	for( uint32 i=0; i<m_logQueue.GetSize(); ++i )
 	{
-		string strTemp = *it;
-		Log::Write( LogLevel_Internal, strTemp.c_str() );
-		it++;
+		Log::Write( LogLevel_Internal, m_logQueue.Get( i ) );
 	}
-	m_logQueue.clear();
+	m_logQueue.Clear();
 	Log::Write( LogLevel_Always, "" );
 	Log::Write( LogLevel_Always, "End of queued log message dump");
 	Log::Write( LogLevel_Always, "" );
@@ -231,7 +223,19 @@ void LogImpl::QueueClear
 (
 )
 {
-	m_logQueue.clear();
+	m_logQueue.Clear();
+}
+
+//-----------------------------------------------------------------------------
+//	<LogImpl::SetQueueDepth>
+//	Change the number of messages kept for a queue dump
+//-----------------------------------------------------------------------------
+void LogImpl::SetQueueDepth
+(
+	uint32 _depth
+)
+{
+	m_logQueue.SetDepth( _depth );
 }
 
 //-----------------------------------------------------------------------------
@@ -0,0 +1,184 @@
+//-----------------------------------------------------------------------------
+//
+//	WaitSetImpl.cpp
+//
+//	POSIX implementation of the wake-up primitive for a WaitSet
+//
+//	Copyright (c) 2016 The OpenZWave Project
+//	All rights reserved.
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+#include "Defs.h"
+#include "WaitSetImpl.h"
+
+#include <stdio.h>
+#include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <time.h>
+
+#ifdef __linux__
+#include <sys/eventfd.h>
+#include <sys/epoll.h>
+#else
+#include <poll.h>
+#endif
+
+using namespace OpenZWave;
+
+//-----------------------------------------------------------------------------
+//	<WaitSetImpl::WaitSetImpl>
+//	Constructor
+//-----------------------------------------------------------------------------
+WaitSetImpl::WaitSetImpl
+(
+)
+{
+#ifdef __linux__
+	m_eventFd = eventfd( 0, EFD_NONBLOCK | EFD_CLOEXEC );
+	m_epollFd = epoll_create( 1 );
+	if( ( m_eventFd < 0 ) || ( m_epollFd < 0 ) )
+	{
+		fprintf(stderr, "WaitSetImpl::WaitSetImpl eventfd/epoll error %d\n", errno );
+		assert( 0 );
+	}
+
+	struct epoll_event ev;
+	ev.events = EPOLLIN;
+	ev.data.fd = m_eventFd;
+	if( epoll_ctl( m_epollFd, EPOLL_CTL_ADD, m_eventFd, &ev ) != 0 )
+	{
+		fprintf(stderr, "WaitSetImpl::WaitSetImpl epoll_ctl error %d\n", errno );
+		assert( 0 );
+	}
+#else
+	if( pipe( m_pipe ) != 0 )
+	{
+		fprintf(stderr, "WaitSetImpl::WaitSetImpl pipe error %d\n", errno );
+		assert( 0 );
+	}
+	fcntl( m_pipe[0], F_SETFL, fcntl( m_pipe[0], F_GETFL ) | O_NONBLOCK );
+	fcntl( m_pipe[1], F_SETFL, fcntl( m_pipe[1], F_GETFL ) | O_NONBLOCK );
+#endif
+}
+
+//-----------------------------------------------------------------------------
+//	<WaitSetImpl::~WaitSetImpl>
+//	Destructor
+//-----------------------------------------------------------------------------
+WaitSetImpl::~WaitSetImpl
+(
+)
+{
+#ifdef __linux__
+	close( m_epollFd );
+	close( m_eventFd );
+#else
+	close( m_pipe[0] );
+	close( m_pipe[1] );
+#endif
+}
+
+//-----------------------------------------------------------------------------
+//	<WaitSetImpl::Signal>
+//	Wake the waiting thread
+//-----------------------------------------------------------------------------
+void WaitSetImpl::Signal
+(
+)
+{
+	// If a wake-up is already pending, the write fails with EAGAIN (pipe full)
+	// or just adds to the eventfd counter.  Either way the waiter will wake.
+#ifdef __linux__
+	uint64_t value = 1;
+	if( write( m_eventFd, &value, sizeof(value) ) < 0 && errno != EAGAIN )
+#else
+	uint8 value = 1;
+	if( write( m_pipe[1], &value, sizeof(value) ) < 0 && errno != EAGAIN )
+#endif
+	{
+		fprintf(stderr, "WaitSetImpl::Signal write error %d\n", errno );
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<WaitSetImpl::Wait>
+//	Wait for the set to be signalled, and consume the wake-up
+//-----------------------------------------------------------------------------
+bool WaitSetImpl::Wait
+(
+	int32 _timeout
+)
+{
+	int oldstate;
+	int res;
+
+	pthread_setcancelstate(PTHREAD_CANCEL_ENABLE, &oldstate);
+#ifdef __linux__
+	struct epoll_event ev;
+	do
+	{
+		res = epoll_wait( m_epollFd, &ev, 1, _timeout );
+	} while( res < 0 && errno == EINTR );
+#else
+	struct pollfd pfd;
+	pfd.fd = m_pipe[0];
+	pfd.events = POLLIN;
+	do
+	{
+		res = poll( &pfd, 1, _timeout );
+	} while( res < 0 && errno == EINTR );
+#endif
+	pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, &oldstate);
+
+	if( res <= 0 )
+	{
+		return false;
+	}
+
+	// Consume every pending wake-up
+#ifdef __linux__
+	uint64_t value;
+	if( read( m_eventFd, &value, sizeof(value) ) < 0 && errno != EAGAIN )
+	{
+		fprintf(stderr, "WaitSetImpl::Wait read error %d\n", errno );
+	}
+#else
+	uint8 buffer[64];
+	while( read( m_pipe[0], buffer, sizeof(buffer) ) > 0 )
+	{
+	}
+#endif
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//	<WaitSetImpl::Ticks>
+//	Milliseconds from the monotonic clock.  Only differences are meaningful.
+//-----------------------------------------------------------------------------
+uint32 WaitSetImpl::Ticks
+(
+)
+{
+	struct timespec now;
+	clock_gettime( CLOCK_MONOTONIC, &now );
+	return (uint32)( ( now.tv_sec * 1000 ) + ( now.tv_nsec / 1000000 ) );
+}
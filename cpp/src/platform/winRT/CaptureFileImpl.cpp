@@ -0,0 +1,184 @@
+//-----------------------------------------------------------------------------
+//
+//	CaptureFileImpl.cpp
+//
+//	WinRT implementation of capture file handling
+//
+//	Copyright (c) 2016 The OpenZWave Project
+//	All rights reserved.
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+#include <windows.h>
+
+#include "Defs.h"
+#include "CaptureFileImpl.h"
+
+using namespace OpenZWave;
+
+//-----------------------------------------------------------------------------
+//	<CaptureFileImpl::CaptureFileImpl>
+//	Constructor
+//-----------------------------------------------------------------------------
+CaptureFileImpl::CaptureFileImpl
+(
+):
+	m_hFile( INVALID_HANDLE_VALUE ),
+	m_hMapFile( INVALID_HANDLE_VALUE ),
+	m_hMapping( NULL ),
+	m_view( NULL )
+{
+	QueryPerformanceFrequency( &m_frequency );
+}
+
+//-----------------------------------------------------------------------------
+//	<CaptureFileImpl::~CaptureFileImpl>
+//	Destructor
+//-----------------------------------------------------------------------------
+CaptureFileImpl::~CaptureFileImpl
+(
+)
+{
+	Close();
+	Unmap();
+}
+
+//-----------------------------------------------------------------------------
+//	<CaptureFileImpl::Create>
+//	Create a file to write a capture to
+//-----------------------------------------------------------------------------
+bool CaptureFileImpl::Create
+(
+	string const& _filename
+)
+{
+	wstring wFilename( _filename.begin(), _filename.end() );
+	m_hFile = CreateFile2( wFilename.c_str(), GENERIC_WRITE, FILE_SHARE_READ, CREATE_ALWAYS, NULL );
+	return( m_hFile != INVALID_HANDLE_VALUE );
+}
+
+//-----------------------------------------------------------------------------
+//	<CaptureFileImpl::Write>
+//	Append data to the capture file
+//-----------------------------------------------------------------------------
+void CaptureFileImpl::Write
+(
+	uint8 const* _data,
+	uint32 _length
+)
+{
+	if( m_hFile != INVALID_HANDLE_VALUE )
+	{
+		DWORD bytesWritten;
+		WriteFile( m_hFile, _data, _length, &bytesWritten, NULL );
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<CaptureFileImpl::Close>
+//	Close the capture file
+//-----------------------------------------------------------------------------
+void CaptureFileImpl::Close
+(
+)
+{
+	if( m_hFile != INVALID_HANDLE_VALUE )
+	{
+		CloseHandle( m_hFile );
+		m_hFile = INVALID_HANDLE_VALUE;
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<CaptureFileImpl::Map>
+//	Map a capture file into memory for reading
+//-----------------------------------------------------------------------------
+uint8 const* CaptureFileImpl::Map
+(
+	string const& _filename,
+	uint32* _size
+)
+{
+	wstring wFilename( _filename.begin(), _filename.end() );
+	m_hMapFile = CreateFile2( wFilename.c_str(), GENERIC_READ, FILE_SHARE_READ, OPEN_EXISTING, NULL );
+	if( m_hMapFile == INVALID_HANDLE_VALUE )
+	{
+		return NULL;
+	}
+
+	FILE_STANDARD_INFO info;
+	if( !GetFileInformationByHandleEx( m_hMapFile, FileStandardInfo, &info, sizeof(info) ) ||
+		( info.EndOfFile.QuadPart == 0 ) || ( info.EndOfFile.QuadPart > 0xffffffff ) )
+	{
+		Unmap();
+		return NULL;
+	}
+
+	m_hMapping = CreateFileMappingFromApp( m_hMapFile, NULL, PAGE_READONLY, 0, NULL );
+	if( m_hMapping )
+	{
+		m_view = MapViewOfFileFromApp( m_hMapping, FILE_MAP_READ, 0, 0 );
+	}
+	if( !m_view )
+	{
+		Unmap();
+		return NULL;
+	}
+
+	*_size = (uint32)info.EndOfFile.QuadPart;
+	return (uint8 const*)m_view;
+}
+
+//-----------------------------------------------------------------------------
+//	<CaptureFileImpl::Unmap>
+//	Release the mapping of a capture file
+//-----------------------------------------------------------------------------
+void CaptureFileImpl::Unmap
+(
+)
+{
+	if( m_view )
+	{
+		UnmapViewOfFile( m_view );
+		m_view = NULL;
+	}
+	if( m_hMapping )
+	{
+		CloseHandle( m_hMapping );
+		m_hMapping = NULL;
+	}
+	if( m_hMapFile != INVALID_HANDLE_VALUE )
+	{
+		CloseHandle( m_hMapFile );
+		m_hMapFile = INVALID_HANDLE_VALUE;
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<CaptureFileImpl::GetTime>
+//	Monotonic time in microseconds
+//-----------------------------------------------------------------------------
+uint64 CaptureFileImpl::GetTime
+(
+)
+{
+	LARGE_INTEGER now;
+	QueryPerformanceCounter( &now );
+	return( ( (uint64)now.QuadPart / m_frequency.QuadPart ) * 1000000 + ( ( (uint64)now.QuadPart % m_frequency.QuadPart ) * 1000000 ) / m_frequency.QuadPart );
+}
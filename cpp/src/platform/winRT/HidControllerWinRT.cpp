@@ -241,6 +241,8 @@ uint32 HidController::Write
 	uint32 _length
 )
 {
+	CaptureWrite( _buffer, _length );
+
 	// report Id 0x04 is tx feature report
 	return SendFeatureReport(_buffer, _length, 0x04);
 }
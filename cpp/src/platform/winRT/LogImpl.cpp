@@ -77,6 +77,7 @@ LogImpl::LogImpl
 	m_filename( _filename ),					// name of log file
 	m_bAppendLog( _bAppendLog ),				// true to append (and not overwrite) any existing log
 	m_bConsoleOutput( _bConsoleOutput ),		// true to provide a copy of output to console
+	m_logQueue( 500 ),						// ring of recent messages, resized by SetQueueDepth
 	m_saveLevel( _saveLevel ),					// level of messages to log to file
 	m_queueLevel( _queueLevel ),				// level of messages to log to queue
 	m_dumpTrigger( _dumpTrigger )				// dump queued messages when this level is seen
@@ -125,14 +126,12 @@ void LogImpl::Write
 	va_list _args
 )
 {
-	// create a timestamp string
-	string timeStr = GetTimeStampString();
-	string nodeStr = GetNodeString( _nodeId );
-	string logLevelStr = GetLogLevelString(_logLevel);
-
 	// handle this message
 	if( (_logLevel <= m_queueLevel) || (_logLevel == LogLevel_Internal) )	// we're going to do something with this message...
 	{
+		// create a timestamp string
+		string timeStr = GetTimeStampString();
+
 		char lineBuf[1024];
 		if( !_format || ( _format[0] == 0 ) )
 		{
@@ -146,6 +145,9 @@ void LogImpl::Write
 		// should this message be saved to file (and possibly written to console?)
 		if( (_logLevel <= m_saveLevel) || (_logLevel == LogLevel_Internal) )
 		{
+			string nodeStr = GetNodeString( _nodeId );
+			string logLevelStr = GetLogLevelString(_logLevel);
+
 			// save to file
 			FILE* pFile = NULL;
 			if( !fopen_s( &pFile, m_filename.c_str(), "a" ) || m_bConsoleOutput )
@@ -203,14 +205,7 @@ void LogImpl::Queue
 	char const* _buffer
 )
 {
-	string bufStr = _buffer;
-	m_logQueue.push_back( bufStr );
-
-	// rudimentary queue size management
-	if( m_logQueue.size() > 500 )
-	{
-		m_logQueue.pop_front();
-	}
+	m_logQueue.Push( _buffer );
 }
 
 //-----------------------------------------------------------------------------
@@ -222,14 +217,11 @@ void LogImpl::QueueDump
 )
 {
 	Log::Write( LogLevel_Internal, "\n\nDumping queued log messages\n");
-	list<string>::iterator it = m_logQueue.begin();
-	while( it != m_logQueue.end() )
+	for( uint32 i=0; i<m_logQueue.GetSize(); ++i )
 	{
-		string strTemp = *it;
-		Log::Write( LogLevel_Internal, strTemp.c_str() );
-		++it;
+		Log::Write( LogLevel_Internal, m_logQueue.Get( i ) );
 	}
-	m_logQueue.clear();
+	m_logQueue.Clear();
 	Log::Write( LogLevel_Internal, "\nEnd of queued log message dump\n\n");
 }
 
@@ -241,7 +233,19 @@ void LogImpl::QueueClear
 (
 )
 {
-	m_logQueue.clear();
+	m_logQueue.Clear();
+}
+
+//-----------------------------------------------------------------------------
+//	<LogImpl::SetQueueDepth>
+//	Change the number of messages kept for a queue dump
+//-----------------------------------------------------------------------------
+void LogImpl::SetQueueDepth
+(
+	uint32 _depth
+)
+{
+	m_logQueue.SetDepth( _depth );
 }
 
 //-----------------------------------------------------------------------------
@@ -31,6 +31,7 @@
 #include "Defs.h"
 #include <string>
 #include "platform/Log.h"
+#include "platform/LogQueue.h"
 #include "Windows.h"
 
 namespace OpenZWave
@@ -51,6 +52,7 @@ namespace OpenZWave
 		void QueueClear();
 		void SetLoggingState( LogLevel _saveLevel, LogLevel _queueLevel, LogLevel _dumpTrigger );
 		void SetLogFileName( const string &_filename );
+		void SetQueueDepth( uint32 _depth );
 
 		string GetTimeStampString();
 		string GetNodeString( uint8 const _nodeId );
@@ -60,7 +62,7 @@ namespace OpenZWave
 		string m_filename;						/**< filename specified by user (default is ozw_log.txt) */
 		bool m_bConsoleOutput;					/**< if true, send log output to console as well as to the file */
 		bool m_bAppendLog;						/**< if true, the log file should be appended to any with the same name */
-		list<string> m_logQueue;				/**< list of queued log messages */
+		LogQueue m_logQueue;					/**< ring of queued log messages */
 		LogLevel m_saveLevel;
 		LogLevel m_queueLevel;
 		LogLevel m_dumpTrigger;
@@ -0,0 +1,90 @@
+//-----------------------------------------------------------------------------
+//
+//	WaitSetImpl.cpp
+//
+//	WinRT implementation of the wake-up primitive for a WaitSet
+//
+//	Copyright (c) 2016 The OpenZWave Project
+//	All rights reserved.
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+#include <windows.h>
+
+#include "Defs.h"
+#include "WaitSetImpl.h"
+
+using namespace OpenZWave;
+
+//-----------------------------------------------------------------------------
+//	<WaitSetImpl::WaitSetImpl>
+//	Constructor
+//-----------------------------------------------------------------------------
+WaitSetImpl::WaitSetImpl
+(
+)
+{
+	// Create an auto reset event, so that a wait consumes the wake-up
+	m_hEvent = ::CreateEventEx( NULL, NULL, 0, SYNCHRONIZE | EVENT_MODIFY_STATE );
+}
+
+//-----------------------------------------------------------------------------
+//	<WaitSetImpl::~WaitSetImpl>
+//	Destructor
+//-----------------------------------------------------------------------------
+WaitSetImpl::~WaitSetImpl
+(
+)
+{
+	::CloseHandle( m_hEvent );
+}
+
+//-----------------------------------------------------------------------------
+//	<WaitSetImpl::Signal>
+//	Wake the waiting thread
+//-----------------------------------------------------------------------------
+void WaitSetImpl::Signal
+(
+)
+{
+	::SetEvent( m_hEvent );
+}
+
+//-----------------------------------------------------------------------------
+//	<WaitSetImpl::Wait>
+//	Wait for the set to be signalled, and consume the wake-up
+//-----------------------------------------------------------------------------
+bool WaitSetImpl::Wait
+(
+	int32 const _timeout
+)
+{
+	return( WAIT_TIMEOUT != ::WaitForSingleObjectEx( m_hEvent, (DWORD)_timeout, FALSE ) );
+}
+
+//-----------------------------------------------------------------------------
+//	<WaitSetImpl::Ticks>
+//	Milliseconds since the system started.  Only differences are meaningful.
+//-----------------------------------------------------------------------------
+uint32 WaitSetImpl::Ticks
+(
+)
+{
+	return (uint32)::GetTickCount64();
+}
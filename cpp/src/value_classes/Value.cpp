@@ -32,8 +32,10 @@
 #include "Notification.h"
 #include "Msg.h"
 #include "value_classes/Value.h"
+#include "value_classes/ValueDecimal.h"
 #include "platform/Log.h"
 #include "command_classes/CommandClass.h"
+#include "command_classes/WakeUp.h"
 #include <ctime>
 #include "Options.h"
 
@@ -366,7 +368,22 @@ bool Value::Set
 		{
 			if( CommandClass* cc = node->GetCommandClass( m_id.GetCommandClassId() ) )
 			{
+				// This Set replaces any multicast Set of the value still waiting to be confirmed
+				driver->CancelMulticastTarget( m_id );
+
 				Log::Write(LogLevel_Info, m_id.GetNodeId(), "Value::Set - %s - %s - %d - %d - %s", cc->GetCommandClassName().c_str(), this->GetLabel().c_str(), m_id.GetIndex(), m_id.GetInstance(), this->GetAsString().c_str());
+				// A sleeping device is sent only the latest Set of each value, when it wakes up
+				if( !node->IsListeningDevice() )
+				{
+					if( WakeUp* wakeUp = static_cast<WakeUp*>( node->GetCommandClass( WakeUp::StaticGetCommandClassId() ) ) )
+					{
+						if( wakeUp->QueueSet( *this ) )
+						{
+							return true;
+						}
+					}
+				}
+
 				// flag value as set and queue a "Set Value" message for transmission to the device
 				res = cc->SetValue( *this );
 
@@ -434,6 +451,37 @@ void Value::OnValueRefreshed
 }
 
 
+//-----------------------------------------------------------------------------
+// <Value::PublishNumber>
+// Copy the state of a value held as a number to the driver's snapshots
+//-----------------------------------------------------------------------------
+void Value::PublishNumber
+(
+	int32 const _number,
+	uint8 const _precision
+)
+{
+	if( Driver* driver = Manager::Get()->GetDriver( m_id.GetHomeId() ) )
+	{
+		driver->m_valueSnapshots.PublishNumber( m_id, _number, _precision );
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <Value::PublishText>
+// Copy the state of a value held as text to the driver's snapshots
+//-----------------------------------------------------------------------------
+void Value::PublishText
+(
+	string const& _text
+)
+{
+	if( Driver* driver = Manager::Get()->GetDriver( m_id.GetHomeId() ) )
+	{
+		driver->m_valueSnapshots.PublishText( m_id, _text );
+	}
+}
+
 //-----------------------------------------------------------------------------
 // <Value::OnValueChanged>
 // A value in a device has changed
@@ -573,6 +621,16 @@ int Value::VerifyRefreshedValue
 	// to be setting these values after the refesh or notification is sent.  With some
 	// focus on the actual variable storage, we should be able to accomplish this with
 	// memory functions.  It's really the strings that make things complicated(?).
+
+	// Let the driver check the report against any multicast Set still to be confirmed
+	if( ValueID::ValueType_Bool == _type || ValueID::ValueType_Byte == _type )
+	{
+		if( Driver* driver = Manager::Get()->GetDriver( m_id.GetHomeId() ) )
+		{
+			driver->OnMulticastValueReport( m_id, ValueID::ValueType_Bool == _type ? ( *((bool*)_newValue) ? 1 : 0 ) : *((uint8*)_newValue) );
+		}
+	}
+
 	// if this is the first read of a value, assume it is valid (and notify as a change)
 	if( !IsSet() )
 	{
@@ -595,7 +653,14 @@ int Value::VerifyRefreshedValue
 				Log::Write( LogLevel_Detail, m_id.GetNodeId(), "Refreshed Value: old value=%d, new value=%d, type=%s", *((uint8*)_originalValue), *((uint8*)_newValue), GetTypeNameFromEnum(_type) );
 				break;
 			}
-			case ValueID::ValueType_Decimal:		// decimal is stored as a string, so treat it as a string here
+			case ValueID::ValueType_Decimal:		// decimal is stored as a fixed point number
+			{
+				if( Log::IsLevelEnabled( LogLevel_Detail ) )
+				{
+					Log::Write( LogLevel_Detail, m_id.GetNodeId(), "Refreshed Value: old value=%s, new value=%s, type=%s", ((ValueDecimal::FixedPoint*)_originalValue)->ToString().c_str(), ((ValueDecimal::FixedPoint*)_newValue)->ToString().c_str(), GetTypeNameFromEnum(_type) );
+				}
+				break;
+			}
 			case ValueID::ValueType_String:			// string
 			{
 				Log::Write( LogLevel_Detail, m_id.GetNodeId(), "Refreshed Value: old value=%s, new value=%s, type=%s", ((string*)_originalValue)->c_str(), ((string*)_newValue)->c_str(), GetTypeNameFromEnum(_type) );
@@ -628,22 +693,13 @@ int Value::VerifyRefreshedValue
 	}
 	m_refreshTime = time( NULL );	// update value refresh time
 
-	// check whether changes in this value should be verified (since some devices will report values that always
-	// change, where confirming changes is difficult or impossible)
-	Log::Write( LogLevel_Detail, m_id.GetNodeId(), "Changes to this value are %sverified", m_verifyChanges ? "" : "not " );
-
-	if( !m_verifyChanges )
-	{
-		// since we're not checking changes in this value, notify ValueChanged (to be on the safe side)
-		Value::OnValueChanged();
-		return 2;				// confirmed change of value
-	}
-
 	// see if the value has changed (result is used whether checking change or not)
 	bool bOriginalEqual = false;
 	switch( _type )
 	{
-	case ValueID::ValueType_Decimal:		// Decimal is stored as a string
+	case ValueID::ValueType_Decimal:		// Decimal is stored as a fixed point number
+		bOriginalEqual = ( *((ValueDecimal::FixedPoint*)_originalValue) == *((ValueDecimal::FixedPoint*)_newValue) );
+		break;
 	case ValueID::ValueType_String:			// string
 		bOriginalEqual = ( strcmp( ((string*)_originalValue)->c_str(), ((string*)_newValue)->c_str() ) == 0 );
 		break;
@@ -665,10 +721,30 @@ int Value::VerifyRefreshedValue
 		bOriginalEqual = ( memcmp( _originalValue, _newValue, _length ) == 0 );
 		break;
 	case ValueID::ValueType_Schedule:		// Schedule
-		/* Should not get here */
+		/* Can't be compared yet, so always treated as a change */
 		break;
 	}
 
+	// Let the poll scheduler know whether polling this value is turning up anything new
+	if( IsPolled() )
+	{
+		if( Driver* driver = Manager::Get()->GetDriver( m_id.GetHomeId() ) )
+		{
+			driver->OnPolledValueRefreshed( m_id, m_pollIntensity, !bOriginalEqual );
+		}
+	}
+
+	// check whether changes in this value should be verified (since some devices will report values that always
+	// change, where confirming changes is difficult or impossible)
+	Log::Write( LogLevel_Detail, m_id.GetNodeId(), "Changes to this value are %sverified", m_verifyChanges ? "" : "not " );
+
+	if( !m_verifyChanges )
+	{
+		// since we're not checking changes in this value, notify ValueChanged (to be on the safe side)
+		Value::OnValueChanged();
+		return 2;				// confirmed change of value
+	}
+
 		// if this is the first refresh of the value, test to see if the value has changed
 	if( !IsCheckingChange() )
 	{
@@ -691,7 +767,9 @@ int Value::VerifyRefreshedValue
 		bool bCheckEqual = false;
 		switch( _type )
 		{
-		case ValueID::ValueType_Decimal:		// Decimal is stored as a string
+		case ValueID::ValueType_Decimal:		// Decimal is stored as a fixed point number
+			bCheckEqual = ( *((ValueDecimal::FixedPoint*)_checkValue) == *((ValueDecimal::FixedPoint*)_newValue) );
+			break;
 		case ValueID::ValueType_String:			// string
 			bCheckEqual = ( strcmp( ((string*)_checkValue)->c_str(), ((string*)_newValue)->c_str() ) == 0 );
 			break;
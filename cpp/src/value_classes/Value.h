@@ -81,7 +81,9 @@ namespace OpenZWave
 		bool GetChangeVerified() { return m_verifyChanges; }
 
 		virtual string const GetAsString() const { return ""; }
+		virtual bool GetAsNumber( double* ) const { return false; }	// False if the value is not numeric
 		virtual bool SetFromString( string const& ) { return false; }
+		virtual void PublishSnapshot(){}	// Copy the current state to the driver, for readers that do not lock the nodes
 
 		bool Set();							// For the user to change a value in a device
 
@@ -100,6 +102,8 @@ namespace OpenZWave
 		void OnValueRefreshed();			// A value in a device has been refreshed
 		void OnValueChanged();				// The refreshed value actually changed
 		int VerifyRefreshedValue( void* _originalValue, void* _checkValue, void* _newValue, ValueID::ValueType _type, int _length = 0 );
+		void PublishNumber( int32 const _number, uint8 const _precision = 0 );	// Used by PublishSnapshot
+		void PublishText( string const& _text );
 
 		int32		m_min;
 		int32		m_max;
@@ -158,4 +158,6 @@ void ValueBool::OnValueRefreshed
 	case 3:		// all three values are different, so wait for next refresh to try again
 		break;
 	}
+
+	PublishSnapshot();
 }
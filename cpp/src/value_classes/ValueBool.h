@@ -54,6 +54,8 @@ namespace OpenZWave
 
 		// From Value
 		virtual string const GetAsString() const { return ( GetValue() ? "True" : "False" ); }
+		virtual bool GetAsNumber( double* o_number ) const { *o_number = m_value ? 1 : 0; return true; }
+		virtual void PublishSnapshot(){ PublishNumber( m_value ? 1 : 0 ); }
 		virtual bool SetFromString( string const& _value );
 		virtual void ReadXML( uint32 const _homeId, uint8 const _nodeId, uint8 const _commandClassId, TiXmlElement const* _valueElement );
 		virtual void WriteXML( TiXmlElement* _valueElement );
@@ -92,6 +92,7 @@ bool ValueButton::PressButton
 {
 	// Set the value in the device.
 	m_pressed = true;
+	PublishSnapshot();
 	return Value::Set();
 }
 
@@ -105,6 +106,7 @@ bool ValueButton::ReleaseButton
 {
 	// Set the value in the device.
 	m_pressed = false;
+	PublishSnapshot();
 	bool res = Value::Set();
 	if( Driver* driver = Manager::Get()->GetDriver( GetID().GetHomeId() ) )
 	{
@@ -53,6 +53,8 @@ namespace OpenZWave
 		bool ReleaseButton();
 
 		virtual string const GetAsString() const { return ( IsPressed() ? "true" : "false" ); }
+		virtual bool GetAsNumber( double* o_number ) const { *o_number = m_pressed ? 1 : 0; return true; }
+		virtual void PublishSnapshot(){ PublishNumber( m_pressed ? 1 : 0 ); }
 
 		// From Value
 		virtual void ReadXML( uint32 const _homeId, uint8 const _nodeId, uint8 const _commandClassId, TiXmlElement const* _valueElement );
@@ -183,4 +183,6 @@ void ValueByte::OnValueRefreshed
 	case 3:		// all three values are different, so wait for next refresh to try again
 		break;
 	}
+
+	PublishSnapshot();
 }
@@ -25,6 +25,9 @@
 //
 //-----------------------------------------------------------------------------
 
+#include <stdio.h>
+#include <locale.h>
+#include <ctype.h>
 #include "tinyxml.h"
 #include "value_classes/ValueDecimal.h"
 #include "Msg.h"
@@ -34,6 +37,13 @@
 
 using namespace OpenZWave;
 
+// Z-Wave sends at most seven decimal places, but text typed by a user may have more.
+// Up to nine are kept from text, as long as the number still fits in an int32.
+static uint8 const c_maxPrecision = 9;
+static int32 const c_powersOfTen[c_maxPrecision+1] =
+{
+	1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+};
 
 //-----------------------------------------------------------------------------
 // <ValueDecimal::ValueDecimal>
@@ -55,11 +65,12 @@ ValueDecimal::ValueDecimal
 	uint8 const _pollIntensity
 ):
   	Value( _homeId, _nodeId, _genre, _commandClassId, _instance, _index, ValueID::ValueType_Decimal, _label, _units, _readOnly, _writeOnly, false, _pollIntensity ),
-	m_value( _value ),
-	m_valueCheck( "" ),
-	m_newValue( "" ),
-	m_precision( 0 )
+	m_value()
 {
+	if( !FixedPoint::FromString( _value, &m_value ) )
+	{
+		Log::Write( LogLevel_Warning, "Decimal value %s is out of range, using %s: node %d, class 0x%02x, instance %d, index %d", _value.c_str(), m_value.ToString().c_str(), _nodeId, _commandClassId, _instance, _index );
+	}
 }
 
 //-----------------------------------------------------------------------------
@@ -79,7 +90,10 @@ void ValueDecimal::ReadXML
 	char const* str = _valueElement->Attribute( "value" );
 	if( str )
 	{
-		m_value = str;
+		if( !FixedPoint::FromString( str, &m_value ) )
+		{
+			Log::Write( LogLevel_Warning, "Decimal value %s in xml configuration is out of range, using %s: node %d, class 0x%02x, instance %d, index %d", str, m_value.ToString().c_str(), _nodeId, _commandClassId, GetID().GetInstance(), GetID().GetIndex() );
+		}
 	}
 	else
 	{
@@ -97,7 +111,7 @@ void ValueDecimal::WriteXML
 )
 {
 	Value::WriteXML( _valueElement );
-	_valueElement->SetAttribute( "value", m_value.c_str() );
+	_valueElement->SetAttribute( "value", m_value.ToString().c_str() );
 }
 
 //-----------------------------------------------------------------------------
@@ -109,9 +123,17 @@ bool ValueDecimal::Set
 	string const& _value
 )
 {
+	// Refuse a number that cannot be held, rather than sending a different one to the device
+	FixedPoint value;
+	if( !FixedPoint::FromString( _value, &value ) )
+	{
+		Log::Write( LogLevel_Warning, "Decimal value %s is out of range: node %d, class 0x%02x, instance %d, index %d", _value.c_str(), GetID().GetNodeId(), GetID().GetCommandClassId(), GetID().GetInstance(), GetID().GetIndex() );
+		return false;
+	}
+
 	// create a temporary copy of this value to be submitted to the Set() call and set its value to the function param
   	ValueDecimal* tempValue = new ValueDecimal( *this );
-	tempValue->m_value = _value;
+	tempValue->m_value = value;
 
 	// Set the value in the device.
 	bool ret = ((Value*)tempValue)->Set();
@@ -128,20 +150,149 @@ bool ValueDecimal::Set
 //-----------------------------------------------------------------------------
 void ValueDecimal::OnValueRefreshed
 (
-	string const& _value
+	int32 const _value,
+	uint8 const _precision
 )
 {
-	switch( VerifyRefreshedValue( (void*) &m_value, (void*) &m_valueCheck, (void*) &_value, ValueID::ValueType_Decimal) )
+	FixedPoint value( _value, _precision );
+	switch( VerifyRefreshedValue( (void*) &m_value, (void*) &m_valueCheck, (void*) &value, ValueID::ValueType_Decimal) )
 	{
 	case 0:		// value hasn't changed, nothing to do
 		break;
 	case 1:		// value has changed (not confirmed yet), save _value in m_valueCheck
-		m_valueCheck = _value;
+		m_valueCheck = value;
 		break;
 	case 2:		// value has changed (confirmed), save _value in m_value
-		m_value = _value;
+		m_value = value;
 		break;
 	case 3:		// all three values are different, so wait for next refresh to try again
 		break;
 	}
+
+	PublishSnapshot();
+}
+
+//-----------------------------------------------------------------------------
+// <ValueDecimal::FixedPoint::operator ==>
+// Compare two numbers, which may have different numbers of decimal places
+//-----------------------------------------------------------------------------
+bool ValueDecimal::FixedPoint::operator ==
+(
+	FixedPoint const& _other
+)const
+{
+	if( m_precision == _other.m_precision )
+	{
+		return( m_value == _other.m_value );
+	}
+
+	// Bring both to the larger precision.  Neither can exceed c_maxPrecision.
+	int64 value = m_value;
+	int64 other = _other.m_value;
+	if( m_precision < _other.m_precision )
+	{
+		value *= c_powersOfTen[_other.m_precision - m_precision];
+	}
+	else
+	{
+		other *= c_powersOfTen[m_precision - _other.m_precision];
+	}
+	return( value == other );
+}
+
+//-----------------------------------------------------------------------------
+// <ValueDecimal::FixedPoint::ToDouble>
+// Convert to floating point
+//-----------------------------------------------------------------------------
+double ValueDecimal::FixedPoint::ToDouble
+(
+)const
+{
+	// Powers of ten this small are exact, so the result is the closest double to
+	// the decimal number, just as parsing its text would give.
+	return( (double)m_value / c_powersOfTen[m_precision] );
+}
+
+//-----------------------------------------------------------------------------
+// <ValueDecimal::FixedPoint::ToString>
+// Convert to text with exactly m_precision decimal places.  We avoid using
+// floats to prevent accuracy issues.
+//-----------------------------------------------------------------------------
+string ValueDecimal::FixedPoint::ToString
+(
+)const
+{
+	char buf[24];
+	if( m_precision == 0 )
+	{
+		snprintf( buf, sizeof(buf), "%d", m_value );
+		return buf;
+	}
+
+	uint32 magnitude = ( m_value < 0 ) ? ( 0 - (uint32)m_value ) : (uint32)m_value;
+	uint32 divisor = (uint32)c_powersOfTen[m_precision];
+	struct lconv const* locale = localeconv();
+	snprintf( buf, sizeof(buf), "%s%u%c%0*u", ( m_value < 0 ) ? "-" : "", magnitude / divisor, *(locale->decimal_point), (int)m_precision, magnitude % divisor );
+	return buf;
+}
+
+//-----------------------------------------------------------------------------
+// <ValueDecimal::FixedPoint::FromString>
+// Convert text, such as that typed by a user or saved in the config file.
+// A whole part too big for an int32 is clamped to the largest one, and false
+// is returned so that the caller can report it.
+//-----------------------------------------------------------------------------
+bool ValueDecimal::FixedPoint::FromString
+(
+	string const& _value,
+	FixedPoint* o_value
+)
+{
+	char const* str = _value.c_str();
+	while( isspace( (unsigned char)*str ) )
+	{
+		++str;
+	}
+
+	bool negative = ( *str == '-' );
+	if( *str == '-' || *str == '+' )
+	{
+		++str;
+	}
+
+	// The magnitude of an int32 can be one larger when it is negative
+	int64 const limit = negative ? 2147483648LL : 2147483647LL;
+
+	// Whole part
+	int64 magnitude = 0;
+	bool inRange = true;
+	for( ; isdigit( (unsigned char)*str ); ++str )
+	{
+		magnitude = magnitude * 10 + ( *str - '0' );
+		if( magnitude > limit )
+		{
+			magnitude = limit;
+			inRange = false;
+		}
+	}
+
+	// Fractional part, with either '.' or ',' as the decimal point.  Digits are kept
+	// until one more would no longer fit, and the rest are dropped.
+	uint8 precision = 0;
+	if( *str == '.' || *str == ',' )
+	{
+		for( ++str; isdigit( (unsigned char)*str ) && precision < c_maxPrecision; ++str )
+		{
+			int64 next = magnitude * 10 + ( *str - '0' );
+			if( next > limit )
+			{
+				break;
+			}
+			magnitude = next;
+			++precision;
+		}
+	}
+
+	*o_value = FixedPoint( (int32)( negative ? -magnitude : magnitude ), precision );
+	return inRange;
 }
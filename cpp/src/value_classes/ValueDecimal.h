@@ -40,6 +40,10 @@ namespace OpenZWave
 	class Node;
 
 	/** \brief Decimal value sent to/received from a node.
+	 *
+	 * The value is held as a whole number of units of its last decimal place, together
+	 * with the number of decimal places, as it is sent by the device.  Text is only made
+	 * when the value is asked for as a string.
 	 */
 	class ValueDecimal: public Value
 	{
@@ -49,29 +53,44 @@ namespace OpenZWave
 		friend class ThermostatSetpoint;
 
 	public:
+		/** \brief A decimal number with a fixed number of decimal places. */
+		struct FixedPoint
+		{
+			FixedPoint( int32 const _value = 0, uint8 const _precision = 0 ): m_value( _value ), m_precision( _precision ){}
+
+			bool operator == ( FixedPoint const& _other )const;		// Compares the numbers, so 1.5 equals 1.50
+			bool operator != ( FixedPoint const& _other )const{ return !( *this == _other ); }
+
+			double ToDouble()const;
+			string ToString()const;									// Uses the decimal point of the current locale
+			static bool FromString( string const& _value, FixedPoint* o_value );	// Accepts either '.' or ',' as the decimal point.  False if the whole part is too big for an int32
+
+			int32	m_value;				// the number, multiplied by ten to the power of m_precision
+			uint8	m_precision;			// number of decimal places
+		};
+
 		ValueDecimal( uint32 const _homeId, uint8 const _nodeId, ValueID::ValueGenre const _genre, uint8 const _commandClassId, uint8 const _instance, uint8 const _index, string const& _label, string const& _units, bool const _readOnly, bool const _writeOnly, string const& _value, uint8 const _pollIntensity );
-		ValueDecimal(): m_precision( 0 ){}
+		ValueDecimal(){}
 		virtual ~ValueDecimal(){}
 
 		bool Set( string const& _value );
-		void OnValueRefreshed( string const& _value );
+		void OnValueRefreshed( int32 const _value, uint8 const _precision );
 
 		// From Value
 		virtual string const GetAsString() const { return GetValue(); }
+		virtual bool GetAsNumber( double* o_number ) const { *o_number = m_value.ToDouble(); return true; }
+		virtual void PublishSnapshot(){ PublishNumber( m_value.m_value, m_value.m_precision ); }
 		virtual bool SetFromString( string const& _value ) { return Set( _value ); }
 		virtual void ReadXML( uint32 const _homeId, uint8 const _nodeId, uint8 const _commandClassId, TiXmlElement const* _valueElement );
 		virtual void WriteXML( TiXmlElement* _valueElement );
 
-		string GetValue()const{ return m_value; }
-		uint8 GetPrecision()const{ return m_precision; }
+		string GetValue()const{ return m_value.ToString(); }
+		uint8 GetPrecision()const{ return m_value.m_precision; }
 
 	private:
-		void SetPrecision( uint8 _precision ){ m_precision = _precision; }
-
-		string	m_value;				// the current value
-		string	m_valueCheck;			// the previous value (used for double-checking spurious value reads)
-		string	m_newValue;				// a new value to be set on the appropriate device
-	        uint8	m_precision;
+		FixedPoint	m_value;				// the current value
+		FixedPoint	m_valueCheck;			// the previous value (used for double-checking spurious value reads)
+		FixedPoint	m_newValue;				// a new value to be set on the appropriate device
 	};
 
 } // namespace OpenZWave
@@ -0,0 +1,215 @@
+//-----------------------------------------------------------------------------
+//
+//	ValueIDIndex.h
+//
+//	Hash table keyed by the 64 bit id of a ValueID
+//
+//	Copyright (c) 2016 The OpenZWave Project
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#ifndef _ValueIDIndex_H
+#define _ValueIDIndex_H
+
+#include <vector>
+#include "Defs.h"
+#include "value_classes/ValueID.h"
+
+namespace OpenZWave
+{
+	/** \brief Hash table mapping the values of one Z-Wave network to items of type T.
+	 *
+	 * The table is keyed by ValueID::GetId(), which is unique within a network, so
+	 * an index must only hold values that share a home id.  It uses open addressing
+	 * with linear probing, and removes entries by shifting the rest of their probe
+	 * run back, so lookups never have to step over deleted slots.
+	 */
+	template<class T> class ValueIDIndex
+	{
+	public:
+		ValueIDIndex(): m_count( 0 ){}
+
+		/**
+		 * Find the item stored for a value.
+		 * \param _id The value to look up.
+		 * \return A pointer to the item, or NULL if the value is not in the index.  The
+		 * pointer is only valid until the next Insert or Erase.
+		 */
+		T* Find( ValueID const& _id )
+		{
+			if( m_count == 0 )
+			{
+				return NULL;
+			}
+
+			uint64 id = _id.GetId();
+			size_t mask = m_slots.size() - 1;
+			for( size_t i = Hash( id ) & mask; m_slots[i].m_used; i = (i+1) & mask )
+			{
+				if( m_slots[i].m_id == id )
+				{
+					return &m_slots[i].m_item;
+				}
+			}
+			return NULL;
+		}
+
+		/**
+		 * Add a value to the index.
+		 * \param _id The value to add.
+		 * \param _item The item to store for the value.  If the value is already
+		 * in the index, its item is replaced.
+		 * \return A reference to the stored item, valid until the next Insert or Erase.
+		 */
+		T& Insert( ValueID const& _id, T const& _item )
+		{
+			// Keep the table no more than half full
+			if( ( m_count + 1 ) * 2 > m_slots.size() )
+			{
+				Grow();
+			}
+
+			uint64 id = _id.GetId();
+			size_t mask = m_slots.size() - 1;
+			size_t i = Hash( id ) & mask;
+			while( m_slots[i].m_used && m_slots[i].m_id != id )
+			{
+				i = (i+1) & mask;
+			}
+
+			if( !m_slots[i].m_used )
+			{
+				m_slots[i].m_used = true;
+				m_slots[i].m_id = id;
+				++m_count;
+			}
+			m_slots[i].m_item = _item;
+			return m_slots[i].m_item;
+		}
+
+		/**
+		 * Remove a value from the index.
+		 * \param _id The value to remove.
+		 * \return True if the value was in the index.
+		 */
+		bool Erase( ValueID const& _id )
+		{
+			if( m_count == 0 )
+			{
+				return false;
+			}
+
+			uint64 id = _id.GetId();
+			size_t mask = m_slots.size() - 1;
+			size_t i = Hash( id ) & mask;
+			while( m_slots[i].m_id != id || !m_slots[i].m_used )
+			{
+				if( !m_slots[i].m_used )
+				{
+					return false;
+				}
+				i = (i+1) & mask;
+			}
+
+			// Move back any later entry in the run that would otherwise no longer be found
+			size_t j = i;
+			while( true )
+			{
+				j = (j+1) & mask;
+				if( !m_slots[j].m_used )
+				{
+					break;
+				}
+
+				size_t home = Hash( m_slots[j].m_id ) & mask;
+				if( ( ( j - home ) & mask ) >= ( ( j - i ) & mask ) )
+				{
+					m_slots[i] = m_slots[j];
+					i = j;
+				}
+			}
+
+			m_slots[i].m_used = false;
+			m_slots[i].m_item = T();
+			--m_count;
+			return true;
+		}
+
+		/**
+		 * \return The number of values in the index.
+		 */
+		size_t Size()const{ return m_count; }
+
+		/**
+		 * Remove every value from the index.
+		 */
+		void Clear()
+		{
+			m_slots.clear();
+			m_count = 0;
+		}
+
+	private:
+		struct Slot
+		{
+			Slot(): m_id( 0 ), m_used( false ), m_item(){}
+
+			uint64	m_id;
+			bool	m_used;
+			T		m_item;
+		};
+
+		static size_t Hash( uint64 _id )
+		{
+			// ValueIDs differ mostly in a few bit fields, so mix them across the word
+			_id ^= _id >> 33;
+			_id *= 0xff51afd7ed558ccdULL;
+			_id ^= _id >> 33;
+			return (size_t)_id;
+		}
+
+		void Grow()
+		{
+			std::vector<Slot> old;
+			old.swap( m_slots );
+			m_slots.resize( old.empty() ? 16 : old.size() * 2 );
+
+			size_t mask = m_slots.size() - 1;
+			for( typename std::vector<Slot>::const_iterator it = old.begin(); it != old.end(); ++it )
+			{
+				if( it->m_used )
+				{
+					size_t i = Hash( it->m_id ) & mask;
+					while( m_slots[i].m_used )
+					{
+						i = (i+1) & mask;
+					}
+					m_slots[i] = *it;
+				}
+			}
+		}
+
+		std::vector<Slot>	m_slots;	// Table size is always zero or a power of two
+		size_t				m_count;	// Number of slots in use
+	};
+
+} // namespace OpenZWave
+
+#endif
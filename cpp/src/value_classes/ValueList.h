@@ -64,6 +64,8 @@ namespace OpenZWave
 
 		// From Value
 		virtual string const GetAsString() const { return GetItem()->m_label; }
+		virtual bool GetAsNumber( double* o_number ) const { if( Item const* item = GetItem() ) { *o_number = item->m_value; return true; } return false; }
+		virtual void PublishSnapshot(){ if( Item const* item = GetItem() ) PublishText( item->m_label ); }
 		virtual bool SetFromString( string const& _value ) { return SetByLabel( _value ); }
 		virtual void ReadXML( uint32 const _homeId, uint8 const _nodeId, uint8 const _commandClassId, TiXmlElement const* _valueElement );
 		virtual void WriteXML( TiXmlElement* _valueElement );
@@ -188,4 +188,6 @@ void ValueShort::OnValueRefreshed
 	case 3:		// all three values are different, so wait for next refresh to try again
 		break;
 	}
+
+	PublishSnapshot();
 }
@@ -0,0 +1,542 @@
+//-----------------------------------------------------------------------------
+//
+//	ValueSnapshots.cpp
+//
+//	Copies of the current values of a network that can be read without locking
+//
+//	Copyright (c) 2016 The OpenZWave Project
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include <string.h>
+#include "value_classes/ValueSnapshots.h"
+
+#ifdef _MSC_VER
+#include <windows.h>
+#endif
+
+using namespace OpenZWave;
+
+// Number of times a read is retried while writers keep changing what it is reading
+static int const c_maxReadAttempts = 16;
+
+//-----------------------------------------------------------------------------
+//	<AtomicCompareExchange>
+//	Set a value shared between threads to _new if it is still _old, with a
+//	full memory barrier.  Returns true if the value was changed.
+//-----------------------------------------------------------------------------
+static inline bool AtomicCompareExchange
+(
+	volatile uint32* _value,
+	uint32 _old,
+	uint32 _new
+)
+{
+#ifdef _MSC_VER
+	return( (uint32)InterlockedCompareExchange( (volatile LONG*)_value, (LONG)_new, (LONG)_old ) == _old );
+#else
+	return __sync_bool_compare_and_swap( _value, _old, _new );
+#endif
+}
+
+//-----------------------------------------------------------------------------
+//	<AtomicIncrement>
+//	Add one to a value shared between threads, with a full memory barrier
+//-----------------------------------------------------------------------------
+static inline void AtomicIncrement
+(
+	volatile uint32* _value
+)
+{
+#ifdef _MSC_VER
+	InterlockedIncrement( (volatile LONG*)_value );
+#else
+	__sync_add_and_fetch( _value, 1 );
+#endif
+}
+
+//-----------------------------------------------------------------------------
+//	<MemoryFence>
+//	Full memory barrier
+//-----------------------------------------------------------------------------
+static inline void MemoryFence
+(
+)
+{
+#ifdef _MSC_VER
+	MemoryBarrier();
+#else
+	__sync_synchronize();
+#endif
+}
+
+//-----------------------------------------------------------------------------
+// <ValueSnapshots::ValueSnapshots>
+// Constructor
+//-----------------------------------------------------------------------------
+ValueSnapshots::ValueSnapshots
+(
+):
+	m_sequence( 0 ),
+	m_generation( 0 ),
+	m_table( NULL ),
+	m_count( 0 )
+{
+}
+
+//-----------------------------------------------------------------------------
+// <ValueSnapshots::~ValueSnapshots>
+// Destructor
+//-----------------------------------------------------------------------------
+ValueSnapshots::~ValueSnapshots
+(
+)
+{
+	for( vector<Table*>::iterator it = m_tables.begin(); it != m_tables.end(); ++it )
+	{
+		delete *it;
+	}
+
+	for( vector<Slot*>::iterator it = m_blocks.begin(); it != m_blocks.end(); ++it )
+	{
+		delete [] *it;
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <ValueSnapshots::Add>
+// Make a slot for a value
+//-----------------------------------------------------------------------------
+void ValueSnapshots::Add
+(
+	ValueID const& _id
+)
+{
+	uint64 id = _id.GetId();
+	if( Find( id ) != NULL )
+	{
+		return;
+	}
+
+	if( m_freeSlots.empty() )
+	{
+		Slot* block = new Slot[c_blockSize];
+		memset( block, 0, sizeof(Slot) * c_blockSize );
+		m_blocks.push_back( block );
+		for( int i = c_blockSize-1; i >= 0; --i )
+		{
+			m_freeSlots.push_back( &block[i] );
+		}
+	}
+
+	Slot* slot = m_freeSlots.back();
+	m_freeSlots.pop_back();
+
+	// A reader may still be looking at this slot for the value that last used it
+	LockSlot( slot );
+	slot->m_id = id;
+	slot->m_state = SlotState_Empty;
+	UnlockSlot( slot );
+
+	Table* table = m_table;
+	if( table == NULL || ( m_count + 1 ) * 2 > table->m_mask + 1 )
+	{
+		// Fill a bigger table before anyone can see it.  The old one is kept,
+		// since a reader may still be probing it.
+		Table* bigger = new Table();
+		bigger->m_entries.resize( table == NULL ? 16 : ( table->m_mask + 1 ) * 2 );
+		bigger->m_mask = bigger->m_entries.size() - 1;
+		if( table != NULL )
+		{
+			for( vector<Entry>::const_iterator it = table->m_entries.begin(); it != table->m_entries.end(); ++it )
+			{
+				if( it->m_slot != NULL )
+				{
+					size_t i = Hash( it->m_id ) & bigger->m_mask;
+					while( bigger->m_entries[i].m_slot != NULL )
+					{
+						i = (i+1) & bigger->m_mask;
+					}
+					bigger->m_entries[i] = *it;
+				}
+			}
+		}
+		m_tables.push_back( bigger );
+		table = bigger;
+	}
+
+	m_sequence++;
+	MemoryFence();
+
+	size_t i = Hash( id ) & table->m_mask;
+	while( table->m_entries[i].m_slot != NULL )
+	{
+		i = (i+1) & table->m_mask;
+	}
+	table->m_entries[i].m_id = id;
+	table->m_entries[i].m_slot = slot;
+	m_table = table;
+	++m_count;
+
+	MemoryFence();
+	m_sequence++;
+	Changed();
+}
+
+//-----------------------------------------------------------------------------
+// <ValueSnapshots::Remove>
+// Free the slot of a value
+//-----------------------------------------------------------------------------
+void ValueSnapshots::Remove
+(
+	ValueID const& _id
+)
+{
+	Table* table = m_table;
+	if( table == NULL )
+	{
+		return;
+	}
+
+	uint64 id = _id.GetId();
+	size_t mask = table->m_mask;
+	size_t i = Hash( id ) & mask;
+	while( table->m_entries[i].m_id != id || table->m_entries[i].m_slot == NULL )
+	{
+		if( table->m_entries[i].m_slot == NULL )
+		{
+			return;
+		}
+		i = (i+1) & mask;
+	}
+	Slot* slot = table->m_entries[i].m_slot;
+
+	m_sequence++;
+	MemoryFence();
+
+	// Move back any later entry in the run that would otherwise no longer be found
+	size_t j = i;
+	while( true )
+	{
+		j = (j+1) & mask;
+		if( table->m_entries[j].m_slot == NULL )
+		{
+			break;
+		}
+
+		size_t home = Hash( table->m_entries[j].m_id ) & mask;
+		if( ( ( j - home ) & mask ) >= ( ( j - i ) & mask ) )
+		{
+			table->m_entries[i] = table->m_entries[j];
+			i = j;
+		}
+	}
+	table->m_entries[i].m_slot = NULL;
+	--m_count;
+
+	MemoryFence();
+	m_sequence++;
+
+	LockSlot( slot );
+	slot->m_id = 0;
+	slot->m_state = SlotState_Empty;
+	UnlockSlot( slot );
+	m_freeSlots.push_back( slot );
+	Changed();
+}
+
+//-----------------------------------------------------------------------------
+// <ValueSnapshots::PublishNumber>
+// Store the current state of a value held as a number
+//-----------------------------------------------------------------------------
+void ValueSnapshots::PublishNumber
+(
+	ValueID const& _id,
+	int32 const _number,
+	uint8 const _precision
+)
+{
+	if( Slot* slot = BeginWrite( _id.GetId() ) )
+	{
+		bool changed = ( slot->m_state != SlotState_Number || slot->m_number != _number || slot->m_precision != _precision );
+		slot->m_state = SlotState_Number;
+		slot->m_number = _number;
+		slot->m_precision = _precision;
+		UnlockSlot( slot );
+		if( changed )
+		{
+			Changed();
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <ValueSnapshots::PublishText>
+// Store the current state of a value held as text
+//-----------------------------------------------------------------------------
+void ValueSnapshots::PublishText
+(
+	ValueID const& _id,
+	string const& _text
+)
+{
+	if( Slot* slot = BeginWrite( _id.GetId() ) )
+	{
+		// Text too long for the slot is never known to be unchanged
+		bool changed = ( slot->m_state != SlotState_Text || slot->m_length != _text.size() || memcmp( slot->m_text, _text.data(), slot->m_length ) != 0 );
+		if( _text.size() <= c_textSize )
+		{
+			slot->m_state = SlotState_Text;
+			slot->m_length = (uint8)_text.size();
+			memcpy( slot->m_text, _text.data(), _text.size() );
+		}
+		else
+		{
+			// Readers must fall back to the value itself
+			slot->m_state = SlotState_Empty;
+		}
+		UnlockSlot( slot );
+		if( changed )
+		{
+			Changed();
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <ValueSnapshots::Read>
+// Read the last published state of a value
+//-----------------------------------------------------------------------------
+bool ValueSnapshots::Read
+(
+	ValueID const& _id,
+	int32* o_number,
+	string* o_text,
+	uint8* o_precision
+)const
+{
+	uint64 id = _id.GetId();
+	Slot const* slot = Find( id );
+	if( slot == NULL )
+	{
+		return false;
+	}
+
+	for( int attempt = 0; attempt < c_maxReadAttempts; ++attempt )
+	{
+		uint32 sequence = slot->m_sequence;
+		MemoryFence();
+		if( sequence & 1 )
+		{
+			continue;
+		}
+
+		// Copy everything, and only look at it once the copy is known to be consistent
+		uint64 slotId = slot->m_id;
+		uint8 state = slot->m_state;
+		uint8 length = slot->m_length;
+		uint8 precision = slot->m_precision;
+		int32 number = slot->m_number;
+		char text[c_textSize];
+		memcpy( text, slot->m_text, sizeof(text) );
+
+		MemoryFence();
+		if( slot->m_sequence != sequence )
+		{
+			continue;
+		}
+
+		if( slotId != id )
+		{
+			// The value was removed after its slot was found
+			return false;
+		}
+
+		if( SlotState_Number == state && o_number != NULL )
+		{
+			if( o_precision != NULL )
+			{
+				*o_precision = precision;
+			}
+			else if( precision != 0 )
+			{
+				return false;
+			}
+			*o_number = number;
+			return true;
+		}
+
+		if( SlotState_Text == state && o_text != NULL && length <= c_textSize )
+		{
+			o_text->assign( text, length );
+			return true;
+		}
+
+		return false;
+	}
+
+	return false;
+}
+
+//-----------------------------------------------------------------------------
+// <ValueSnapshots::GetGeneration>
+// Count of changes to the published values
+//-----------------------------------------------------------------------------
+uint32 ValueSnapshots::GetGeneration
+(
+)const
+{
+	uint32 generation = m_generation;
+	MemoryFence();
+	return generation;
+}
+
+//-----------------------------------------------------------------------------
+// <ValueSnapshots::Find>
+// Look up the slot of a value
+//-----------------------------------------------------------------------------
+ValueSnapshots::Slot* ValueSnapshots::Find
+(
+	uint64 const _id
+)const
+{
+	for( int attempt = 0; attempt < c_maxReadAttempts; ++attempt )
+	{
+		uint32 sequence = m_sequence;
+		MemoryFence();
+		if( sequence & 1 )
+		{
+			continue;
+		}
+
+		Slot* slot = NULL;
+		if( Table const* table = m_table )
+		{
+			// Never probe more than the whole table, even if it is being changed under us
+			size_t mask = table->m_mask;
+			size_t i = Hash( _id ) & mask;
+			for( size_t n = 0; n <= mask; ++n, i = (i+1) & mask )
+			{
+				Entry const& entry = table->m_entries[i];
+				if( entry.m_slot == NULL )
+				{
+					break;
+				}
+				if( entry.m_id == _id )
+				{
+					slot = entry.m_slot;
+					break;
+				}
+			}
+		}
+
+		MemoryFence();
+		if( m_sequence == sequence )
+		{
+			return slot;
+		}
+	}
+
+	return NULL;
+}
+
+//-----------------------------------------------------------------------------
+// <ValueSnapshots::BeginWrite>
+// Find the slot of a value, and lock it for writing
+//-----------------------------------------------------------------------------
+ValueSnapshots::Slot* ValueSnapshots::BeginWrite
+(
+	uint64 const _id
+)
+{
+	Slot* slot = Find( _id );
+	if( slot == NULL )
+	{
+		return NULL;
+	}
+
+	LockSlot( slot );
+	if( slot->m_id != _id )
+	{
+		// The slot was freed, and possibly reused, after it was found
+		UnlockSlot( slot );
+		return NULL;
+	}
+	return slot;
+}
+
+//-----------------------------------------------------------------------------
+// <ValueSnapshots::LockSlot>
+// Make the sequence count of a slot odd
+//-----------------------------------------------------------------------------
+void ValueSnapshots::LockSlot
+(
+	Slot* _slot
+)
+{
+	// A value normally only has one writer, so this hardly ever spins
+	while( true )
+	{
+		uint32 sequence = _slot->m_sequence;
+		if( !( sequence & 1 ) && AtomicCompareExchange( &_slot->m_sequence, sequence, sequence + 1 ) )
+		{
+			return;
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <ValueSnapshots::UnlockSlot>
+// Make the sequence count of a slot even again
+//-----------------------------------------------------------------------------
+void ValueSnapshots::UnlockSlot
+(
+	Slot* _slot
+)
+{
+	MemoryFence();
+	_slot->m_sequence++;
+}
+
+//-----------------------------------------------------------------------------
+// <ValueSnapshots::Changed>
+// Move the generation on.  Values are published from more than one thread.
+//-----------------------------------------------------------------------------
+void ValueSnapshots::Changed
+(
+)
+{
+	AtomicIncrement( &m_generation );
+}
+
+//-----------------------------------------------------------------------------
+// <ValueSnapshots::Hash>
+// ValueIDs differ mostly in a few bit fields, so mix them across the word
+//-----------------------------------------------------------------------------
+size_t ValueSnapshots::Hash
+(
+	uint64 _id
+)
+{
+	_id ^= _id >> 33;
+	_id *= 0xff51afd7ed558ccdULL;
+	_id ^= _id >> 33;
+	return (size_t)_id;
+}
@@ -0,0 +1,168 @@
+//-----------------------------------------------------------------------------
+//
+//	ValueSnapshots.h
+//
+//	Copies of the current values of a network that can be read without locking
+//
+//	Copyright (c) 2016 The OpenZWave Project
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#ifndef _ValueSnapshots_H
+#define _ValueSnapshots_H
+
+#include <string>
+#include <vector>
+#include "Defs.h"
+#include "value_classes/ValueID.h"
+
+namespace OpenZWave
+{
+	/** \brief Copies of the current values of one Z-Wave network, which can be read
+	 * without taking any lock.
+	 *
+	 * Each value has a fixed size slot holding either a number or a short piece of
+	 * text.  A slot is guarded by a sequence count, in the manner of a seqlock: the
+	 * writer makes the count odd while it changes the slot, and a reader copies the
+	 * slot and then checks that the count was even and has not moved.  The slots are
+	 * found through an open addressing table that is guarded in the same way.
+	 *
+	 * Slots and outgrown tables are only freed with the ValueSnapshots object itself,
+	 * so a reader that races a writer may see data that is out of date, which the
+	 * sequence count rejects, but never memory that has been freed.
+	 *
+	 * Values are added and removed with the driver's node mutex held.  Publishing and
+	 * reading need no lock.
+	 */
+	class ValueSnapshots
+	{
+	public:
+		ValueSnapshots();
+		~ValueSnapshots();
+
+		/**
+		 * Make a slot for a value.  Until the value is published, reads of it fail.
+		 * The driver's node mutex must be held.
+		 * \param _id The value to add.
+		 */
+		void Add( ValueID const& _id );
+
+		/**
+		 * Free the slot of a value.  The driver's node mutex must be held.
+		 * \param _id The value to remove.
+		 */
+		void Remove( ValueID const& _id );
+
+		/**
+		 * Store the current state of a value that is held as a number.
+		 * \param _id The value that has changed.
+		 * \param _number The new value, multiplied by ten to the power of _precision.
+		 * \param _precision Number of decimal places, for decimal values.
+		 */
+		void PublishNumber( ValueID const& _id, int32 const _number, uint8 const _precision = 0 );
+
+		/**
+		 * Store the current state of a value that is held as text.
+		 * \param _id The value that has changed.
+		 * \param _text The new value.  Text too long for a slot is not stored, and
+		 * reads of it fail until shorter text is published.
+		 */
+		void PublishText( ValueID const& _id, string const& _text );
+
+		/**
+		 * Read the last published state of a value.
+		 * \param _id The value to read.
+		 * \param o_number Receives the number, if the value is held as a number.  May be NULL.
+		 * \param o_text Receives the text, if the value is held as text.  May be NULL.
+		 * \param o_precision Receives the number of decimal places of o_number.  If NULL,
+		 * only numbers with no decimal places are read.
+		 * \return False if the value has not been published in the requested form, or
+		 * if writers kept changing it.  The caller should then read the value itself,
+		 * with the node mutex held.
+		 */
+		bool Read( ValueID const& _id, int32* o_number, string* o_text, uint8* o_precision = NULL )const;
+
+		/**
+		 * Count of changes to the set of values or to their published state.  A reader
+		 * that sees the same generation before and after copying the values may assume
+		 * that none of them changed in the meantime.  Publishing a value's state again
+		 * without changing it does not move the generation.
+		 */
+		uint32 GetGeneration()const;
+
+	private:
+		enum
+		{
+			c_textSize	= 48,		// Longest text a slot can hold
+			c_blockSize	= 64		// Slots allocated at a time
+		};
+
+		enum SlotState
+		{
+			SlotState_Empty = 0,	// Nothing published yet
+			SlotState_Number,
+			SlotState_Text
+		};
+
+		struct Slot
+		{
+			volatile uint32	m_sequence;				// Odd while the slot is being written
+			uint64			m_id;					// Value the slot belongs to, or zero if it is free
+			uint8			m_state;				// One of SlotState
+			uint8			m_length;				// Length of m_text
+			uint8			m_precision;			// Decimal places of m_number
+			int32			m_number;
+			char			m_text[c_textSize];
+		};
+
+		struct Entry
+		{
+			uint64	m_id;
+			Slot*	m_slot;							// NULL if the entry is empty
+		};
+
+		struct Table
+		{
+			size_t			m_mask;					// Number of entries less one
+			vector<Entry>	m_entries;
+		};
+
+		Slot* Find( uint64 const _id )const;		// Look up a slot, retrying while the table is being changed
+		Slot* BeginWrite( uint64 const _id );		// Find a slot and lock it, or return NULL if the value has no slot
+		static void LockSlot( Slot* _slot );		// Make the sequence count odd, waiting for any other writer
+		static void UnlockSlot( Slot* _slot );
+		void Changed();								// Move the generation on
+		static size_t Hash( uint64 _id );
+
+		ValueSnapshots( ValueSnapshots const& );					// Not copyable
+		ValueSnapshots& operator = ( ValueSnapshots const& );
+
+		volatile uint32		m_sequence;			// Odd while m_table is being changed
+		volatile uint32		m_generation;		// See GetGeneration
+		Table* volatile		m_table;			// Current table
+		size_t				m_count;			// Entries in use in m_table
+		vector<Table*>		m_tables;			// Every table made, including outgrown ones
+		vector<Slot*>		m_blocks;			// Every block of slots allocated
+		vector<Slot*>		m_freeSlots;		// Slots of removed values, for reuse
+	};
+
+} // namespace OpenZWave
+
+#endif
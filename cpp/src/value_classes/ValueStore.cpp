@@ -29,9 +29,32 @@
 #include "value_classes/Value.h"
 #include "Manager.h"
 #include "Notification.h"
+#include "Utils.h"
+#include <algorithm>
 
 using namespace OpenZWave;
 
+namespace
+{
+	uint16 const c_emptySlot = 0xffff;
+
+	// Orders the entries of a ValueStore against a key
+	struct KeyLess
+	{
+		bool operator()( pair<uint32,Value*> const& _entry, uint32 const _key )const{ return _entry.first < _key; }
+		bool operator()( uint32 const _key, pair<uint32,Value*> const& _entry )const{ return _key < _entry.first; }
+	};
+
+	// Value store keys differ only in a few bit fields, so mix them across the word
+	inline size_t Hash( uint32 _key )
+	{
+		_key ^= _key >> 16;
+		_key *= 0x45d9f3b;
+		_key ^= _key >> 16;
+		return _key;
+	}
+}
+
 
 //-----------------------------------------------------------------------------
 // <ValueStore::ValueStore>
@@ -41,12 +64,63 @@ ValueStore::~ValueStore
 (
 )
 {
-	map<uint32,Value*>::iterator it = m_values.begin();
 	while( !m_values.empty() )
 	{
-		ValueID const& valueId = it->second->GetID();
-		RemoveValue( valueId.GetValueStoreKey() );
-		it = m_values.begin();
+		// Remove from the back, so the rest of the entries need not be moved
+		RemoveValue( m_values.back().first );
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <ValueStore::Find>
+// Find the position of a value in the store
+//-----------------------------------------------------------------------------
+size_t ValueStore::Find
+(
+	uint32 const _key
+)const
+{
+	if( m_index.empty() )
+	{
+		return m_values.size();
+	}
+
+	size_t mask = m_index.size() - 1;
+	for( size_t i = Hash( _key ) & mask; m_index[i] != c_emptySlot; i = (i+1) & mask )
+	{
+		if( m_values[m_index[i]].first == _key )
+		{
+			return m_index[i];
+		}
+	}
+	return m_values.size();
+}
+
+//-----------------------------------------------------------------------------
+// <ValueStore::BuildIndex>
+// Rebuild the table of positions after the values have changed
+//-----------------------------------------------------------------------------
+void ValueStore::BuildIndex
+(
+)
+{
+	// Keep the table no more than half full
+	size_t size = 16;
+	while( size < m_values.size() * 2 )
+	{
+		size *= 2;
+	}
+	m_index.assign( size, c_emptySlot );
+
+	size_t mask = size - 1;
+	for( size_t pos = 0; pos < m_values.size(); ++pos )
+	{
+		size_t i = Hash( m_values[pos].first ) & mask;
+		while( m_index[i] != c_emptySlot )
+		{
+			i = (i+1) & mask;
+		}
+		m_index[i] = (uint16)pos;
 	}
 }
 
@@ -65,19 +139,26 @@ bool ValueStore::AddValue
 	}
 
 	uint32 key = _value->GetID().GetValueStoreKey();
-	map<uint32,Value*>::iterator it = m_values.find( key );
-	if( it != m_values.end() )
+	if( Find( key ) != m_values.size() )
 	{
 		// There is already a value in the store with this key, so we give up.
 		return false;
 	}
 
-	m_values[key] = _value;
+	m_values.insert( lower_bound( m_values.begin(), m_values.end(), key, KeyLess() ), pair<uint32,Value*>( key, _value ) );
+	BuildIndex();
 	_value->AddRef();
 
-	// Notify the watchers of the new value
+	// Index the value for the driver, and notify the watchers of the new value
 	if( Driver* driver = Manager::Get()->GetDriver( _value->GetID().GetHomeId() ) )
 	{
+		{
+			LockGuard LG( driver->m_nodeMutex );
+			driver->m_valueIndex.Insert( _value->GetID(), _value );
+			driver->m_valueSnapshots.Add( _value->GetID() );
+		}
+		_value->PublishSnapshot();
+
 		Notification* notification = new Notification( Notification::Type_ValueAdded );
 		notification->SetValueId( _value->GetID() );
 		driver->QueueNotification( notification );
@@ -95,15 +176,21 @@ bool ValueStore::RemoveValue
 	uint32 const& _key
 )
 {
-	map<uint32,Value*>::iterator it = m_values.find( _key );
-	if( it != m_values.end() )
+	size_t pos = Find( _key );
+	if( pos != m_values.size() )
 	{
-		Value* value = it->second;
+		Value* value = m_values[pos].second;
 		ValueID const& valueId = value->GetID();
 
-		// First notify the watchers
+		// First remove the value from the driver's index, and notify the watchers
 		if( Driver* driver = Manager::Get()->GetDriver( valueId.GetHomeId() ) )
 		{
+			{
+				LockGuard LG( driver->m_nodeMutex );
+				driver->m_valueIndex.Erase( valueId );
+				driver->m_valueSnapshots.Remove( valueId );
+			}
+
 			Notification* notification = new Notification( Notification::Type_ValueRemoved );
 			notification->SetValueId( valueId );
 			driver->QueueNotification( notification ); 
@@ -111,7 +198,8 @@ bool ValueStore::RemoveValue
 
 		// Now release and remove the value from the store
 		value->Release();
-		m_values.erase( it );
+		m_values.erase( m_values.begin() + pos );
+		BuildIndex();
 
 		return true;
 	}
@@ -139,8 +227,9 @@ void ValueStore::RemoveCommandClassValues
 	uint8 const _commandClassId
 )
 {
-	map<uint32,Value*>::iterator it = m_values.begin();
-	while( it != m_values.end() )
+	// Compact the remaining entries in a single pass
+	vector< pair<uint32,Value*> >::iterator dest = m_values.begin();
+	for( vector< pair<uint32,Value*> >::iterator it = m_values.begin(); it != m_values.end(); ++it )
 	{
 		Value* value = it->second;
 		ValueID const& valueId = value->GetID();
@@ -148,23 +237,30 @@ void ValueStore::RemoveCommandClassValues
 		{
 			// The value belongs to the specified command class
 			
-			// First notify the watchers
+			// First remove the value from the driver's index, and notify the watchers
 			if( Driver* driver = Manager::Get()->GetDriver( valueId.GetHomeId() ) )
 			{
+				{
+					LockGuard LG( driver->m_nodeMutex );
+					driver->m_valueIndex.Erase( valueId );
+					driver->m_valueSnapshots.Remove( valueId );
+				}
+
 				Notification* notification = new Notification( Notification::Type_ValueRemoved );
 				notification->SetValueId( valueId );
 				driver->QueueNotification( notification ); 
 			}
 
-			// Now release and remove the value from the store
+			// Now release the value, and leave it out of the store
 			value->Release();
-			m_values.erase( it++ );
 		}
 		else
 		{
-			++it;
+			*dest++ = *it;
 		}
 	}
+	m_values.erase( dest, m_values.end() );
+	BuildIndex();
 }
 
 //-----------------------------------------------------------------------------
@@ -178,10 +274,10 @@ Value* ValueStore::GetValue
 {
 	Value* value = NULL;
 
-	map<uint32,Value*>::const_iterator it = m_values.find( _key );
-	if( it != m_values.end() )
+	size_t pos = Find( _key );
+	if( pos != m_values.size() )
 	{
-		value = it->second;
+		value = m_values[pos].second;
 		if( value )
 		{
 			// Add a reference to the value.  The caller must
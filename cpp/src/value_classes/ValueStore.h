@@ -28,7 +28,8 @@
 #ifndef _ValueStore_H
 #define _ValueStore_H
 
-#include <map>
+#include <vector>
+#include <utility>
 #include "Defs.h"
 #include "value_classes/ValueID.h"
 
@@ -39,12 +40,18 @@ namespace OpenZWave
 	class Value;
 
 	/** \brief Container that holds all of the values associated with a given node.
+	 *
+	 * The values are kept in a vector sorted by their value store key, so they are
+	 * still iterated in key order.  Lookups go through a small open addressing table
+	 * of positions in that vector.  A node's values are created once, while it is
+	 * being interviewed, and then looked up far more often, so the table is simply
+	 * rebuilt whenever a value is added or removed.
 	 */
 	class ValueStore
 	{
 	public:
 		
-		typedef map<uint32,Value*>::const_iterator Iterator;
+		typedef vector< pair<uint32,Value*> >::const_iterator Iterator;
 
 		Iterator Begin(){ return m_values.begin(); }
 		Iterator End(){ return m_values.end(); }
@@ -59,7 +66,11 @@ namespace OpenZWave
 		void RemoveCommandClassValues( uint8 const _commandClassId );		// Remove all the values associated with a command class
 
 	private:
-		map<uint32,Value*>	m_values;
+		size_t Find( uint32 const _key )const;		// Position of the value with this key, or m_values.size() if there is none
+		void BuildIndex();
+
+		vector< pair<uint32,Value*> >	m_values;		// Sorted by key
+		vector<uint16>					m_index;		// Positions in m_values, hashed by key.  Size is zero or a power of two.
 	};
 
 } // namespace OpenZWave
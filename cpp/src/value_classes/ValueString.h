@@ -53,6 +53,7 @@ namespace OpenZWave
 
 		// From Value
 		virtual string const GetAsString() const { return GetValue(); }
+		virtual void PublishSnapshot(){ PublishText( m_value ); }
 		virtual bool SetFromString( string const& _value ) { return Set( _value ); }
 		virtual void ReadXML( uint32 const _homeId, uint8 const _nodeId, uint8 const _commandClassId, TiXmlElement const* _valueElement );
 		virtual void WriteXML( TiXmlElement* _valueElement );
@@ -517,6 +517,9 @@ DISTFILES =	.gitignore \
 	cpp/build/windows/vs2010/OpenZWave.vcxproj \
 	cpp/build/windows/vs2010/OpenZWave.vcxproj.filters \
 	cpp/build/windows/winversion.tmpl \
+	cpp/examples/Benchmarks/Makefile \
+	cpp/examples/Benchmarks/ValueStoreBench.cpp \
+	cpp/examples/Benchmarks/WaitSetBench.cpp \
 	cpp/examples/MinOZW/Main.cpp \
 	cpp/examples/MinOZW/Makefile \
 	cpp/examples/MinOZW/MinOZW.in \
@@ -715,6 +718,10 @@ DISTFILES =	.gitignore \
 	cpp/src/command_classes/WakeUp.h \
 	cpp/src/command_classes/ZWavePlusInfo.cpp \
 	cpp/src/command_classes/ZWavePlusInfo.h \
+	cpp/src/platform/AsyncLogImpl.cpp \
+	cpp/src/platform/AsyncLogImpl.h \
+	cpp/src/platform/CaptureFile.cpp \
+	cpp/src/platform/CaptureFile.h \
 	cpp/src/platform/Controller.cpp \
 	cpp/src/platform/Controller.h \
 	cpp/src/platform/Event.cpp \
@@ -725,11 +732,17 @@ DISTFILES =	.gitignore \
 	cpp/src/platform/HidController.h \
 	cpp/src/platform/Log.cpp \
 	cpp/src/platform/Log.h \
+	cpp/src/platform/LogQueue.cpp \
+	cpp/src/platform/LogQueue.h \
 	cpp/src/platform/Mutex.cpp \
 	cpp/src/platform/Mutex.h \
 	cpp/src/platform/Ref.h \
+	cpp/src/platform/ReplayController.cpp \
+	cpp/src/platform/ReplayController.h \
 	cpp/src/platform/SerialController.cpp \
 	cpp/src/platform/SerialController.h \
+	cpp/src/platform/SimulatedController.cpp \
+	cpp/src/platform/SimulatedController.h \
 	cpp/src/platform/Stream.cpp \
 	cpp/src/platform/Stream.h \
 	cpp/src/platform/Thread.cpp \
@@ -738,6 +751,10 @@ DISTFILES =	.gitignore \
 	cpp/src/platform/TimeStamp.h \
 	cpp/src/platform/Wait.cpp \
 	cpp/src/platform/Wait.h \
+	cpp/src/platform/WaitSet.cpp \
+	cpp/src/platform/WaitSet.h \
+	cpp/src/platform/unix/CaptureFileImpl.cpp \
+	cpp/src/platform/unix/CaptureFileImpl.h \
 	cpp/src/platform/unix/EventImpl.cpp \
 	cpp/src/platform/unix/EventImpl.h \
 	cpp/src/platform/unix/FileOpsImpl.cpp \
@@ -754,6 +771,10 @@ DISTFILES =	.gitignore \
 	cpp/src/platform/unix/TimeStampImpl.h \
 	cpp/src/platform/unix/WaitImpl.cpp \
 	cpp/src/platform/unix/WaitImpl.h \
+	cpp/src/platform/unix/WaitSetImpl.cpp \
+	cpp/src/platform/unix/WaitSetImpl.h \
+	cpp/src/platform/winRT/CaptureFileImpl.cpp \
+	cpp/src/platform/winRT/CaptureFileImpl.h \
 	cpp/src/platform/winRT/EventImpl.cpp \
 	cpp/src/platform/winRT/EventImpl.h \
 	cpp/src/platform/winRT/FileOpsImpl.cpp \
@@ -772,6 +793,10 @@ DISTFILES =	.gitignore \
 	cpp/src/platform/winRT/TimeStampImpl.h \
 	cpp/src/platform/winRT/WaitImpl.cpp \
 	cpp/src/platform/winRT/WaitImpl.h \
+	cpp/src/platform/winRT/WaitSetImpl.cpp \
+	cpp/src/platform/winRT/WaitSetImpl.h \
+	cpp/src/platform/windows/CaptureFileImpl.cpp \
+	cpp/src/platform/windows/CaptureFileImpl.h \
 	cpp/src/platform/windows/EventImpl.cpp \
 	cpp/src/platform/windows/EventImpl.h \
 	cpp/src/platform/windows/FileOpsImpl.cpp \
@@ -788,6 +813,8 @@ DISTFILES =	.gitignore \
 	cpp/src/platform/windows/TimeStampImpl.h \
 	cpp/src/platform/windows/WaitImpl.cpp \
 	cpp/src/platform/windows/WaitImpl.h \
+	cpp/src/platform/windows/WaitSetImpl.cpp \
+	cpp/src/platform/windows/WaitSetImpl.h \
 	cpp/src/value_classes/Value.cpp \
 	cpp/src/value_classes/Value.h \
 	cpp/src/value_classes/ValueBool.cpp \
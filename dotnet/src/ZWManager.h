@@ -93,7 +93,9 @@ namespace OpenZWaveDotNet
 	{
 		Unknown		= Driver::ControllerInterface_Unknown,
 		Serial		= Driver::ControllerInterface_Serial,
-		Hid			= Driver::ControllerInterface_Hid
+		Hid			= Driver::ControllerInterface_Hid,
+		Simulated	= Driver::ControllerInterface_Simulated,
+		Replay		= Driver::ControllerInterface_Replay
 	};
 
 	public enum class ZWControllerCommand